@@ -0,0 +1,95 @@
+#ifndef BATTERY_ESTIMATOR_H
+#define BATTERY_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "movement.h"
+#include "sensor_task.h"
+
+// ============================================================================
+// BATTERY ESTIMATOR - load-compensated state of charge
+// ============================================================================
+// A bare voltage reading drops whenever the motors pull current. This runs on
+// every battery sample (25 Hz from the sensor task) and keeps:
+//   - a current model from PWM duty (idle draw + per-motor draw at full duty)
+//   - the pack's internal resistance, learned from the voltage step that
+//     follows each large duty change: R = -dV / dI
+//   - the open-circuit voltage: V + I * R (sag removed)
+//   - a coulomb-count proxy: modeled current integrated over time
+// SoC fuses the two with a one-state Kalman filter: the coulomb count predicts
+// (its error grows slowly), the OCV -> SoC curve corrects (trusted less while
+// driving). Minutes left = remaining mAh at the ~2 min average current.
+
+class BatteryEstimator {
+public:
+    BatteryEstimator(HAL& halRef, Movement& moveRef, SensorTask& taskRef);
+    
+    void update();
+    
+    bool isReady();                     // Has a battery and an initial SoC
+    bool hasBattery();
+    bool isSaturated();                 // ADC at full scale: voltage unusable
+    
+    float getVoltage();                 // Last reading, as measured
+    float getOpenCircuitVoltage();      // Sag removed, lightly filtered
+    float getCurrent();                 // Modeled now (A)
+    float getAverageCurrent();          // ~2 min average (A)
+    float getInternalResistance();      // Ohms
+    uint32_t getResistanceSamples();    // Duty steps it was learned from
+    float getChargeUsedMah();
+    
+    float getSoc();                     // Percent, 0-100
+    float getSocUncertainty();          // 1-sigma percent
+    int getMinutesLeft();               // -1 until known
+    
+    // Carry SoC across a deep sleep (the sleep drain already subtracted)
+    void restore(float socPercent, float usedMah);
+    
+    void setCapacity(int mAh);
+    int getCapacity();
+    
+    void printReport();
+    
+private:
+    HAL& hal;
+    Movement& movement;
+    SensorTask& sensorTask;
+    
+    int capacityMah = 1000;
+    
+    uint32_t lastConsumed = 0;
+    unsigned long lastUpdateMs = 0;
+    bool battery = false;
+    bool saturated = false;
+    bool ready = false;
+    
+    float voltage = 0;
+    float ocv = 0;
+    float current = 0;
+    float lastCurrent = 0;
+    float avgCurrent = 0;
+    float chargeUsedMah = 0;
+    
+    // SoC filter
+    float soc = 0;
+    float socVariance = 0;
+    
+    // Internal resistance learning
+    float resistance;
+    uint32_t resistanceSamples = 0;
+    float preStepV = 0;         // Voltage while the load was steady
+    bool stepActive = false;
+    unsigned long stepStart = 0;
+    float stepFromI = 0;
+    float stepToI = 0;
+    float stepPreV = 0;
+    float postSum = 0;
+    int postCount = 0;
+    
+    float modelCurrent();
+    void learnResistance(unsigned long now);
+    void fuse(float dt);
+    static float ocvToSoc(float packVolts);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef BEARING_H
+#define BEARING_H
+
+#include "movement.h"
+#include "sensors.h"
+#include "odometry.h"
+
+// ============================================================================
+// LIGHT BEARING ESTIMATOR
+// ============================================================================
+// Spins once through 360°, bins instantaneous brightness against the odometry
+// heading, then fits the peak. The estimate is stored in the odometry (world)
+// frame, so dead reckoning keeps the relative bearing current between scans.
+
+class LightBearing {
+public:
+    LightBearing(Movement& movRef, LDRSensor& ldrRef, Odometry& odoRef);
+    
+    void startScan(int spinSpeed);  // Begin a clockwise scan rotation
+    bool update();                  // Call in loop; returns true on the tick the scan finishes
+    void cancel();
+    
+    bool isScanning();
+    bool hasEstimate();             // Valid, recent and confident estimate available
+    void invalidate();
+    
+    float getBearing();             // World frame, 0-360°
+    float getRelativeBearing();     // Relative to current heading, positive = right
+    float getPeakBrightness();
+    float getConfidence();          // 0-1, peak contrast against the scan mean
+    
+private:
+    Movement& movement;
+    LDRSensor& ldrSensor;
+    Odometry& odometry;
+    
+    static const int NUM_BINS = 24;                 // 15° bins
+    static constexpr float BIN_WIDTH = 360.0f / NUM_BINS;
+    static const unsigned long SCAN_TIMEOUT = 8000; // Give up if the spin stalls
+    static constexpr float MIN_CONFIDENCE = 0.1f;
+    static const unsigned long MAX_AGE = 30000;     // Estimate goes stale after 30s
+    static constexpr float MAX_TRAVEL_CM = 150.0f;  // ...or after driving this far
+    
+    float binSum[NUM_BINS];
+    int binCount[NUM_BINS];
+    
+    bool scanning = false;
+    bool valid = false;
+    float swept = 0.0f;
+    float lastHeading = 0.0f;
+    unsigned long scanStartTime = 0;
+    
+    float bearing = 0.0f;
+    float peakBrightness = 0.0f;
+    float confidence = 0.0f;
+    unsigned long estimateTime = 0;
+    float estimateDistance = 0.0f;
+    
+    void recordSample();
+    bool fitPeak();
+};
+
+#endif
@@ -6,6 +6,15 @@
 #include "sensors.h"
 #include "status.h"
 #include "config.h"
+#include "odometry.h"
+#include "bearing.h"
+#include "stuck_detector.h"
+#include "wander.h"
+#include "transition_log.h"
+
+struct AvoidanceParams {
+    int ldrThreshold = 200;         // L/R brightness difference x4095 worth veering for
+};
 
 class ObstacleAvoidance {
 public:
@@ -17,27 +26,35 @@ public:
         TURNING,
         STUCK_ESCAPE
     };
+    static const char* const STATE_NAMES[];
+    static const int STATE_COUNT = 6;
     
     ObstacleAvoidance(HAL& halRef, Movement& movRef, UltrasonicSensor& sensRef, 
-                      StatusLED& statRef, MotorConfig& cfg);
+                      LDRSensor& ldrRef, StatusLED& statRef, MotorConfig& cfg, StuckDetector& stuckRef,
+                      Wander& wanderRef);
     
     void enable();              // Start autonomous mode
     void disable();             // Stop autonomous mode
     void update();              // Call in loop
     bool isEnabled();
     State getState();
+    AvoidanceParams& getParams();
     
 private:
     HAL& hal;
     Movement& movement;
     UltrasonicSensor& sensor;
+    LDRSensor& ldrSensor;
     StatusLED& status;
     MotorConfig& config;
+    StuckDetector& stuckDetector;
+    Wander& wander;
     
     bool enabled = false;
     State currentState = IDLE;
     unsigned long stateStartTime = 0;
     int turnDirection = 1; // 1 = right, -1 = left
+    AvoidanceParams params;
     
     void setState(State newState);
     void handleExploring();
@@ -50,11 +67,32 @@ private:
 // ============================================================================
 // PHOTOTROPISM BEHAVIOR (Phase 3B)
 // ============================================================================
+struct PhototropismParams {
+    float lightThreshold = 0.7f;    // Average brightness that starts seeking
+    float seekDelta = 0.15f;        // Bang-bang: L/R difference worth turning for
+    float balanceThreshold = 0.05f; // Bang-bang: L/R difference that counts as centred
+    int seekSpeed = 100;            // PWM for scan and steering turns
+    int approachSpeed = 120;        // PWM driving at the light
+};
+
 class Phototropism {
 public:
-    enum State { IDLE, SEEKING, APPROACHING };
+    enum State {
+        IDLE,
+        SCANNING,       // Spin-scan to estimate the light bearing
+        ALIGNING,       // Single turn onto the estimated bearing
+        SEEKING,
+        APPROACHING
+    };
+    static const char* const STATE_NAMES[];
+    static const int STATE_COUNT = 5;
+    enum Controller {
+        BANG_BANG,      // Original spin/stop/drive state machine (kept for A/B trials)
+        PROPORTIONAL    // Continuous PI steering on the normalized brightness difference
+    };
     
-    Phototropism(HAL& halRef, Movement& movRef, StatusLED& statRef, LDRSensor& ldrRef);
+    Phototropism(HAL& halRef, Movement& movRef, StatusLED& statRef, LDRSensor& ldrRef,
+                 Odometry& odoRef, LightBearing& bearingRef);
     
     void enable();
     void disable();
@@ -62,22 +100,128 @@ public:
     void update();
     State getState();
     
+    void setController(Controller c);
+    Controller getController();
+    float getLightThreshold();
+    PhototropismParams& getParams();
+    
 private:
     HAL& hal;
     Movement& movement;
     StatusLED& status;
     LDRSensor& ldrSensor;
+    Odometry& odometry;
+    LightBearing& lightBearing;
     
     State currentState = IDLE;
     unsigned long stateStartTime = 0;
     bool enabled = false;
+    Controller controller = PROPORTIONAL;
+    
+    PhototropismParams params;
+    
+    // PI steering (error = normalized difference (L-R)/(L+R), range -1..1)
+    const float STEER_KP = 1.6f;
+    const float STEER_KI = 0.8f;            // per second
+    const float STEER_I_LIMIT = 0.5f;       // Anti-windup clamp on the integral term
+    const float PIVOT_ERROR = 0.5f;         // Forward speed reaches zero at this error
+    const float SEEK_ERROR = 0.2f;          // Above this we report SEEKING, below APPROACHING
+    const float ARRIVAL_THRESHOLD = 0.95f;  // Average brightness that counts as "at the light"
+    const float ALIGN_TOLERANCE = 10.0f;    // Degrees; close enough to hand over to PI steering
+    const unsigned long ALIGN_TIMEOUT = 3000;
     
-    const float LIGHT_THRESHOLD = 0.7f;
-    const float SEEK_DELTA = 0.15f;
-    const float BALANCE_THRESHOLD = 0.05f;
+    float steerIntegral = 0.0f;
+    unsigned long lastSteerTime = 0;
+    
+    // Trial metrics (time-to-light and path length), identical for both controllers
+    unsigned long trialStartTime = 0;
+    float trialStartDistance = 0.0f;
+    bool trialActive = false;
+    
+    void setState(State newState);
+    void updateBangBang(float leftBright, float rightBright, float avgBright, float difference);
+    void updateProportional(float leftBright, float rightBright, float avgBright);
+    void acquireBearing();
+    void updateAligning();
+    float gainSchedule(float avgBright);
+    void resetSteering();
+    void startTrial();
+    void updateTrial(float avgBright);
+};
+
+// ============================================================================
+// LIGHT NAVIGATOR - light seeking with obstacle circumnavigation (Bug-style)
+// ============================================================================
+// Keeps the light bearing as the goal while following an obstacle boundary,
+// and leaves the boundary as soon as the goal direction is clear again. With a
+// single forward-facing ultrasonic the boundary is followed in scallops: turn
+// away until clear, then arc back toward the wall until it shows up again.
+class LightNavigator {
+public:
+    enum State {
+        IDLE,
+        ACQUIRING,          // Spin-scan for the light bearing
+        SEARCHING,          // No usable bearing - wander a while, then rescan
+        MOTION_TO_GOAL,     // Steer along the bearing
+        BOUNDARY_TURN,      // Turning away from an obstacle
+        BOUNDARY_ARC,       // Arcing back toward the obstacle side
+        ARRIVED
+    };
+    static const char* const STATE_NAMES[];
+    static const int STATE_COUNT = 7;
     
-    const int seekSpeed = 100;
-    const int approachSpeed = 120;
+    LightNavigator(Movement& movRef, UltrasonicSensor& sensRef, LDRSensor& ldrRef,
+                   StatusLED& statRef, Odometry& odoRef, LightBearing& bearingRef,
+                   MotorConfig& cfg, Wander& wanderRef);
+    
+    void enable();
+    void disable();
+    bool isEnabled();
+    void update();
+    State getState();
+    
+private:
+    Movement& movement;
+    UltrasonicSensor& sensor;
+    LDRSensor& ldrSensor;
+    StatusLED& status;
+    Odometry& odometry;
+    LightBearing& lightBearing;
+    MotorConfig& config;
+    Wander& wander;
+    
+    bool enabled = false;
+    State currentState = IDLE;
+    unsigned long stateStartTime = 0;
+    
+    int followSide = 1;              // Side the wall is on: 1 = right, -1 = left
+    unsigned long boundaryStartTime = 0;
+    float boundaryStartDistance = 0.0f;
+    
+    // Run metrics
+    unsigned long runStartTime = 0;
+    float runStartDistance = 0.0f;
+    int obstacleEncounters = 0;
+    
+    const float ARRIVAL_THRESHOLD = 0.95f;      // Average brightness that counts as "at the light"
+    const float LDR_ASSIST_THRESHOLD = 0.56f;   // Above this the LDR pair refines the bearing
+    const int CLEAR_MARGIN = 15;                // cm beyond warnDistance to count as clear
+    const float ARC_CURVATURE = 0.45f;          // Angular/linear ratio while arcing to the wall
+    const float LEAVE_BEARING = 30.0f;          // Goal within ±30° ahead and clear = leave boundary
+    const unsigned long MIN_FOLLOW_TIME = 1500; // Don't leave the boundary before this
+    const unsigned long MAX_FOLLOW_TIME = 20000;// Give up on this boundary and rescan
+    const unsigned long SEARCH_TIME = 3000;     // Wander this long between inconclusive scans
+    
+    void setState(State newState);
+    void startBoundary();
+    void handleAcquiring();
+    void handleSearching();
+    void handleMotionToGoal();
+    void handleBoundaryTurn();
+    void handleBoundaryArc();
+    void handleArrived();
+    bool checkArrival();
+    float goalError();
 };
 
 #endif
\ No newline at end of file
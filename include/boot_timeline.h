@@ -0,0 +1,41 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// BOOT TIMELINE - microsecond timestamp at the end of each setup() stage
+// ============================================================================
+// Times come from esp_timer_get_time(), which starts counting during the
+// second-stage bootloader hand-off: the ROM and bootloader time before the
+// app (image load and check) is not included. The first mark is taken at
+// the top of setup(), so it shows what the runtime and global constructors
+// cost. "ready" is the point where the motors are driven by loop() and
+// every sensor is live; banners and other cosmetic output come after it.
+
+class BootTimeline {
+public:
+    static const int MAX_STAGES = 24;
+    static const uint32_t TARGET_US = 150000;
+
+    // Stage names must be string literals (the pointer is stored)
+    void mark(const char* stage);
+    void markReady();
+
+    uint32_t getReadyUs() { return readyUs; }
+    void printReport();
+
+private:
+    struct Stage {
+        const char* name;
+        uint32_t us;
+    };
+
+    Stage stages[MAX_STAGES];
+    int count = 0;
+    uint32_t readyUs = 0;
+};
+
+extern BootTimeline bootTimeline;
+
+#endif
@@ -1,8 +1,77 @@
 #ifndef CLI_H
 #define CLI_H
 
-#include "hal.h"
+#include <Arduino.h>
 
-void processSerialCommands(HAL& hal);
+// ============================================================================
+// COMMAND LINE - zero-allocation, non-blocking console parser
+// ============================================================================
+// Bytes are fed in one at a time (from ProtocolLink::poll()) and collected in
+// a fixed buffer. A newline tokenizes the buffer in place and dispatches
+// through a command table; arguments are parsed against the command's type
+// spec before its handler runs, so handlers only ever see valid values.
+//
+// Arg spec: one character per argument, '|' starts the optional ones.
+//   i  integer         c  single character (upper-cased)
+//   b  on/off/1/0      w  word (pointer into the line buffer)
+//
+// A space on an empty line is handled immediately, without waiting for the
+// newline, so the spacebar stays an emergency stop.
+
+class CommandLine {
+public:
+    static const size_t LINE_SIZE = 128;     // Fits a parameter batch
+    static const uint8_t MAX_ARGS = 4;
+
+    struct Args {
+        uint8_t count;
+        union {
+            long i;
+            char c;
+            bool b;
+            const char* w;
+        } v[MAX_ARGS];
+
+        bool has(uint8_t index) const { return index < count; }
+    };
+
+    typedef void (*Handler)(const Args& args);
+
+    struct Command {
+        const char* name;
+        const char* alias;      // Short form (the original one-key command); may be nullptr
+        const char* spec;
+        const char* usage;      // Argument names for help, e.g. "<A|B> <F|R> <0-255>"
+        Handler handler;
+        const char* group;      // Help section
+        const char* help;
+    };
+
+    void begin(const Command* table, size_t count, Handler emergencyStop);
+
+    // Feed one byte; returns true when a command was dispatched
+    bool feed(char c);
+
+    void printHelp();
+    void printUsage(const Command& cmd);
+
+    uint32_t getOverflows() { return overflows; }
+
+private:
+    const Command* commands = nullptr;
+    size_t commandCount = 0;
+    Handler onSpace = nullptr;
+
+    char line[LINE_SIZE];
+    size_t length = 0;
+    bool discarding = false;
+    uint32_t overflows = 0;
+
+    void dispatch();
+    const Command* find(const char* name);
+    bool parseArg(char type, const char* token, Args& args);
+};
+
+extern CommandLine commandLine;
 
 #endif // CLI_H
@@ -6,7 +6,8 @@ struct MotorConfig {
     int baseSpeed = 150;
     int crawlSpeed = 100;
     int maxSpeed = 255;
-    int turnDuration = 800;
+    int turnDuration = 800;     // ms for a ~90° spin at baseSpeed (also calibrates odometry)
+    int cruiseSpeedCmS = 25;    // Measured ground speed at baseSpeed (cm/s) for dead reckoning
     bool motorA_inverted = false;
     bool motorB_inverted = false;
     int motorA_trim = 0;
@@ -26,16 +27,20 @@ namespace StatusColors {
     const uint32_t OTA       = 0xFFFFFF; // White (blink)
 }
 
-// LDR Sensor Calibration Values
-namespace ADC {
-    // The normalized ADC reading in darkness/light. Calibrated automatically.
-    constexpr float DARK_READING_LEFT   = 0.000f;
-    constexpr float LIGHT_READING_LEFT  = 1.000f;
-    constexpr float DARK_READING_RIGHT  = 0.000f;
-    constexpr float LIGHT_READING_RIGHT = 1.000f;
-}
+// ADC Calibration Values (runtime parameters, see params.h)
+struct AdcCalibration {
+    // The normalized LDR reading in darkness/light
+    float darkLeft = 0.000f;
+    float lightLeft = 1.000f;
+    float darkRight = 0.000f;
+    float lightRight = 1.000f;
+    // Battery divider: measured pack volts / raw ADC count. Default is the
+    // documented 20k/10k divider, 3 x 3.3V / 4095 (9.9V full scale)
+    float batteryVoltsPerCount = 0.00242f;
+};
 
-// Global instance
+// Global instances
 extern MotorConfig motorConfig;
+extern AdcCalibration adcCalibration;
 
 #endif // CONFIG_H
\ No newline at end of file
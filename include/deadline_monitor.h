@@ -0,0 +1,98 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/semphr.h>
+#include "hal.h"
+
+// ============================================================================
+// DEADLINE MONITOR - overrun watchdog for periodic activities
+// ============================================================================
+// Each periodic activity (the control loop, the sensor capture, ...) declares
+// its period and deadline, then brackets every activation with start()/finish().
+// A high-priority esp_timer checks every few ms, independently of the code
+// being watched, for:
+//   - an activation running past its deadline (e.g. a delay() chain), or
+//   - an activity not started within period + deadline (starved)
+// Each overrun records the culprit, the section it was in and how long it
+// overran. Reactions: log only, stop the motors, or let the task watchdog
+// reset the chip (TWDT granularity is whole seconds). Stopping sets the HAL
+// motor limit to 0 until the overrunning activation finishes, so commands
+// the late code still issues cannot restart the motors.
+
+class DeadlineMonitor {
+public:
+    enum Reaction { LOG_ONLY, STOP_MOTORS, WATCHDOG_RESET };
+    
+    static const int MAX_ACTIVITIES = 4;
+    static const int MAX_OVERRUNS = 16;
+    
+    struct Overrun {
+        uint32_t timeMs;
+        uint8_t activity;
+        bool starved;           // Not started in time (vs. ran too long)
+        const char* section;    // Section the activity was in when caught
+        uint32_t overrunUs;     // Beyond the deadline; final once the activation ends
+    };
+    
+    // Returns the activity id, or -1 if full. Call before begin().
+    int registerActivity(const char* name, uint32_t periodMs, uint32_t deadlineMs,
+                         Reaction reaction = LOG_ONLY);
+    bool begin(HAL& halRef, uint32_t checkPeriodMs = 5);
+    
+    void start(int id);
+    void finish(int id);
+    void section(int id, const char* name);    // Mark progress inside an activation
+    
+    void setPeriod(int id, uint32_t periodMs);
+    void setReaction(int id, Reaction reaction);
+    Reaction getReaction(int id);
+    uint32_t getOverrunCount();
+    
+    void printReport();
+    
+private:
+    struct Activity {
+        const char* name;
+        uint32_t periodUs;
+        uint32_t deadlineUs;
+        Reaction reaction;
+        TaskHandle_t task;              // For the watchdog reaction
+        volatile uint32_t startUs;
+        volatile uint32_t endUs;
+        volatile bool running;
+        volatile bool flagged;          // Already reported this activation
+        volatile const char* section;
+        volatile int overrunSlot;       // Record to finalize on finish()
+        volatile bool holdingMotors;    // Latched the motor limit; released on finish()
+        uint32_t activations;
+        uint32_t worstUs;
+    };
+    
+    HAL* hal = nullptr;
+    esp_timer_handle_t timer = nullptr;
+    Activity activities[MAX_ACTIVITIES];
+    int activityCount = 0;
+    
+    Overrun overruns[MAX_OVERRUNS];
+    volatile uint32_t overrunTotal = 0;
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    int heldMotorLimit = 100;           // Limit to restore when the last hold ends
+    int motorHolds = 0;                 // Under lock
+    bool motorsHeld = false;            // Limit actually at 0; under holdMutex
+    StaticSemaphore_t holdMutexStorage;
+    SemaphoreHandle_t holdMutex = nullptr;
+    
+    static void timerCallback(void* arg);
+    void check();
+    void react(Activity& a);
+    void releaseMotors(Activity& a);
+    void applyMotorHold();
+    int logOverrun(int id, bool starved, uint32_t overrunUs);
+    static const char* reactionName(Reaction r);
+};
+
+extern DeadlineMonitor deadlineMonitor;
+
+#endif
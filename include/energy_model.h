@@ -0,0 +1,82 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <Arduino.h>
+#include "sensors.h"
+#include "movement.h"
+#include "genome.h"
+
+// ============================================================================
+// ENERGY MODEL - simulated metabolism for fitness scoring
+// ============================================================================
+// A virtual energy store, independent of the real battery. Every 100 ms tick:
+//
+//   + light     brightness x efficiency gene
+//   - basal     fixed upkeep x efficiency gene (better converters cost more)
+//   - motors    proportional to |PWM A| + |PWM B|
+//   - sonar     per ultrasonic ping
+//   - CPU       proportional to the clock frequency
+//
+// Inputs are sampled once per tick and converted to integers (brightness and
+// efficiency in permille); the integration itself is integer-only with a
+// fixed step, so the same inputs always give the same energy. If loop() is
+// late the missed ticks are run on the next call. Energy reaching zero is
+// death: the alive clock stops and update() reports it once. reset() revives
+// at full energy with the genome unchanged.
+
+class EnergyModel {
+public:
+    static const uint32_t TICK_MS = 100;
+    static const int32_t FULL = 1000000;        // Energy units: 1/10000 of a percent
+
+    // What a deep sleep carries in RTC memory
+    struct Snapshot {
+        int32_t energy;
+        uint32_t aliveTicks;
+        uint32_t deaths;
+        bool alive;
+    };
+
+    EnergyModel(LDRSensor& ldrRef, Movement& moveRef, UltrasonicSensor& sonarRef,
+                GenomeManager& genomeRef);
+
+    // Call every loop pass; true on the tick the bot dies
+    bool update();
+    void reset();
+
+    bool isAlive() { return alive; }
+    int32_t getEnergy() { return energy; }
+    int getEnergyTenths() { return energy / 1000; }    // 0-1000 = 0.0-100.0%
+    uint32_t getAliveSeconds() { return aliveTicks * TICK_MS / 1000; }
+
+    // Hibernate: the time asleep is charged at the basal rate
+    Snapshot snapshot();
+    void restore(const Snapshot& s, uint32_t sleptMs);
+
+    void printReport();
+
+private:
+    LDRSensor& ldr;
+    Movement& movement;
+    UltrasonicSensor& sonar;
+    GenomeManager& genetics;
+
+    int32_t energy = FULL;
+    bool alive = true;
+    uint32_t aliveTicks = 0;
+    uint32_t deaths = 0;
+
+    unsigned long nextTickMs = 0;
+    uint32_t lastPings = 0;
+
+    // Totals since reset, energy units
+    uint32_t gained = 0;
+    uint32_t spentBasal = 0;
+    uint32_t spentMotors = 0;
+    uint32_t spentSonar = 0;
+    uint32_t spentCpu = 0;
+
+    bool step(int32_t brightness, int32_t efficiency, int32_t duty, int32_t pings, int32_t cpuMhz);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_pm.h>
+
+// ============================================================================
+// EVENT LOOP - block loop() until there is work, and scale the clock
+// ============================================================================
+// loop() used to end in delay(5) and poll Serial, so core 1 woke 200 times a
+// second at 240 MHz even when parked. Now it blocks on a task notification
+// posted by:
+//   - the sensor task, when a new sample is queued
+//   - a periodic esp_timer (LED animation, timeouts)
+//   - the UART RX callback
+//   - the BOOT button
+//
+// The clock follows demand: HIGH while the motors run, MID while a behavior is
+// enabled or the console is in use, LOW when parked. With CONFIG_PM_ENABLE
+// the levels map to esp_pm locks (LOW allows automatic light sleep; motors and
+// pings hold locks that prevent it). The stock Arduino core is built without
+// power management, so the fallback switches 240/160/80 MHz directly and
+// never changes the clock in the middle of a ping.
+
+class EventLoop {
+public:
+    enum Event : uint32_t {
+        EVENT_SENSOR = 1 << 0,
+        EVENT_TIMER  = 1 << 1,
+        EVENT_UART   = 1 << 2,
+        EVENT_BUTTON = 1 << 3,
+    };
+    static const int EVENT_COUNT = 4;
+    
+    enum Level { LOW_POWER, MID_POWER, HIGH_POWER };
+    static const int LEVEL_COUNT = 3;
+    
+    bool begin(uint32_t tickMs = 50, int buttonPin = -1);
+    
+    // Wake loop(); safe from any task / ISR respectively
+    void post(uint32_t events);
+    void IRAM_ATTR postFromISR(uint32_t events);
+    
+    // Block until an event or maxWaitMs; returns the event bits
+    uint32_t wait(uint32_t maxWaitMs = 100);
+    
+    // Called from loop() each pass with what the robot is doing now
+    void setDemand(Level level);
+    Level getLevel();
+    void setMaxLevel(Level level);      // Cap from the power manager
+    
+    // Power saving off = fixed 240 MHz (for profiling and load measurement)
+    void setPowerSaving(bool on);
+    bool isPowerSaving();
+    bool hasPowerManagement();
+    
+    // Bracket each ultrasonic ping (sensor task): no sleep, no clock change
+    void pingBegin();
+    void pingEnd();
+    
+    void printReport();
+    
+private:
+    TaskHandle_t loopTask = nullptr;
+    esp_timer_handle_t timer = nullptr;
+    
+    bool pmSupported = false;
+    bool powerSaving = true;
+    esp_pm_lock_handle_t cpuLock = nullptr;       // HIGH: CPU at max
+    esp_pm_lock_handle_t apbLock = nullptr;       // MID: APB at max, no sleep
+    esp_pm_lock_handle_t pingLock = nullptr;      // Ping in flight: no sleep
+    
+    volatile Level level = HIGH_POWER;
+    Level maxLevel = HIGH_POWER;
+    volatile int pingsActive = 0;
+    volatile bool switching = false;
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    
+    // Residency: time loop() spent awake vs blocked, per level
+    uint64_t awakeUs[LEVEL_COUNT] = { 0, 0, 0 };
+    uint64_t waitUs[LEVEL_COUNT] = { 0, 0, 0 };
+    uint32_t lastWakeUs = 0;
+    uint32_t events[EVENT_COUNT] = { 0, 0, 0, 0 };
+    uint32_t wakeups = 0;
+    uint32_t timeouts = 0;
+    uint32_t deferredSwitches = 0;
+    
+    static void timerCallback(void* arg);
+    static void IRAM_ATTR buttonISR();
+    void applyLevel(Level target);
+    static uint32_t levelMHz(Level l);
+    float estimateMa(Level l, float waitFraction);
+};
+
+extern EventLoop eventLoop;
+
+#endif
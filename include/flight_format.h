@@ -0,0 +1,132 @@
+#ifndef FLIGHT_FORMAT_H
+#define FLIGHT_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "protocol.h"
+
+// ============================================================================
+// FLIGHT RECORDER PAGE FORMAT - shared by the firmware and host checks
+// ============================================================================
+// Page (one flash sector):
+//   header  magic "EMF1" | seq u32 | startMs u32 | periodMs u16 | count u16 |
+//           used u16 | crc16 u16          (little-endian, 20 bytes)
+//   records `used` bytes, CRC-16 (protocol.h) over them
+//
+// Record: varint bitmask of the fields that changed, then for each set bit
+// in field order a zigzag varint of the change. Bit 0 (time) is set only when
+// the gap differs from periodMs and carries the gap itself. The first record
+// of every page has all bits set and deltas from zero, so each page decodes
+// on its own. Deltas wrap modulo 2^32, so a decoder keeps values as int32.
+//
+// tools/flight_decode.py is the decoder; tools/ember_link/flight_page_test.cpp
+// checks it against this encoder. Like protocol.h, this header has no
+// Arduino dependency.
+
+namespace FlightFormat {
+
+    const size_t PAGE_SIZE = 4096;      // Flash sector: the erase unit
+    const size_t HEADER_SIZE = 20;
+    const uint32_t PAGE_MAGIC = 0x31464D45;     // "EMF1"
+
+    struct PageHeader {
+        uint32_t magic;
+        uint32_t seq;
+        uint32_t startMs;
+        uint16_t periodMs;
+        uint16_t count;
+        uint16_t used;
+        uint16_t crc;
+    };
+    static_assert(sizeof(PageHeader) == HEADER_SIZE, "page header layout");
+
+    inline bool headerValid(const PageHeader& h) {
+        return h.magic == PAGE_MAGIC && h.used <= PAGE_SIZE - HEADER_SIZE;
+    }
+
+    // Fills one page buffer record by record. Field 0 is time; the others are
+    // delta-encoded against the previous record.
+    template <int N>
+    class PageEncoder {
+    public:
+        // Mask varint plus a 5-byte varint per field
+        static const size_t MAX_RECORD = (N + 6) / 7 + 5 * N;
+
+        void start(uint8_t* buffer, uint32_t startMs, uint16_t periodMs) {
+            page = buffer;
+            used = HEADER_SIZE;
+            count = 0;
+            pageStartMs = startMs;
+            pagePeriodMs = periodMs;
+            lastMs = startMs;
+            memset(previous, 0, sizeof(previous));
+        }
+
+        bool empty() const { return count == 0; }
+        bool full() const { return used + MAX_RECORD > PAGE_SIZE; }
+        uint16_t getCount() const { return count; }
+        uint16_t getPeriod() const { return pagePeriodMs; }
+        size_t getUsed() const { return count ? used : 0; }
+
+        // Appends the record for timeMs; values[0] is set to the gap since
+        // the previous record. Returns the bytes it took.
+        size_t add(int32_t* values, uint32_t timeMs) {
+            bool keyframe = count == 0;
+            uint32_t gap = timeMs - lastMs;
+            lastMs = timeMs;
+            values[0] = gap;
+
+            uint32_t mask = 0;
+            if (keyframe || gap != pagePeriodMs) mask |= 1u << 0;
+            for (int i = 1; i < N; i++) {
+                if (keyframe || values[i] != previous[i]) mask |= 1u << i;
+            }
+
+            size_t start = used;
+            put(mask);
+            if (mask & 1u) put(gap);
+            for (int i = 1; i < N; i++) {
+                if (!(mask & (1u << i))) continue;
+                int32_t delta = (int32_t)((uint32_t)values[i] - (uint32_t)previous[i]);
+                put(((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));     // Zigzag
+                previous[i] = values[i];
+            }
+            count++;
+            return used - start;
+        }
+
+        // Writes the header and CRC; the page is complete in the buffer
+        void seal(uint32_t seq) {
+            PageHeader h;
+            h.magic = PAGE_MAGIC;
+            h.seq = seq;
+            h.startMs = pageStartMs;
+            h.periodMs = pagePeriodMs;
+            h.count = count;
+            h.used = used - HEADER_SIZE;
+            h.crc = Protocol::crc16(page + HEADER_SIZE, h.used);
+            memcpy(page, &h, sizeof(h));
+            count = 0;
+        }
+
+    private:
+        uint8_t* page = nullptr;
+        size_t used = 0;
+        uint16_t count = 0;
+        uint32_t pageStartMs = 0;
+        uint16_t pagePeriodMs = 0;
+        uint32_t lastMs = 0;
+        int32_t previous[N];
+
+        void put(uint32_t v) {
+            while (v >= 0x80) {
+                page[used++] = (v & 0x7F) | 0x80;
+                v >>= 7;
+            }
+            page[used++] = v;
+        }
+    };
+}
+
+#endif
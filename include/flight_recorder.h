@@ -0,0 +1,128 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "flight_format.h"
+
+// ============================================================================
+// FLIGHT RECORDER - circular sensor/motor/behavior log in its own flash partition
+// ============================================================================
+// loop() hands in a Sample at the recording rate. Samples are delta-encoded
+// into a 4 KB RAM page; a full page is handed to a low-priority task on core
+// 0 that erases the next sector of the "flightrec" partition and writes the
+// page in one go, wrapping around to overwrite the oldest. Flash therefore
+// sees one erase + one 4 KB write per page (about every 80 s at 10 Hz).
+// The control loop never calls into flash itself, but a sector erase turns
+// the flash cache off on both cores: loop() on core 1 stalls for the erase
+// (typically 30-50 ms) once per page. Each erase is timed against the loop's
+// 100 ms deadline; a longer one is logged and counted ("rec").
+// Timestamps are the scheduled sample times, so a steady rate costs no time
+// bytes.
+//
+// Page and record layout: flight_format.h. With only the changing fields
+// stored a record is ~4-6 bytes: the 448 KB partition holds about 2.5 hours
+// at 10 Hz.
+//
+// "recdump" prints every valid page, oldest first, as hex lines
+// ("FR <seq> <hex>"); tools/flight_decode.py turns that into CSV.
+
+class FlightRecorder {
+public:
+    static const size_t PAGE_SIZE = FlightFormat::PAGE_SIZE;
+    static const size_t HEADER_SIZE = FlightFormat::HEADER_SIZE;
+    static const int MAX_RATE_HZ = 25;          // One sample per sensor period
+    static const uint32_t LOOP_DEADLINE_MS = 100;   // loop()'s deadline (main.cpp)
+
+    enum Field {
+        F_TIME,
+        F_DISTANCE,         // Filtered ultrasonic, cm
+        F_LIGHT_LEFT,       // Brightness, permille
+        F_LIGHT_RIGHT,
+        F_WHEEL_A,          // Signed effective PWM
+        F_WHEEL_B,
+        F_ENERGY,           // Energy model, tenths of a percent
+        F_BEHAVIOR,         // packBehavior()
+        F_BATTERY,          // Centivolts
+        F_POWER,            // PowerManager::Mode
+        FIELD_COUNT
+    };
+
+    struct Sample {
+        int32_t values[FIELD_COUNT];    // Indexed by Field; F_TIME is filled in by record()
+    };
+
+    // Packed behavior: enabled modes in bits 0-2 (avoidance, phototropism,
+    // navigator), then 4 bits each of avoidance, phototropism, navigator state
+    static int32_t packBehavior(uint8_t enabledMask, uint8_t avoid, uint8_t photo, uint8_t nav) {
+        return enabledMask | avoid << 4 | photo << 8 | nav << 12;
+    }
+
+    struct Params {
+        int rateHz = 10;            // 0 = off
+    };
+
+    // Finds the partition, resumes after the newest page and starts the writer
+    bool begin(uint8_t core = 0);
+    bool isReady() { return partition != nullptr; }
+    TaskHandle_t getHandle() { return handle; }
+    Params& getParams() { return params; }
+
+    bool due();                     // True once per period while recording
+    uint32_t msUntilDue();          // For the loop's wait; UINT32_MAX when off
+    void record(Sample& s);
+
+    // Hand the partial page to the writer and wait (up to maxMs), e.g. before deep sleep
+    void flush(uint32_t maxMs = 300);
+
+    // Run by the writer task; recording continues meanwhile
+    void requestDump();
+    void requestErase();
+
+    void printStatus();
+
+private:
+    const esp_partition_t* partition = nullptr;
+    uint32_t sectorCount = 0;
+    TaskHandle_t handle = nullptr;
+    Params params;
+
+    // Loop side: the page being filled
+    uint8_t pages[2][PAGE_SIZE];
+    uint8_t active = 0;
+    FlightFormat::PageEncoder<FIELD_COUNT> encoder;
+    uint32_t nextSeq = 0;
+    unsigned long nextDueMs = 0;
+    unsigned long dueMs = 0;        // Scheduled time of the sample being recorded
+
+    // Handed to the writer: index of a sealed page, or -1
+    volatile int8_t sealed = -1;
+    volatile bool dumpRequested = false;
+    volatile bool eraseRequested = false;
+
+    // Writer side
+    uint32_t nextSector = 0;
+    uint32_t validPages = 0;
+
+    // Counters
+    uint32_t recorded = 0;
+    uint32_t encodedBytes = 0;
+    uint32_t pagesWritten = 0;
+    uint32_t pagesDropped = 0;      // Sealed while the writer was still busy
+    uint32_t flashErrors = 0;
+    uint32_t lastWriteMs = 0;       // Erase + write time of the last page
+    uint32_t worstEraseMs = 0;      // Longest erase: how long core 1 stalled
+    uint32_t longErases = 0;        // Erases past LOOP_DEADLINE_MS
+
+    void seal();
+    void scan();
+    void writePage(const uint8_t* page);
+    void dump();
+    void eraseAll();
+
+    static void taskEntry(void* param);
+};
+
+extern FlightRecorder flightRecorder;
+
+#endif
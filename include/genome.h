@@ -0,0 +1,91 @@
+#ifndef GENOME_H
+#define GENOME_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "behaviors.h"
+
+// ============================================================================
+// GENOME - heritable behavior parameters
+// ============================================================================
+// Each gene is a 16-bit fixed-point fraction of its range (0 = min,
+// 65535 = max), so every bit pattern is a valid bot and mutation/crossover
+// never need range checks. The whole genome is 16 bytes and travels as a
+// 32-character hex string ("genome" prints it, "breed <hex>" takes a mate).
+//
+// Genes are decoded once, when a genome is applied: apply() writes the real
+// values into PhototropismParams / MotorConfig, which the behaviors already
+// read every tick. A new genome therefore takes effect on the next tick with
+// no lookup cost in between. The genome is the only owner of those fields:
+// none of them is a runtime parameter (params.h).
+
+struct Genome {
+    enum Gene : uint8_t {
+        LIGHT_THRESHOLD,    // Brightness that counts as "light" (phototropism)
+        EFFICIENCY,         // Light-to-energy conversion factor
+        SEEK_DELTA,         // Bang-bang L/R difference worth turning for
+        SEEK_SPEED,         // PWM for scan and steering turns
+        APPROACH_SPEED,     // PWM driving at the light
+        BASE_SPEED,         // Cruise PWM for every other behavior
+        GENE_COUNT
+    };
+
+    struct GeneSpec {
+        const char* name;
+        float min;
+        float max;
+    };
+    static const GeneSpec SPECS[GENE_COUNT];
+
+    uint16_t genes[GENE_COUNT];
+    uint16_t generation;
+    uint8_t botId;
+    uint8_t reserved;
+
+    float get(Gene g) const;
+    void set(Gene g, float value);      // Clamped to the gene's range
+
+    void randomize();
+    // Each gene mutates with probability `rate`, by up to ±step of its range
+    void mutate(float rate, float step);
+    // Uniform crossover; generation becomes the older parent's + 1
+    static Genome crossover(const Genome& a, const Genome& b);
+
+    static const size_t HEX_LENGTH = 2 * (2 * GENE_COUNT + 4);
+    void toHex(char* out) const;        // out: HEX_LENGTH + 1 bytes
+    bool fromHex(const char* hex);
+};
+
+class GenomeManager {
+public:
+    static const uint8_t SCHEMA_VERSION = 1;
+    static constexpr float DEFAULT_MUTATION_RATE = 0.5f;
+    static constexpr float DEFAULT_MUTATION_STEP = 0.1f;
+
+    GenomeManager(Phototropism& photoRef, MotorConfig& cfgRef);
+
+    // Load from NVS, or seed from the compiled-in defaults and save on
+    // first boot; then apply
+    void begin();
+
+    // Hot swap: apply now and persist
+    void swap(const Genome& g);
+    const Genome& current() { return genome; }
+    float getEfficiency() { return efficiency; }
+
+    void print();
+
+private:
+    Phototropism& phototropism;
+    MotorConfig& config;
+
+    Genome genome;
+    float efficiency = 1.0f;    // Decoded for the energy model
+    bool firstBoot = false;     // Seeded from defaults at this boot, never swapped since
+
+    void apply();
+    bool save();
+    bool load();
+};
+
+#endif
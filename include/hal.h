@@ -5,11 +5,14 @@
 class HAL {
 public:
     HAL();
-    bool init();
+    bool init();                        // Motors stopped first thing; no delays
+    void prepareForSleep();             // Latch the motor driver off through deep sleep
     
     // LED Control
     void setLED(bool state);
     void setRGB(uint8_t r, uint8_t g, uint8_t b);
+    void setLedBrightness(int percent);     // Scales every setRGB() (power modes)
+    int getLedBrightness();
     
     // Motor Control
     void setMotorA(int speed, bool forward);
@@ -17,12 +20,18 @@ public:
     void stopMotors();
     void brakeMotors();      // Active brake (short circuit)
     void coastMotors();      // Coast to stop
+    uint32_t getMotorCause(int motor);  // Sample seq behind the last command (0 = A, 1 = B)
+    void setMotorLimit(int percent);    // Scales every motor command (power modes)
+    int getMotorLimit();
     
     // Ultrasonic Sensor
-    int readUltrasonic();    // Returns distance in cm (0-400)
+    int readUltrasonic();    // Returns distance in cm (0-400), median of 5 pings (~100ms+)
+    int pingUltrasonic();    // Single ping, distance in cm (2-400), max 30ms
     
     // Battery Monitoring
     float readBatteryVoltage(); // Returns voltage
+    int readBatteryRaw();       // Raw ADC value (0-4095)
+    static float batteryRawToVoltage(int adcValue);
     
     // LDR Sensors
     int readLDR_Left();      // Returns ADC value (0-4095)
@@ -45,4 +54,12 @@ private:
     
     // Helper for ultrasonic
     long measurePulse();
+    
+    // Output scaling set by the power manager
+    int motorLimit = 100;
+    int ledBrightness = 100;
+    
+    // Causal trace: sensor sample sequence behind each motor's last command
+    uint32_t motorCause[2] = {0xFFFFFFFF, 0xFFFFFFFF};
+    void traceMotor(int motor, int speed, bool forward);
 };
\ No newline at end of file
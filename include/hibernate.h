@@ -0,0 +1,71 @@
+#ifndef HIBERNATE_H
+#define HIBERNATE_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "config.h"
+#include "movement.h"
+#include "sensors.h"
+#include "behaviors.h"
+#include "battery_estimator.h"
+#include "energy_model.h"
+
+// ============================================================================
+// HIBERNATE - deep sleep through the dark, full boot only when light returns
+// ============================================================================
+// When phototropism has been waiting in IDLE (too dark) for a while, the robot
+// deep-sleeps with an RTC timer wakeup. Each wake takes a quick LDR sample at
+// the very top of setup() and goes straight back to sleep if it is still dark,
+// before HAL init and everything after it. Only when the light crosses the
+// phototropism threshold does the boot continue, as a warm resume: config and
+// behavior state come back from RTC memory and the red boot LED is skipped.
+// The motor driver pins are latched low while asleep.
+
+class Hibernate {
+public:
+    enum Wake {
+        COLD_BOOT,      // Power-on or reset: nothing to restore
+        WARM_LIGHT,     // Woke from hibernate and it is light
+        WARM_OTHER      // Woke from some other deep sleep
+    };
+    
+    Hibernate(HAL& halRef, Movement& moveRef, LDRSensor& ldrRef, Phototropism& photoRef,
+              MotorConfig& cfgRef, BatteryEstimator& batteryRef, EnergyModel& energyRef);
+    
+    // Top of setup(). While still dark this goes back to sleep and never returns.
+    Wake resume();
+    bool isWarm();
+    
+    // After HAL init on a warm resume: config, behavior, SoC and energy from RTC memory
+    void restore();
+    
+    // loop(): hibernate once phototropism has idled in the dark for DARK_HOLD_MS.
+    // Callers only pass busy = false when nothing else (modes, console) is active.
+    void update(bool busy);
+    void enter();
+    
+    void setEnabled(bool on);
+    bool isEnabled();
+    void setInterval(uint32_t seconds);
+    
+    void printStatus();
+    
+private:
+    HAL& hal;
+    Movement& movement;
+    LDRSensor& ldrSensor;
+    Phototropism& phototropism;
+    MotorConfig& config;
+    BatteryEstimator& battery;
+    EnergyModel& energy;
+    
+    static const unsigned long DARK_HOLD_MS = 60000;
+    
+    Wake wake = COLD_BOOT;
+    unsigned long darkSince = 0;
+    
+    float sampleBrightness();
+    void sleep();
+};
+
+#endif
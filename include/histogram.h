@@ -0,0 +1,82 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// LOG-SCALE HISTOGRAM
+// ============================================================================
+// Fixed-size, heap-free distribution of 32-bit values. Each power of two is
+// split into 2^SubBits buckets, so a bucket spans at most 1/2^SubBits of its
+// value (SubBits = 2 -> ~19%, 0 -> plain octaves). Percentiles report the upper
+// edge of the bucket they fall in, capped at the observed maximum.
+
+template <int SubBits = 2>
+class LogHistogram {
+public:
+    static const int SUB_BUCKETS = 1 << SubBits;
+    static const int NUM_BUCKETS = 32 * SUB_BUCKETS;
+    
+    LogHistogram() { reset(); }
+    
+    void record(uint32_t value) {
+        if (n == 0 || value < lo) lo = value;
+        if (value > hi) hi = value;
+        total += value;
+        n++;
+        buckets[bucketFor(value)]++;
+    }
+    
+    void reset() {
+        n = 0;
+        lo = 0;
+        hi = 0;
+        total = 0;
+        memset(buckets, 0, sizeof(buckets));
+    }
+    
+    uint32_t count() const { return n; }
+    uint32_t min() const { return lo; }
+    uint32_t max() const { return hi; }
+    uint64_t sum() const { return total; }
+    float mean() const { return n ? (float)total / n : 0.0f; }
+    
+    uint32_t percentile(uint32_t permille) const {
+        if (n == 0) return 0;
+        uint32_t target = (uint32_t)(((uint64_t)n * permille + 999) / 1000);
+        uint32_t seen = 0;
+        for (int b = 0; b < NUM_BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen >= target) {
+                uint32_t upper = upperBound(b);
+                return upper < hi ? upper : hi;
+            }
+        }
+        return hi;
+    }
+    
+private:
+    uint32_t n;
+    uint32_t lo;
+    uint32_t hi;
+    uint64_t total;
+    uint32_t buckets[NUM_BUCKETS];
+    
+    static int bucketFor(uint32_t value) {
+        if (value < (uint32_t)SUB_BUCKETS) return value;
+        int octave = 31 - __builtin_clz(value);
+        int sub = (value >> (octave - SubBits)) & (SUB_BUCKETS - 1);   // Bits below the MSB
+        return octave * SUB_BUCKETS + sub;
+    }
+    
+    static uint32_t upperBound(int bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        int octave = bucket / SUB_BUCKETS;
+        int sub = bucket % SUB_BUCKETS;
+        uint64_t upper = ((uint64_t)(SUB_BUCKETS + sub + 1) << (octave - SubBits)) - 1;
+        return upper > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)upper;
+    }
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// LOG RECORD FORMATTING - shared by the firmware's log task and host tools
+// ============================================================================
+// A deferred log record is a format string plus up to MAX_ARGS raw 32-bit
+// arguments, each tagged with a 2-bit type. Formatting walks the format
+// string and prints one conversion at a time with the argument's real type,
+// so no va_list is ever rebuilt. Length modifiers (l, h, z) are ignored: every
+// argument is 32 bits. A conversion whose argument is missing or of the wrong
+// kind prints '?'. '*' widths are not supported.
+//
+// String arguments are resolved through a callback: the firmware passes the
+// pointer itself, the host looks up the id the string was sent under.
+
+namespace LogFormat {
+
+    const uint8_t MAX_ARGS = 6;
+
+    enum ArgType : uint8_t {
+        ARG_INT = 0,
+        ARG_UINT,
+        ARG_FLOAT,
+        ARG_STR,
+    };
+
+    inline ArgType argType(uint16_t types, uint8_t index) {
+        return (ArgType)((types >> (index * 2)) & 0x3);
+    }
+
+    typedef const char* (*StringResolver)(uint32_t value, void* ctx);
+
+    // Returns the formatted length (truncated to size - 1)
+    inline size_t format(char* out, size_t size, const char* fmt, const uint32_t* args,
+                         uint16_t types, uint8_t count, StringResolver resolve, void* ctx) {
+        size_t len = 0;
+        uint8_t next = 0;
+        char spec[16];
+
+        while (*fmt && len + 1 < size) {
+            if (*fmt != '%') {
+                out[len++] = *fmt++;
+                continue;
+            }
+            if (fmt[1] == '%') {
+                out[len++] = '%';
+                fmt += 2;
+                continue;
+            }
+
+            // Copy flags/width/precision, drop length modifiers
+            size_t s = 0;
+            spec[s++] = *fmt++;
+            while (*fmt && strchr("-+ #0123456789.", *fmt) && s < sizeof(spec) - 2) {
+                spec[s++] = *fmt++;
+            }
+            while (*fmt && strchr("lhzjt", *fmt)) fmt++;
+            char conv = *fmt;
+            if (!conv) break;
+            fmt++;
+            spec[s++] = conv;
+            spec[s] = '\0';
+
+            size_t room = size - len;
+            int n = -1;
+            if (next < count) {
+                uint32_t v = args[next];
+                ArgType t = argType(types, next);
+                next++;
+                if (strchr("di", conv) && (t == ARG_INT || t == ARG_UINT)) {
+                    n = snprintf(out + len, room, spec, (int)(int32_t)v);
+                } else if (strchr("uxXoc", conv) && (t == ARG_INT || t == ARG_UINT)) {
+                    n = snprintf(out + len, room, spec, (unsigned)v);
+                } else if (strchr("fFeEgG", conv) && t == ARG_FLOAT) {
+                    float f;
+                    memcpy(&f, &v, sizeof(f));
+                    n = snprintf(out + len, room, spec, (double)f);
+                } else if (conv == 's' && t == ARG_STR) {
+                    const char* str = resolve ? resolve(v, ctx) : nullptr;
+                    n = snprintf(out + len, room, spec, str ? str : "?");
+                }
+            }
+            if (n < 0) {
+                out[len++] = '?';
+            } else {
+                len += (size_t)n < room ? (size_t)n : room - 1;
+            }
+        }
+        out[len] = '\0';
+        return len;
+    }
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "log_format.h"
+
+// ============================================================================
+// DEFERRED LOGGING
+// ============================================================================
+// LOG_ERROR/WARN/INFO/DEBUG(fmt, args...) cost a few hundred nanoseconds at
+// the call site: the format string pointer, a timestamp and the raw argument
+// words are copied into a lock-free ring and a low-priority task on core 0
+// does the formatting and the (possibly blocking) UART write. In binary mode
+// the task ships records as protocol frames instead, sending each format
+// string once under a small id (tools/ember_link decodes them).
+//
+// Rules for call sites:
+//   - The format string and any %s argument must be string literals or other
+//     static storage: only the pointer is recorded.
+//   - At most 6 arguments: integers, floats/doubles (sent as float), strings.
+//   - Not from ISRs. Tasks and esp_timer callbacks are fine.
+//
+// Levels above EMBER_LOG_LEVEL compile to nothing (0 off, 1 error, 2 warn,
+// 3 info, 4 debug). If the ring is full the record is dropped and counted.
+
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef EMBER_LOG_LEVEL
+#define EMBER_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+class Logger {
+public:
+    static const size_t RING_SIZE = 128;    // Records; power of two
+    static const size_t LINE_SIZE = 160;
+
+    enum Output {
+        OUTPUT_TEXT,        // Formatted lines on the console
+        OUTPUT_BINARY,      // LOG_FORMAT / LOG_RECORD frames (include/protocol.h)
+        OUTPUT_OFF,         // Drain and discard
+    };
+
+    struct Arg {
+        uint32_t value;
+        LogFormat::ArgType type;
+
+        Arg() : value(0), type(LogFormat::ARG_INT) {}
+        Arg(int v) : value((uint32_t)v), type(LogFormat::ARG_INT) {}
+        Arg(long v) : value((uint32_t)v), type(LogFormat::ARG_INT) {}
+        Arg(unsigned v) : value(v), type(LogFormat::ARG_UINT) {}
+        Arg(unsigned long v) : value((uint32_t)v), type(LogFormat::ARG_UINT) {}
+        Arg(bool v) : value(v), type(LogFormat::ARG_INT) {}
+        Arg(float v) : type(LogFormat::ARG_FLOAT) { memcpy(&value, &v, sizeof(value)); }
+        Arg(double v) : Arg((float)v) {}
+        Arg(const char* v) : value((uint32_t)(uintptr_t)v), type(LogFormat::ARG_STR) {}
+    };
+
+    // Never called: lets the compiler check each call's format and arguments
+    __attribute__((format(printf, 1, 2))) static void check(const char*, ...) {}
+
+    Logger();
+    bool begin(uint8_t core = 0);
+    TaskHandle_t getHandle() { return handle; }
+
+    template <typename... T>
+    void write(uint8_t level, const char* fmt, T... args) {
+        static_assert(sizeof...(T) <= LogFormat::MAX_ARGS, "at most 6 log arguments");
+        const Arg list[sizeof...(T) + 1] = { Arg(args)... };
+        push(level, fmt, list, sizeof...(T));
+    }
+
+    void setOutput(Output out);
+    Output getOutput() { return output; }
+
+    // Wait (up to maxMs) for the task to empty the ring, e.g. before deep sleep
+    void flush(uint32_t maxMs = 200);
+
+    void printStatus();
+
+private:
+    struct Record {
+        uint32_t timeMs;
+        const char* fmt;
+        uint8_t level;
+        uint8_t count;
+        uint16_t types;
+        uint32_t args[LogFormat::MAX_ARGS];
+    };
+
+    // Bounded MPSC ring: a slot's seq says whose turn it is (producer at
+    // seq == position, consumer at seq == position + 1)
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        Record record;
+    };
+
+    Slot ring[RING_SIZE];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};          // Only the log task moves this
+    std::atomic<uint32_t> dropped{0};
+    uint32_t reportedDrops = 0;
+    uint32_t written = 0;
+    uint32_t highWater = 0;
+
+    TaskHandle_t handle = nullptr;
+    volatile Output output = OUTPUT_TEXT;
+    volatile bool dictionaryStale = true;
+
+    // Binary mode: format/string pointer -> id sent to the host
+    static const int DICT_SIZE = 128;
+    const char* dict[DICT_SIZE];
+    int dictCount = 0;
+
+    char line[LINE_SIZE];
+
+    void push(uint8_t level, const char* fmt, const Arg* args, uint8_t count);
+    bool pop(Record& out);
+    void emit(const Record& r);
+    void emitText(const Record& r);
+    void emitBinary(const Record& r);
+    uint8_t lookup(const char* str);
+
+    static void taskEntry(void* param);
+};
+
+extern Logger logger;
+
+#if EMBER_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) do { \
+        if (false) Logger::check(fmt, ##__VA_ARGS__); \
+        logger.write(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_ERROR(fmt, ...) do {} while (0)
+#endif
+
+#if EMBER_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...) do { \
+        if (false) Logger::check(fmt, ##__VA_ARGS__); \
+        logger.write(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_WARN(fmt, ...) do {} while (0)
+#endif
+
+#if EMBER_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...) do { \
+        if (false) Logger::check(fmt, ##__VA_ARGS__); \
+        logger.write(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_INFO(fmt, ...) do {} while (0)
+#endif
+
+#if EMBER_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) do { \
+        if (false) Logger::check(fmt, ##__VA_ARGS__); \
+        logger.write(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_DEBUG(fmt, ...) do {} while (0)
+#endif
+
+#endif
@@ -16,6 +16,7 @@ public:
     void spinCW(int speed = -1);
     void spinCCW(int speed = -1);
     void stop();
+    void refresh();     // Re-send the current command (after an output limit change)
     
     // Speed presets
     void crawl();
@@ -29,10 +30,13 @@ public:
     
     // Proportional turning
     void setVeer(int baseSpeed, int turnAmount);
+    void setTwist(int linear, int angular);   // Differential drive, angular > 0 = clockwise
     
     // State queries
     bool isMoving();
     int getCurrentSpeed();
+    int getWheelSpeedA();   // Signed effective PWM, negative = reverse
+    int getWheelSpeedB();
     
 private:
     HAL& hal;
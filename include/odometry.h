@@ -0,0 +1,45 @@
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include "movement.h"
+#include "config.h"
+
+// ============================================================================
+// DEAD RECKONING
+// ============================================================================
+// EMBER has no wheel encoders or IMU, so pose is integrated from the commanded
+// wheel PWM. Rotation is calibrated from MotorConfig::turnDuration (a ~90° spin
+// at baseSpeed) and translation from MotorConfig::cruiseSpeedCmS. Good enough to
+// carry a bearing between scans; drifts over minutes, so re-scan regularly.
+//
+// Heading convention: degrees, 0 = pose at reset, positive = clockwise.
+
+class Odometry {
+public:
+    Odometry(Movement& movRef, MotorConfig& cfg);
+    
+    void update();              // Call in loop - integrates since last call
+    void reset();
+    
+    float getHeading();         // 0-360°
+    float getX();               // cm, along the heading at reset
+    float getY();               // cm, to the right of the heading at reset
+    float getDistance();        // Total path length travelled (cm)
+    float getSpeed();           // Current forward speed from wheel commands (cm/s, negative = reverse)
+    
+    static float wrap180(float deg);   // Wrap to (-180, 180]
+    static float wrap360(float deg);   // Wrap to [0, 360)
+    
+private:
+    Movement& movement;
+    MotorConfig& config;
+    
+    float heading = 0.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    float distance = 0.0f;
+    float speed = 0.0f;
+    unsigned long lastUpdate = 0;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// PARAMETER REGISTRY - named, range-checked tunables persisted in NVS
+// ============================================================================
+// Each parameter binds a name ("photo.balance") to a field of one of the
+// config structs (MotorConfig, PhototropismParams, ...). The field's value
+// when it is added becomes its default. The registry only reads and writes
+// those fields; the modules keep using their structs as before.
+//
+// NVS blob ("ember"/"params"): a header (magic, schema version, entry count,
+// CRC-16 of the entries) followed by { FNV-1a hash of the name, value as
+// float } per parameter. Entries are matched by hash, so adding or removing
+// a parameter keeps the rest of a saved set; bump SCHEMA_VERSION when an
+// existing parameter changes meaning or units. A bad magic, CRC or version
+// loads nothing (defaults stay), and a stored value now out of range keeps
+// its default.
+//
+// Rules tie pairs of parameters together (stop distance not beyond the warn
+// distance, dark and light calibration apart). set() and batch() refuse a
+// change that breaks one; load() puts both members of a broken pair back to
+// their defaults.
+
+class ParamRegistry {
+public:
+    static const int MAX_PARAMS = 40;
+    static const int MAX_RULES = 8;
+    static const uint16_t SCHEMA_VERSION = 1;
+
+    enum Type : uint8_t {
+        TYPE_INT,
+        TYPE_FLOAT,
+        TYPE_BOOL,
+    };
+
+    enum Result {
+        OK,
+        UNKNOWN_NAME,
+        BAD_VALUE,          // Not a number / not on|off
+        OUT_OF_RANGE,
+        BAD_SYNTAX,         // Batch entry without '='
+        CONFLICT,           // Breaks a rule with another parameter
+    };
+
+    enum LoadResult {
+        LOAD_OK,
+        LOAD_EMPTY,         // Nothing saved yet
+        LOAD_CORRUPT,       // Bad magic, size or CRC
+        LOAD_VERSION,       // Saved under another schema
+    };
+
+    struct Param {
+        const char* name;
+        const char* help;
+        Type type;
+        void* value;
+        float min;
+        float max;
+        float def;
+    };
+
+    // Names must be string literals; false if the table is full
+    bool add(const char* name, int* value, int min, int max, const char* help);
+    bool add(const char* name, float* value, float min, float max, const char* help);
+    bool add(const char* name, bool* value, const char* help);
+
+    // Rules between registered parameters; false if a name is unknown or the
+    // rule table is full
+    bool requireNotAbove(const char* lower, const char* upper);        // lower <= upper
+    bool requireApart(const char* a, const char* b, float minGap);     // |a - b| >= minGap
+
+    const Param* find(const char* name);
+    float get(const Param& p);
+    Result set(const char* name, const char* text);
+
+    // "a=1,b=2.5,c=on": every entry is checked before any is applied.
+    // On failure *failedAt points at the offending entry.
+    Result batch(const char* list, const char** failedAt = nullptr);
+
+    void resetDefaults();
+    bool save();
+    LoadResult load();
+
+    void print(const Param& p);
+    void list(const char* prefix = "");     // Every parameter whose name starts with prefix
+    void printStatus();
+
+    static const char* resultName(Result r);
+    const char* getConflict() { return conflict; }     // Rule behind the last CONFLICT
+    int getCount() { return count; }
+
+private:
+    struct Rule {
+        const Param* a;
+        const Param* b;
+        float minGap;       // < 0: a <= b, otherwise |a - b| >= minGap
+    };
+
+    Param table[MAX_PARAMS];
+    int count = 0;
+    Rule rules[MAX_RULES];
+    int ruleCount = 0;
+    char conflict[64] = "";
+
+    LoadResult lastLoad = LOAD_EMPTY;
+    int loadedCount = 0;
+    int rejectedCount = 0;
+    int conflictCount = 0;
+
+    bool append(const char* name, Type type, void* value, float min, float max, float def,
+                const char* help);
+    Result parse(const Param& p, const char* text, float& out);
+    void assign(const Param& p, float v);
+    bool addRule(const char* a, const char* b, float minGap);
+    bool holds(const Rule& r, float a, float b);
+    bool consistent(const Param* const* targets, const float* values, int n);
+
+    static uint32_t hashName(const char* name);
+};
+
+extern ParamRegistry params;
+
+#endif
@@ -36,4 +36,7 @@ namespace Pins {
     constexpr int MOTOR_B_EN  = 4;  // Right Motor Speed (PWM - for TB6612FNG)
     constexpr int MOTOR_STBY  = 13; // Standby pin for TB6612FNG
 
+    // -- User Input --
+    constexpr int BOOT_BUTTON = 0;  // DevKit BOOT button (active low, free after boot)
+
 } // namespace Pins
@@ -0,0 +1,105 @@
+#ifndef POSTMORTEM_H
+#define POSTMORTEM_H
+
+#include <Arduino.h>
+#include <esp_system.h>
+#include "transition_log.h"
+
+// ============================================================================
+// POSTMORTEM - what the robot was doing when it last reset
+// ============================================================================
+// Small rings in RTC slow memory (RTC_NOINIT_ATTR) that survive a brownout,
+// watchdog, panic or software reset - everything except a power-on:
+//
+//   transitions   last 32 behavior state changes (same record as TransitionLog)
+//   motors        last 32 changes of the signed wheel command
+//   battery       pack voltage and power mode once a second, last 16
+//
+// plus a heartbeat (millis() of the last loop pass) and the lowest voltage
+// seen. begin() runs early in setup(): it reads esp_reset_reason(),
+// copies the previous boot's rings to RAM for reporting and starts fresh
+// ones. Resets are counted per cause in NVS, so the counts also survive
+// power cycles; deep sleep wakes are not counted (hibernate counts those).
+//
+// Writes are plain stores into RTC memory, so whatever was written before
+// the supply collapsed is there on the next boot: a brownout report ends
+// with the motor step that caused it.
+
+class Postmortem {
+public:
+    static const int TRANSITIONS = 32;
+    static const int MOTORS = 32;
+    static const int READINGS = 16;
+    static const uint32_t BATTERY_PERIOD_MS = 1000;
+    static const int REASON_COUNT = ESP_RST_SDIO + 1;
+
+    struct MotorEntry {
+        uint32_t timeMs;
+        int16_t wheelA;         // Signed commanded PWM, negative = reverse
+        int16_t wheelB;
+    };
+
+    struct BatteryEntry {
+        uint32_t timeMs;
+        uint16_t millivolts;
+        uint8_t powerMode;      // PowerManager::Mode
+        uint8_t reserved;
+    };
+
+    // Top of setup(), after the hibernate wake check
+    void begin();
+    // The NVS write for this reset, kept off the path to ready
+    void saveResetCount();
+
+    // Hooks: TransitionLog::record(), Movement's motor writes, loop()
+    void noteTransition(const TransitionRecord& r);
+    void noteMotors(int wheelA, int wheelB);
+    void update(float volts, uint8_t powerMode);
+
+    esp_reset_reason_t getResetReason() { return reason; }
+    bool wasAbnormal();                 // Brownout, watchdog or panic
+    uint32_t getBootNumber() { return bootNumber; }     // Since the last power-on
+    uint32_t getResetCount(esp_reset_reason_t r);
+    uint32_t getCrashCount();           // Panics + watchdogs
+    static const char* reasonName(esp_reset_reason_t r);
+
+    void printBootReport();             // One line; the last events too after a crash
+    void printReport();                 // Counts and the previous boot's whole history
+    void clearCounts();
+
+private:
+    struct State {
+        uint32_t magic;
+        uint32_t boot;
+        uint32_t lastAliveMs;
+        uint16_t minMillivolts;
+        uint16_t reserved;
+        uint32_t transitionTotal;       // Entries ever written; index = total % capacity
+        uint32_t motorTotal;
+        uint32_t batteryTotal;
+        TransitionRecord transitions[TRANSITIONS];
+        MotorEntry motors[MOTORS];
+        BatteryEntry battery[READINGS];
+    };
+
+    static State rtc;
+    State previous;                 // Copy of the last boot's rings
+    bool hasPrevious = false;
+
+    esp_reset_reason_t reason = ESP_RST_UNKNOWN;
+    uint32_t bootNumber = 0;
+    uint32_t counts[REASON_COUNT];
+    bool countPending = false;
+
+    int16_t lastA = 0;
+    int16_t lastB = 0;
+    unsigned long nextBatteryMs = 0;
+
+    void loadCounts();
+    void saveCounts();
+    void printTimeline(int maxEvents);
+};
+
+extern Postmortem postmortem;
+
+#endif
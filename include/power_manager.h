@@ -0,0 +1,73 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "movement.h"
+#include "sensor_task.h"
+#include "battery_estimator.h"
+
+// ============================================================================
+// POWER MANAGER - battery voltage to power mode, mode to feature scaling
+// ============================================================================
+// Implements docs/POWER_MANAGEMENT_SYSTEM.md:
+//   NORMAL   >= 7.8V     motors 100%, sensing 40ms, LED 100%, CPU up to 240 MHz
+//   ECONOMY  7.2-7.8V    motors  75%, sensing 100ms, LED 75%, CPU up to 160 MHz
+//   LOW      6.8-7.2V    motors  50%, sensing 200ms, LED 50%, CPU 80 MHz
+//   CRITICAL 6.4-6.8V    motors  25%, sensing 500ms, LED 25%, CPU 80 MHz
+//   SHUTDOWN < 6.4V      everything off, deep sleep
+//
+// Once a second the battery estimator's open-circuit voltage (motor sag
+// removed with the learned internal resistance) is averaged over 5 readings.
+// A mode change needs the new mode to hold for 30 s; returning to a better mode
+// also needs 0.1V of headroom above the threshold. No battery sensed (USB
+// bench power) leaves NORMAL in place. A saturated ADC (divider ratio set too
+// low for the pack) reads as "full" until it is recalibrated.
+
+class PowerManager {
+public:
+    enum Mode { POWER_NORMAL, POWER_ECONOMY, POWER_LOW, POWER_CRITICAL, POWER_SHUTDOWN };
+    static const int MODE_COUNT = 5;
+    
+    PowerManager(HAL& halRef, Movement& moveRef, SensorTask& taskRef,
+                 BatteryEstimator& batteryRef);
+    
+    void begin();
+    void update();
+    
+    Mode getMode();
+    static const char* modeName(Mode mode);
+    float getVoltage();             // Averaged open-circuit voltage
+    bool hasBattery();
+    
+    void printReport();
+    
+private:
+    HAL& hal;
+    Movement& movement;
+    SensorTask& sensorTask;
+    BatteryEstimator& estimator;
+    
+    Mode mode = POWER_NORMAL;
+    Mode pendingMode = POWER_NORMAL;
+    unsigned long pendingSince = 0;
+    bool started = false;
+    bool battery = true;
+    
+    static const int AVG_WINDOW = 5;
+    float readings[AVG_WINDOW];
+    int readingCount = 0;
+    int readingIndex = 0;
+    float voltage = 0;
+    
+    unsigned long lastSample = 0;
+    unsigned long modeEntered = 0;
+    uint32_t residencyMs[MODE_COUNT] = { 0, 0, 0, 0, 0 };
+    uint32_t transitions = 0;
+    
+    Mode classify(float v, bool improving);
+    void enterMode(Mode newMode);
+    void applyMode();
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// ============================================================================
+// LOOP PROFILER - per-section timing from the microsecond timer
+// ============================================================================
+// Wrap a section with PROFILE_SCOPE(SECTION) (or PROFILE_BEGIN/PROFILE_END when
+// a scope would mean re-indenting a large block). Each section keeps count,
+// min/avg/max and a fixed log-scale histogram for p99. All storage is static;
+// nothing touches the heap. Build with -DEMBER_PROFILING=0 and every macro
+// expands to nothing. Times come from esp_timer rather than the cycle counter:
+// the clock moves between 80, 160 and 240 MHz with demand (event_loop.h), so a
+// cycle count has no fixed meaning in time.
+
+#ifndef EMBER_PROFILING
+#define EMBER_PROFILING 1
+#endif
+
+namespace Profiler {
+
+    enum Section : uint8_t {
+        LOOP,           // Whole loop() body (excluding the event wait)
+        COMMANDS,       // Serial command handling
+        ULTRASONIC,     // UltrasonicSensor::update()
+        LDR,            // LDRSensor::update()
+        ESTIMATORS,     // Odometry, stuck detector, coverage
+        STATUS_LED,     // StatusLED::update()
+        AVOIDANCE,      // ObstacleAvoidance::update()
+        PHOTOTROPISM,   // Phototropism::update()
+        NAVIGATOR,      // LightNavigator::update()
+        CAPTURE,        // SensorTask capture cycle (core 0)
+        SECTION_COUNT
+    };
+
+#if EMBER_PROFILING
+
+    inline uint32_t now() {
+        return (uint32_t)esp_timer_get_time();
+    }
+    
+    void record(Section section, uint32_t us);
+    void reset();
+    void printReport();
+    
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Section s) : section(s), start(now()) {}
+        ~ScopedTimer() { record(section, now() - start); }
+    private:
+        Section section;
+        uint32_t start;
+    };
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(sec) Profiler::ScopedTimer PROFILE_CONCAT(_profScope, __LINE__)(Profiler::sec)
+#define PROFILE_BEGIN(sec) uint32_t _profStart_##sec = Profiler::now()
+#define PROFILE_END(sec) Profiler::record(Profiler::sec, Profiler::now() - _profStart_##sec)
+
+#else
+
+    inline void reset() {}
+    inline void printReport() { Serial.println("Profiler disabled (build with -DEMBER_PROFILING=1)"); }
+
+#define PROFILE_SCOPE(sec)
+#define PROFILE_BEGIN(sec)
+#define PROFILE_END(sec)
+
+#endif
+
+} // namespace Profiler
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// EMBER BINARY PROTOCOL - wire format shared by the firmware and host tools
+// ============================================================================
+// Frames travel on the same UART as the text console:
+//
+//   0x00 | COBS( type | seq | payload... | crc16 ) | 0x00
+//
+// COBS removes every zero byte from the body, so 0x00 only ever delimits.
+// Text never contains 0x00: the receiver treats bytes between delimiters as a
+// frame and everything else as console text. The leading delimiter resyncs a
+// receiver that joined mid-frame. CRC16 is CCITT-FALSE (poly 0x1021, init
+// 0xFFFF) over type, seq and payload, appended little-endian.
+//
+// Host -> robot messages are commands; each one is answered with an ACK that
+// echoes its seq. Robot -> host telemetry carries its own wrapping seq so the
+// host can count lost records. All fields are little-endian (ESP32 and x86).
+// This header has no Arduino dependency so host code can include it as-is.
+
+namespace Protocol {
+
+    const uint8_t VERSION = 1;
+    const size_t MAX_PAYLOAD = 48;
+    const size_t MAX_BODY = 2 + MAX_PAYLOAD + 2;                // type, seq, payload, crc
+    const size_t MAX_ENCODED = MAX_BODY + MAX_BODY / 254 + 1;   // COBS overhead
+    const size_t MAX_FRAME = MAX_ENCODED + 2;                   // Plus both delimiters
+
+    // ========================================================================
+    // MESSAGE TYPES
+    // ========================================================================
+
+    enum Type : uint8_t {
+        // Host -> robot
+        CMD_PING       = 0x01,  // No payload; ACK carries the protocol version
+        CMD_STOP       = 0x02,  // Emergency stop: all modes off, motors off
+        CMD_DRIVE      = 0x03,  // DrivePayload
+        CMD_MODE       = 0x04,  // ModePayload
+        CMD_TELEMETRY  = 0x05,  // TelemetryPayload
+        CMD_TEXT       = 0x06,  // Console command line (the text command set)
+        CMD_BAUD       = 0x07,  // BaudPayload; switches after the ACK is sent
+
+        // Robot -> host
+        ACK            = 0x80,  // AckPayload
+        TLM_SENSORS    = 0x81,  // SensorRecord
+        TLM_MOTORS     = 0x82,  // MotorRecord
+        TLM_BEHAVIOR   = 0x83,  // BehaviorRecord
+        TLM_BATTERY    = 0x84,  // BatteryRecord
+        LOG_FORMAT     = 0x85,  // LogFormatPayload: defines a log string id
+        LOG_RECORD     = 0x86,  // LogRecordPayload
+    };
+
+    enum AckStatus : uint8_t {
+        ACK_OK = 0,
+        ACK_UNKNOWN_TYPE,
+        ACK_BAD_LENGTH,
+        ACK_REJECTED,           // Well-formed but not valid now (e.g. bad value)
+        ACK_DEAD,               // Would drive the motors, but energy is 0 ("revive")
+    };
+
+    enum Mode : uint8_t {
+        MODE_AUTONOMOUS = 1,
+        MODE_PHOTOTROPISM,
+        MODE_NAVIGATOR,
+        MODE_HIBERNATE,
+    };
+
+    // Telemetry record selection mask (CMD_TELEMETRY)
+    enum RecordMask : uint8_t {
+        REC_SENSORS  = 1 << 0,
+        REC_MOTORS   = 1 << 1,
+        REC_BEHAVIOR = 1 << 2,
+        REC_BATTERY  = 1 << 3,
+        REC_ALL      = 0x0F,
+    };
+
+    // ========================================================================
+    // PAYLOADS
+    // ========================================================================
+
+    struct __attribute__((packed)) DrivePayload {
+        int16_t linear;         // PWM -255..255, forward positive
+        int16_t angular;        // PWM -255..255, clockwise positive
+        uint16_t timeoutMs;     // Stop if no newer DRIVE arrives in time; 0 = none
+    };
+
+    struct __attribute__((packed)) ModePayload {
+        uint8_t mode;           // Mode
+        uint8_t enable;
+    };
+
+    struct __attribute__((packed)) TelemetryPayload {
+        uint16_t periodMs;      // 0 = stop streaming
+        uint8_t mask;           // RecordMask
+    };
+
+    struct __attribute__((packed)) BaudPayload {
+        uint32_t baud;
+    };
+
+    struct __attribute__((packed)) AckPayload {
+        uint8_t seq;            // Seq of the command being answered
+        uint8_t type;
+        uint8_t status;         // AckStatus
+        uint8_t info;           // CMD_PING: protocol version
+    };
+
+    struct __attribute__((packed)) SensorRecord {
+        uint32_t timeMs;
+        uint32_t sampleSeq;     // Sensor task sample behind these values
+        int16_t distanceCm;     // Filtered
+        int16_t rawDistanceCm;  // Last ping
+        uint16_t lightLeft;     // Brightness x1000
+        uint16_t lightRight;
+    };
+
+    struct __attribute__((packed)) MotorRecord {
+        uint32_t timeMs;
+        int16_t wheelA;         // Effective signed PWM (left)
+        int16_t wheelB;         // (right)
+        uint8_t limitPercent;   // Power-mode cap
+        uint8_t reserved;
+        int16_t headingDeciDeg; // Odometry, 0-3599, clockwise
+        int32_t xMm;
+        int32_t yMm;
+    };
+
+    struct __attribute__((packed)) BehaviorRecord {
+        uint32_t timeMs;
+        uint8_t enabledMask;    // Bit (Mode - 1) set when enabled
+        uint8_t avoidanceState;
+        uint8_t phototropismState;
+        uint8_t navigatorState;
+        uint8_t powerMode;      // PowerManager::Mode
+        uint8_t clockLevel;     // EventLoop::Level
+    };
+
+    struct __attribute__((packed)) BatteryRecord {
+        uint32_t timeMs;
+        uint16_t measuredMv;
+        uint16_t openCircuitMv;
+        uint16_t socPermille;
+        int16_t minutesLeft;    // -1 unknown
+        uint16_t currentMa;     // Modeled
+        uint16_t resistanceMilliOhm;
+    };
+
+    // Deferred log records (see include/log_format.h). Every format string
+    // and %s argument is sent once as text under a one-byte id, split into
+    // chunks; the chunk holding the terminating NUL completes it. Ids are
+    // reassigned from 0 whenever the firmware's table fills or binary logging
+    // is switched on, so the host simply overwrites.
+    const size_t LOG_CHUNK = MAX_PAYLOAD - 2;
+
+    struct __attribute__((packed)) LogFormatPayload {
+        uint8_t id;
+        uint8_t offset;         // Position of this chunk in the string
+        char text[LOG_CHUNK];   // Frame length gives the chunk length
+    };
+
+    struct __attribute__((packed)) LogRecordPayload {
+        uint32_t timeMs;
+        uint8_t formatId;
+        uint8_t level;          // 1 error .. 4 debug
+        uint8_t count;
+        uint8_t reserved;
+        uint16_t types;         // 2 bits per argument (LogFormat::ArgType)
+        uint32_t args[6];       // ARG_STR arguments hold a string id
+    };
+
+    // ========================================================================
+    // CODEC
+    // ========================================================================
+
+    inline uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF) {
+        for (size_t i = 0; i < len; i++) {
+            crc ^= (uint16_t)data[i] << 8;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    // Returns the encoded length; out needs len + len / 254 + 1 bytes
+    inline size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+        size_t write = 1;
+        size_t codeIndex = 0;
+        uint8_t code = 1;
+        for (size_t i = 0; i < len; i++) {
+            if (in[i] == 0) {
+                out[codeIndex] = code;
+                codeIndex = write++;
+                code = 1;
+            } else {
+                out[write++] = in[i];
+                if (++code == 0xFF) {
+                    out[codeIndex] = code;
+                    codeIndex = write++;
+                    code = 1;
+                }
+            }
+        }
+        out[codeIndex] = code;
+        return write;
+    }
+
+    // Returns the decoded length, or 0 if the input is malformed or too long
+    inline size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize) {
+        size_t read = 0;
+        size_t write = 0;
+        while (read < len) {
+            uint8_t code = in[read++];
+            if (code == 0 || read + code - 1 > len) return 0;
+            for (uint8_t i = 1; i < code; i++) {
+                if (write >= outSize) return 0;
+                out[write++] = in[read++];
+            }
+            if (code != 0xFF && read < len) {
+                if (write >= outSize) return 0;
+                out[write++] = 0;
+            }
+        }
+        return write;
+    }
+
+    // Builds a complete frame including both delimiters; returns its length
+    inline size_t encodeFrame(uint8_t type, uint8_t seq, const void* payload, size_t len,
+                              uint8_t* frame) {
+        if (len > MAX_PAYLOAD) return 0;
+        uint8_t body[MAX_BODY];
+        body[0] = type;
+        body[1] = seq;
+        const uint8_t* bytes = static_cast<const uint8_t*>(payload);
+        for (size_t i = 0; i < len; i++) body[2 + i] = bytes[i];
+        uint16_t crc = crc16(body, 2 + len);
+        body[2 + len] = crc & 0xFF;
+        body[3 + len] = crc >> 8;
+
+        frame[0] = 0;
+        size_t encoded = cobsEncode(body, len + 4, frame + 1);
+        frame[1 + encoded] = 0;
+        return encoded + 2;
+    }
+
+    // Decodes the bytes between two delimiters. On success fills type/seq and
+    // copies the payload; returns false on a COBS or CRC error.
+    inline bool decodeFrame(const uint8_t* encoded, size_t len, uint8_t& type, uint8_t& seq,
+                            uint8_t* payload, size_t& payloadLen) {
+        uint8_t body[MAX_BODY];
+        size_t bodyLen = cobsDecode(encoded, len, body, sizeof(body));
+        if (bodyLen < 4) return false;
+        uint16_t crc = body[bodyLen - 2] | (uint16_t)body[bodyLen - 1] << 8;
+        if (crc16(body, bodyLen - 2) != crc) return false;
+        type = body[0];
+        seq = body[1];
+        payloadLen = bodyLen - 4;
+        for (size_t i = 0; i < payloadLen; i++) payload[i] = body[2 + i];
+        return true;
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PROTOCOL_LINK_H
+#define PROTOCOL_LINK_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+// ============================================================================
+// PROTOCOL LINK - binary frames alongside the text console on Serial
+// ============================================================================
+// poll() is the console's only reader: it splits the incoming bytes into
+// frames (between 0x00 delimiters) and plain console text, which it returns
+// one character at a time. Valid frames go to the command handler and are
+// acknowledged; CMD_TEXT payloads are fed back into the text stream, so every
+// console command is also scriptable. Telemetry frames are written whole or
+// not at all, never blocking the control loop on a full TX buffer. All frames
+// go out through serialTx, so the room check holds against the log task.
+
+class ProtocolLink {
+public:
+    // Returns a Protocol::AckStatus for the ACK
+    typedef uint8_t (*CommandHandler)(uint8_t type, const uint8_t* payload, size_t len);
+    
+    void begin(CommandHandler handler);
+    
+    int poll();             // Next console text character, or -1
+    bool hasPending();      // Injected text still waiting to be returned
+    
+    // Telemetry
+    void setTelemetry(uint16_t periodMs, uint8_t mask);
+    bool telemetryDue();    // True once per period while streaming
+    uint8_t getTelemetryMask();
+    bool sendTelemetry(uint8_t type, const void* payload, size_t len);
+    
+    // Waits for TX room instead of dropping: for background tasks (the log
+    // task), never for the control loop
+    bool sendFrame(uint8_t type, const void* payload, size_t len);
+    
+    void printStatus();
+    
+private:
+    CommandHandler handler = nullptr;
+    
+    uint8_t rx[Protocol::MAX_ENCODED];
+    size_t rxLen = 0;
+    bool inFrame = false;
+    unsigned long lastRxMs = 0;
+    
+    char inject[Protocol::MAX_PAYLOAD + 1];     // Plus the newline
+    size_t injectLen = 0;
+    size_t injectHead = 0;
+    
+    uint16_t telemetryPeriod = 0;
+    uint8_t telemetryMask = 0;
+    unsigned long lastTelemetry = 0;
+    uint8_t txSeq = 0;
+    
+    uint32_t framesIn = 0;
+    uint32_t crcErrors = 0;
+    uint32_t overruns = 0;
+    uint32_t framesOut = 0;
+    uint32_t txDrops = 0;
+    
+    void handleFrame();
+    uint8_t nextSeq();
+    void sendAck(uint8_t seq, uint8_t type, uint8_t status, uint8_t info = 0);
+    size_t writeFrame(uint8_t type, uint8_t seq, const void* payload, size_t len, bool mayDrop);
+};
+
+extern ProtocolLink protocolLink;
+
+#endif
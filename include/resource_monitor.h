@@ -0,0 +1,85 @@
+#ifndef RESOURCE_MONITOR_H
+#define RESOURCE_MONITOR_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// RESOURCE MONITOR - heap, stack and CPU load telemetry
+// ============================================================================
+// Sampled once per period from loop(), so it costs a few microseconds a second:
+//   - Heap: free now, low-water mark since boot, largest free block
+//     (fragmentation), and the drift of free heap per hour (slow leaks)
+//   - Stack: high-water mark of each watched FreeRTOS task
+//   - CPU: idle percentage per core, timed from idle hooks
+//   - UART: writes through serialTx that found the TX buffer too full (the
+//     background writers; loop()'s plain console prints aren't counted)
+//
+// The idle hooks keep the idle task spinning instead of waiting for an
+// interrupt, which costs power and defeats light sleep, so load sampling is
+// switched off while the event loop is saving power.
+
+class ResourceMonitor {
+public:
+    static const int MAX_TASKS = 8;
+    
+    struct TaskWatch {
+        const char* name;
+        TaskHandle_t handle;
+        uint32_t stackFree;         // High-water mark in bytes (lowest seen free)
+    };
+    
+    bool begin(uint32_t periodMs = 1000);
+    
+    // Hook/unhook the idle-time measurement; idle % reads -1 while off
+    bool setLoadSampling(bool on);
+    bool isLoadSampling();
+    
+    // Track a task's stack; the loop, IDLE and esp_timer tasks are added by begin()
+    bool watchTask(const char* name, TaskHandle_t handle);
+    
+    void update();
+    
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getLargestBlock();
+    int getFragmentation();             // % of free heap not in the largest block
+    int32_t getHeapDriftPerHour();      // Bytes/hour, negative = leaking
+    float getIdlePercent(int core);
+    uint32_t getMinStackFree(const char** taskName = nullptr);
+    uint32_t getTxStalls();             // serialTx writers only, not console prints
+    
+    void printReport();
+    
+private:
+    uint32_t periodMs = 1000;
+    uint32_t lastSampleMs = 0;
+    uint32_t lastSampleUs = 0;
+    bool running = false;
+    bool loadSampling = false;
+    
+    TaskWatch tasks[MAX_TASKS];
+    int taskCount = 0;
+    
+    uint32_t freeHeap = 0;
+    uint32_t minFreeHeap = 0;
+    uint32_t largestBlock = 0;
+    uint32_t baselineHeap = 0;      // Free heap once boot has settled
+    uint32_t baselineMs = 0;
+    
+    // Idle hooks, one per core: busy gaps between consecutive calls are
+    // excluded, so only time actually spent in the idle task is counted
+    static volatile uint32_t idleUs[2];
+    static volatile uint32_t lastIdleCallUs[2];
+    static bool idleHook0();
+    static bool idleHook1();
+    static void accountIdle(int core);
+    
+    uint32_t lastIdleUs[2] = { 0, 0 };
+    float idlePercent[2] = { 0, 0 };
+    
+    void sample();
+};
+
+extern ResourceMonitor resourceMonitor;
+
+#endif
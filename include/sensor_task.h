@@ -0,0 +1,79 @@
+#ifndef SENSOR_TASK_H
+#define SENSOR_TASK_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "sensors.h"
+#include "spsc_queue.h"
+
+// ============================================================================
+// SENSOR TASK - sensing on core 0, control on core 1
+// ============================================================================
+// The Arduino loop() (behaviors, Movement, StatusLED) runs on core 1. This task
+// is pinned to core 0 and owns all blocking capture: ultrasonic pings and ADC
+// sampling. Raw samples cross to the control side through a lock-free SPSC
+// ring; the control side drains it and runs the cheap filters. A slow echo on
+// core 0 can no longer stretch the control period on core 1.
+
+struct SensorSample {
+    uint32_t seq;           // Monotonic sample number (gaps = drops)
+    uint32_t captureUs;     // micros() at ping trigger
+    int16_t distanceCm;     // Single ping, already clamped (400 = no echo)
+    uint16_t ldrLeft;       // Raw ADC 0-4095
+    uint16_t ldrRight;
+    uint16_t batteryRaw;
+};
+
+class SensorTask {
+public:
+    SensorTask(HAL& halRef, UltrasonicSensor& sensRef, LDRSensor& ldrRef);
+    
+    bool begin(int core = 0, uint32_t periodMs = 40);
+    bool isRunning();
+    
+    // Control side (single consumer): feed queued samples into the filters.
+    // Called from UltrasonicSensor/LDRSensor::update() once attached.
+    void drain();
+    
+    void setPeriod(uint32_t periodMs);
+    uint32_t getPeriod();
+    
+    // Exported counters
+    uint32_t getProduced();
+    uint32_t getConsumed();
+    uint32_t getDropped();
+    uint32_t getDepth();
+    uint32_t getMaxDepth();
+    uint32_t getLastCaptureTimeUs();    // How long one capture cycle took
+    TaskHandle_t getHandle();
+    
+    float getBatteryVoltage();          // From the latest drained sample
+    int getBatteryRaw();
+    
+    void printStatus();
+    
+private:
+    HAL& hal;
+    UltrasonicSensor& sensor;
+    LDRSensor& ldrSensor;
+    
+    SpscQueue<SensorSample, 16> queue;
+    TaskHandle_t handle = nullptr;
+    volatile uint32_t periodMs = 40;
+    int deadlineId = -1;
+    
+    // Producer-owned counters (single writer, read-only on core 1)
+    volatile uint32_t produced = 0;
+    volatile uint32_t dropped = 0;
+    volatile uint32_t captureTimeUs = 0;
+    
+    // Consumer-owned
+    uint32_t consumed = 0;
+    uint32_t maxDepth = 0;
+    uint16_t lastBatteryRaw = 0;
+    
+    static void taskEntry(void* arg);
+    void run();
+};
+
+#endif
@@ -2,13 +2,26 @@
 #define SENSORS_H
 #include "hal.h"
 #include "config.h"  // NEW - for ADC calibration values
+#include "trace.h"
+
+class SensorTask;   // Optional core-0 capture feed (sensor_task.h)
+
+struct RangeThresholds {
+    int stopDistance = 20;      // Stop if closer than this (cm)
+    int warnDistance = 40;      // Slow down if closer than this (cm)
+};
 
 class UltrasonicSensor {
 public:
     UltrasonicSensor(HAL& halRef);
     
     void update();              // Call in loop - updates readings
+    void ingest(int cm);        // Feed one captured reading through the filter
+    void ingest(int cm, const SampleTag& tag);
+    void attachFeed(SensorTask* feedRef);   // Take readings from the sensor task instead of pinging
     int getDistance();          // Get filtered distance
+    int getRawDistance();       // Latest unfiltered reading (no median lag)
+    SampleTag getSampleTag();   // Sample that last moved the filtered distance
     bool obstacleDetected();    // Is obstacle within stop distance?
     bool obstacleFar();         // Is obstacle in warning zone?
     bool isStuck();             // Stuck detection (distance unchanging)
@@ -16,19 +29,26 @@ public:
     // Configuration
     void setStopDistance(int cm);
     void setWarnDistance(int cm);
+    int getStopDistance();
+    int getWarnDistance();
+    RangeThresholds& getThresholds();
+    uint32_t getPingCount();    // Readings ingested since boot (either path)
     
 private:
     HAL& hal;
+    SensorTask* feed = nullptr;
     
     // Distance thresholds
-    int stopDistance = 20;      // Stop if closer than this (cm)
-    int warnDistance = 40;      // Slow down if closer than this (cm)
+    RangeThresholds thresholds;
+    uint32_t pings = 0;
     
     // Filtering
     static const int FILTER_SIZE = 5;
     int readings[FILTER_SIZE];
     int readIndex = 0;
     int filteredDistance = 400;
+    SampleTag filteredTag;
+    uint32_t inlineSeq = 0;     // Sequence for readings taken without the sensor task
     
     // Stuck detection thresholds
     static const int STUCK_DISTANCE_THRESHOLD = 15;    // Must be closer than 15cm
@@ -51,12 +71,16 @@ public:
     LDRSensor(HAL& halRef);
     
     void update();                  // Call in loop - updates readings
+    void ingest(int rawLeft, int rawRight);     // Feed one raw ADC pair through the filter
+    void attachFeed(SensorTask* feedRef);
     float getLeftBrightness();      // Get filtered left brightness (0.0-1.0)
     float getRightBrightness();     // Get filtered right brightness (0.0-1.0)
     float getBrightnessDifference(); // Get L-R difference (positive = left brighter)
+    float getInstantBrightness();   // Latest unfiltered L/R average (no filter lag, for scans)
     
 private:
     HAL& hal;
+    SensorTask* feed = nullptr;
     
     // Filtering (simple moving average)
     static const int FILTER_SIZE = 5;
@@ -67,6 +91,7 @@ private:
     // Filtered values
     float leftBrightness = 0.0f;
     float rightBrightness = 0.0f;
+    float instantBrightness = 0.0f;
     
     // Helper functions
     float getAverageBrightness(float readings[]);
@@ -0,0 +1,47 @@
+#ifndef SERIAL_TX_H
+#define SERIAL_TX_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/semphr.h>
+
+// ============================================================================
+// SERIAL TX - the one path to the UART for every writer that isn't loop()
+// ============================================================================
+// Telemetry lines and link frames are dropped rather than block the loop, so
+// they check the free TX space first. A check and a write are only as good as
+// nothing else writing in between: the log task and the link run on core 0.
+// Every such writer goes through here; a mutex makes "room for all of it,
+// then write it" one step. tryWrite() writes all or nothing and never waits,
+// not even for the lock (a busy port counts as full). write() blocks.
+// Console text printed from loop() runs on the same task as the droppable
+// writers, so it can't slip between their check and their write.
+// A stall is counted whenever a write finds less room than it needs: a
+// dropped tryWrite(), or a write() about to block. Only writes through here
+// are seen: loop()'s own Serial.print() console output (command replies,
+// status reports) goes straight to the UART, so when that blocks on a full
+// buffer the counter doesn't move. It measures the background writers
+// (telemetry, link, log task, recorder dump), not the console.
+
+class SerialTx {
+public:
+    void begin();       // After Serial.begin(); until then writes go out unlocked
+
+    bool tryWrite(const uint8_t* data, size_t len);
+    size_t write(const uint8_t* data, size_t len);
+
+    uint32_t getStalls() { return stalls.load(std::memory_order_relaxed); }
+    int getMinFree() { return minFree; }    // Least room seen by a write; -1 before any
+
+private:
+    StaticSemaphore_t mutexStorage;
+    SemaphoreHandle_t mutex = nullptr;
+    std::atomic<uint32_t> stalls{0};
+    volatile int minFree = -1;
+
+    bool room(size_t len);
+};
+
+extern SerialTx serialTx;
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stdint.h>
+
+// ============================================================================
+// LOCK-FREE SINGLE-PRODUCER / SINGLE-CONSUMER RING BUFFER
+// ============================================================================
+// One task pushes, one task pops, no mutex and no critical section. The head
+// index is only written by the producer and the tail only by the consumer;
+// acquire/release ordering publishes the slot contents across cores.
+// N must be a power of two. A full queue rejects the push (the producer counts
+// the drop) rather than overwriting data the consumer may be reading.
+
+template <typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+    
+public:
+    bool push(const T& item) {
+        uint32_t head = headIndex.load(std::memory_order_relaxed);
+        uint32_t tail = tailIndex.load(std::memory_order_acquire);
+        if (head - tail >= N) {
+            return false;   // Full
+        }
+        slots[head & (N - 1)] = item;
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(T& item) {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        uint32_t head = headIndex.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;   // Empty
+        }
+        item = slots[tail & (N - 1)];
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Snapshot only - may be stale by the time the caller looks at it
+    uint32_t depth() const {
+        return headIndex.load(std::memory_order_acquire) - tailIndex.load(std::memory_order_acquire);
+    }
+    
+    static constexpr uint32_t capacity() { return N; }
+    
+private:
+    T slots[N];
+    std::atomic<uint32_t> headIndex{0};   // Next slot to write (producer-owned)
+    std::atomic<uint32_t> tailIndex{0};   // Next slot to read (consumer-owned)
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef STUCK_DETECTOR_H
+#define STUCK_DETECTOR_H
+
+#include "hal.h"
+#include "movement.h"
+#include "odometry.h"
+#include "sensors.h"
+#include "sensor_task.h"
+
+// ============================================================================
+// MULTI-SIGNAL STUCK DETECTOR
+// ============================================================================
+// UltrasonicSensor::isStuck() only fires when wedged under 15cm for 3s. This
+// fuses independent evidence that the wheels are commanded but the robot is
+// not going anywhere:
+//   - Range rate: odometry says we should be closing/opening on the echo, but
+//     the ultrasonic reading doesn't move (works at any range, not just <15cm)
+//   - Battery sag: stalled motors pull more current than the duty predicts
+//   - LDR stasis: a moving robot sees light flicker; a wedged one doesn't
+// Each signal gives evidence 0-1 (or abstains); the weighted mean is low-pass
+// filtered into a confidence whose rise time is the configured latency target.
+
+class StuckDetector {
+public:
+    StuckDetector(HAL& halRef, Movement& movRef, Odometry& odoRef,
+                  UltrasonicSensor& sensRef, LDRSensor& ldrRef, SensorTask& taskRef);
+    
+    void update();                  // Call in loop after sensors and odometry
+    void reset();                   // Clear confidence (e.g. after an escape)
+    
+    bool isStuck();                 // Confidence above threshold
+    float getConfidence();          // 0-1
+    
+    void setLatencyTarget(unsigned long ms);    // Time for sustained evidence to trip
+    void setThreshold(float confidence);
+    unsigned long getLatencyTarget();
+    
+    void printStatus();
+    
+private:
+    HAL& hal;
+    Movement& movement;
+    Odometry& odometry;
+    UltrasonicSensor& sensor;
+    LDRSensor& ldrSensor;
+    SensorTask& sensorTask;
+    
+    unsigned long latencyTarget = 500;  // ms
+    float threshold = 0.7f;
+    float confidence = 0.0f;
+    unsigned long lastUpdate = 0;
+    
+    // Evidence from the last update (-1 = signal abstained)
+    float rangeEvidence = -1.0f;
+    float sagEvidence = -1.0f;
+    float stasisEvidence = -1.0f;
+    
+    // Range-rate state
+    int lastRange = 0;
+    float expectedTravel = 0.0f;        // cm the odometry says we covered since lastRange
+    unsigned long rangeWindowStart = 0;
+    
+    // Battery sag state
+    float restVoltage = 0.0f;           // EWMA with motors stopped
+    float sagPerDuty = 0.0f;            // Learned EWMA of sag / duty while moving freely
+    
+    // LDR stasis state
+    static const int LDR_WINDOW = 8;
+    float ldrWindow[LDR_WINDOW];
+    int ldrIndex = 0;
+    int ldrFilled = 0;
+    
+    static constexpr float RANGE_WEIGHT = 0.5f;
+    static constexpr float SAG_WEIGHT = 0.3f;
+    static constexpr float STASIS_WEIGHT = 0.2f;
+    static constexpr float MIN_EXPECTED_TRAVEL = 4.0f;  // cm before judging range rate
+    static const int MAX_TRUSTED_RANGE = 200;           // Echo beyond this is unreliable
+    static constexpr float STALL_SAG_RATIO = 1.8f;      // Sag this far above learned = stall
+    static constexpr float STASIS_SPREAD = 0.004f;      // Brightness spread below this = frozen
+    
+    float evaluateRange(bool driving);
+    float evaluateSag(float duty);
+    float evaluateStasis(bool driving);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <Arduino.h>
+#include "sensors.h"
+#include "movement.h"
+#include "battery_estimator.h"
+#include "power_manager.h"
+#include "energy_model.h"
+
+// ============================================================================
+// TELEMETRY STREAM - rate-controlled text stats line
+// ============================================================================
+// One line per period, fields separated by " | ":
+//
+//   Light: 0.512 | Energy: 73.2 | Alive: 342s | Status: ALIVE | Dist: 42cm ...
+//
+// The first four fields are the format tools/serial_logger.py parses. The
+// line is built with integer formatting into a static buffer and written
+// (through serialTx) only if the UART TX buffer has room for all of it;
+// otherwise the record is dropped and counted, and the stream halves its
+// rate (decimation) until writes succeed again. A busy console link therefore
+// costs records, never loop time, and streaming cannot change what the robot
+// does.
+
+class TelemetryStream {
+public:
+    enum Field : uint16_t {
+        FIELD_LIGHT     = 1 << 0,   // Mean LDR brightness 0-1
+        FIELD_ENERGY    = 1 << 1,   // Simulated energy, % (energy_model.h)
+        FIELD_ALIVE     = 1 << 2,   // Seconds alive since the last revive
+        FIELD_STATUS    = 1 << 3,   // ALIVE / DEAD
+        FIELD_DISTANCE  = 1 << 4,   // Filtered ultrasonic, cm
+        FIELD_MOTORS    = 1 << 5,   // Effective signed PWM A/B
+        FIELD_BATTERY   = 1 << 6,   // Volts and SoC
+        FIELD_POWER     = 1 << 7,   // PowerManager mode
+        FIELD_RESOURCES = 1 << 8,   // Heap, CPU idle, stack, TX stalls (serialTx writers only)
+        FIELD_RESETS    = 1 << 9,   // Last reset cause, brownout and crash counts
+        FIELD_COUNT     = 10,
+
+        FIELDS_LOGGER   = FIELD_LIGHT | FIELD_ENERGY | FIELD_ALIVE | FIELD_STATUS,
+        FIELDS_ALL      = (1 << FIELD_COUNT) - 1,
+    };
+
+    static const int MIN_RATE_HZ = 1;
+    static const int MAX_RATE_HZ = 100;
+
+    TelemetryStream(LDRSensor& ldrRef, UltrasonicSensor& sonarRef, Movement& moveRef,
+                    BatteryEstimator& batteryRef, PowerManager& powerRef, EnergyModel& energyRef);
+
+    void update();                  // Call every loop pass
+    uint32_t msUntilDue();          // For the loop's wait; UINT32_MAX when off
+
+    void setEnabled(bool on);
+    bool isEnabled();
+    bool setRate(int hz);           // False if outside 1-100 Hz
+    int getRate();
+    void setFields(uint16_t mask);
+    uint16_t getFields();
+    void enableField(Field field, bool on);
+
+    // "light,energy,dist", "all" or "logger"; false on an unknown name
+    bool parseFields(const char* list, uint16_t& mask);
+
+    uint32_t getEmitted() { return emitted; }
+    uint32_t getDropped() { return dropped; }
+
+    void printStatus();
+
+private:
+    LDRSensor& ldr;
+    UltrasonicSensor& sonar;
+    Movement& movement;
+    BatteryEstimator& battery;
+    PowerManager& power;
+    EnergyModel& energy;
+
+    bool enabled = false;
+    int rateHz = 1;
+    uint16_t fields = FIELDS_LOGGER;
+    unsigned long nextDueMs = 0;
+
+    // Backoff while the TX buffer is full: emit every Nth period
+    uint8_t decimation = 1;
+    uint8_t skip = 0;
+    uint16_t cleanWrites = 0;
+
+    uint32_t emitted = 0;
+    uint32_t dropped = 0;
+    uint32_t decimated = 0;
+
+    static const size_t LINE_SIZE = 256;
+    char line[LINE_SIZE];
+    size_t length = 0;
+
+    size_t format();
+    void append(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern const char* const TELEMETRY_FIELD_NAMES[TelemetryStream::FIELD_COUNT];
+
+#endif
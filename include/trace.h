@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include "histogram.h"
+
+// ============================================================================
+// SENSE-TO-ACTUATE LATENCY TRACING
+// ============================================================================
+// Every ultrasonic sample carries a tag (sequence number + capture time) from
+// capture through UltrasonicSensor's filter. When a behavior reacts to a
+// sample it arms the tracer with that tag; the next motor command that
+// actually changes the output closes the trace. HAL stamps each motor command
+// with the sequence of the sample that caused it.
+//
+// Stages reported (all measured from the capture timestamp):
+//   queue   - capture -> sample reaches the filter on the control core
+//   decide  - capture -> behavior acts on it
+//   react   - capture -> motor output changes
+
+struct SampleTag {
+    uint32_t seq = 0;
+    uint32_t captureUs = 0;
+    uint32_t ingestUs = 0;
+};
+
+class LatencyTracer {
+public:
+    static const uint32_t NO_CAUSE = 0xFFFFFFFF;
+    
+    void arm(const SampleTag& cause);       // Behavior is reacting to this sample
+    
+    // HAL hook: the sample sequence responsible for this command - only on
+    // the command that closes an armed trace (both wheels), else NO_CAUSE
+    uint32_t onMotorCommand(int motor, int speed, bool forward);
+    
+    void reset();
+    void printReport();
+    
+private:
+    bool armed = false;
+    SampleTag pending;
+    uint32_t lastCauseSeq = NO_CAUSE;
+    
+    int lastSpeed[2] = {0, 0};
+    bool lastForward[2] = {true, true};
+    int pairedMotor = -1;           // 1 while B's half of the closing command is due, else -1
+    
+    uint32_t traces = 0;
+    uint32_t lastReactUs = 0;
+    LogHistogram<2> queueLatency;
+    LogHistogram<2> decideLatency;
+    LogHistogram<2> reactLatency;
+};
+
+extern LatencyTracer latencyTracer;
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TRANSITION_LOG_H
+#define TRANSITION_LOG_H
+
+#include <Arduino.h>
+#include "histogram.h"
+
+// ============================================================================
+// BEHAVIOR STATE TRANSITION LOG
+// ============================================================================
+// Every behavior state change is recorded as a 10-byte binary record in a RAM
+// ring buffer: time, behavior id, from/to state and the sensor value that
+// triggered it. Alongside, each (behavior, state) keeps an entry count, total
+// dwell time and a dwell-time histogram, so we can see e.g. how much of an
+// hour goes to BACKING_UP or STUCK_ESCAPE instead of earning fitness.
+
+namespace BehaviorId {
+    enum : uint8_t {
+        AVOIDANCE,
+        PHOTOTROPISM,
+        NAVIGATOR,
+        COUNT
+    };
+}
+
+struct __attribute__((packed)) TransitionRecord {
+    uint32_t timeMs;
+    uint8_t behavior;
+    uint8_t from;
+    uint8_t to;
+    uint8_t reserved;
+    int16_t trigger;        // Distance in cm, or brightness x1000
+};
+
+class TransitionLog {
+public:
+    static const int CAPACITY = 256;
+    static const int MAX_STATES = 8;
+    
+    // Names are for reports only; call once from setup()
+    void describe(uint8_t behavior, const char* name, const char* const* stateNames, int stateCount);
+    
+    void record(uint8_t behavior, uint8_t from, uint8_t to, int16_t trigger);
+    
+    uint32_t getTotal();
+    bool getRecord(uint32_t index, TransitionRecord& out);  // 0 = oldest still held
+    uint32_t getDwellMs(uint8_t behavior, uint8_t state);   // Including time in the current state
+    uint32_t getEntries(uint8_t behavior, uint8_t state);
+    
+    // Names given to describe(), "?" when unknown
+    const char* behaviorName(uint8_t behavior);
+    const char* stateName(uint8_t behavior, uint8_t state);
+    
+    void printRecent(int count);
+    void printDwell();
+    void reset();
+    
+private:
+    TransitionRecord ring[CAPACITY];
+    uint32_t total = 0;     // Records ever written; ring index = total % CAPACITY
+    
+    struct StateStats {
+        uint32_t entries;
+        uint32_t dwellMs;
+        LogHistogram<0> dwell;
+    };
+    
+    struct BehaviorInfo {
+        const char* name;
+        const char* const* stateNames;
+        int stateCount;
+        uint8_t current;
+        uint32_t enteredMs;
+        StateStats states[MAX_STATES];
+    } behaviors[BehaviorId::COUNT];
+    
+    uint32_t statsSinceMs = 0;
+};
+
+extern TransitionLog transitionLog;
+
+#endif
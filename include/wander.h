@@ -0,0 +1,99 @@
+#ifndef WANDER_H
+#define WANDER_H
+
+#include "movement.h"
+#include "odometry.h"
+
+// ============================================================================
+// WANDER - coverage-oriented random walk
+// ============================================================================
+// Runs as a sequence of steps: turn by a random angle, then drive a random
+// distance holding that heading. Two strategies:
+//   CORRELATED_WALK - fixed step length, turn angle ~ N(0, turnSigma)
+//   LEVY_FLIGHT     - power-law step length (exponent levyMu), so mostly
+//                     short hops with occasional long runs across the arena
+// `persistence` (0-1) shrinks every turn toward the current heading. The
+// generator is seeded, so the same seed replays the same walk.
+
+struct WanderParams {
+    enum Strategy { CORRELATED_WALK, LEVY_FLIGHT };
+    
+    Strategy strategy = LEVY_FLIGHT;
+    int speed = 150;                // PWM while running a step
+    float persistence = 0.3f;       // 0 = uniform new heading, 1 = never turn
+    float turnSigma = 60.0f;        // Degrees, correlated walk turn spread
+    float levyMu = 2.0f;            // Power-law exponent, 1 < mu <= 3
+    float minStepCm = 15.0f;        // Correlated walk uses this as its fixed step
+    float maxStepCm = 300.0f;
+    uint32_t seed = 0x454D4252;     // "EMBR"
+};
+
+class Wander {
+public:
+    Wander(Movement& movRef, Odometry& odoRef);
+    
+    void setParams(const WanderParams& p);   // Also reseeds
+    WanderParams& getParams();
+    void seed(uint32_t s);
+    
+    void update(int speedLimit = 255);  // Call each tick while wandering
+    void interrupt();                   // Something else drove; plan a fresh step next tick
+    
+    int getStepCount();
+    
+private:
+    Movement& movement;
+    Odometry& odometry;
+    WanderParams params;
+    
+    enum Phase { PLAN, TURN, RUN };
+    Phase phase = PLAN;
+    float targetHeading = 0.0f;
+    float stepLength = 0.0f;
+    float stepStartDistance = 0.0f;
+    unsigned long phaseStartTime = 0;
+    int stepCount = 0;
+    
+    uint32_t rngState = 1;
+    
+    static constexpr float HEADING_TOLERANCE = 8.0f;    // Degrees
+    static constexpr float HOLD_GAIN = 2.0f;            // PWM per degree of heading error
+    
+    void planStep();
+    uint32_t nextRandom();
+    float uniform();                // [0, 1)
+    float gaussian();               // N(0, 1)
+};
+
+// ============================================================================
+// COVERAGE MAP - area-coverage benchmark from odometry
+// ============================================================================
+// A 3m x 3m occupancy grid of 15cm cells centred on where the benchmark was
+// started. Reports the area visited and the coverage rate per minute.
+
+class CoverageMap {
+public:
+    CoverageMap(Odometry& odoRef);
+    
+    void start();               // Clear and centre on the current pose
+    void update();              // Call in loop
+    
+    int getCellsVisited();
+    float getAreaM2();
+    float getAreaPerMinute();   // m²/min since start()
+    void printReport();
+    
+private:
+    Odometry& odometry;
+    
+    static const int GRID = 20;
+    static constexpr float CELL_CM = 15.0f;
+    
+    uint32_t visited[(GRID * GRID + 31) / 32];
+    int cellsVisited = 0;
+    float originX = 0.0f;
+    float originY = 0.0f;
+    unsigned long startTime = 0;
+};
+
+#endif
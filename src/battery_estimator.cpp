@@ -0,0 +1,266 @@
+#include "battery_estimator.h"
+
+// Current model: ESP32 + sensors + LED, and a small gear motor at full duty
+static const float IDLE_CURRENT_A = 0.12f;
+static const float MOTOR_FULL_DUTY_A = 0.6f;       // Per motor
+
+static const float DEFAULT_R_INTERNAL = 0.25f;     // 2S pack plus wiring (ohms)
+static const float R_MIN = 0.02f;
+static const float R_MAX = 2.0f;
+static const float R_LEARN_RATE = 0.2f;
+
+// A duty change this large is a usable resistance measurement
+static const float STEP_MIN_A = 0.15f;
+static const float STEP_HOLD_A = 0.05f;            // Load must then stay put
+static const unsigned long STEP_SETTLE_MS = 120;   // Skip motor inrush
+static const unsigned long STEP_WINDOW_MS = 320;
+
+static const float NO_BATTERY_V = 3.0f;
+static const int ADC_FULL_SCALE = 4095;
+static const unsigned long INLINE_PERIOD_MS = 40;
+
+// Kalman tuning (percent^2): coulomb-count drift per second, and the noise of
+// one OCV-derived SoC reading (25 per second, so corrections act over ~2 min)
+static const float PROCESS_NOISE = 0.01f;
+static const float OCV_NOISE_IDLE = 5000.0f;
+static const float SATURATED_VARIANCE = 900.0f;    // 30% sigma on an assumed-full start
+static const float AVG_CURRENT_TAU_S = 120.0f;
+
+// Resting voltage per cell vs. charge, LiPo
+static const float OCV_TABLE[][2] = {
+    { 3.27f, 0 },  { 3.61f, 5 },  { 3.69f, 10 }, { 3.71f, 15 }, { 3.73f, 20 },
+    { 3.75f, 25 }, { 3.77f, 30 }, { 3.79f, 35 }, { 3.80f, 40 }, { 3.82f, 45 },
+    { 3.84f, 50 }, { 3.85f, 55 }, { 3.87f, 60 }, { 3.91f, 65 }, { 3.95f, 70 },
+    { 3.98f, 75 }, { 4.02f, 80 }, { 4.08f, 85 }, { 4.11f, 90 }, { 4.15f, 95 },
+    { 4.20f, 100 }
+};
+static const int OCV_POINTS = sizeof(OCV_TABLE) / sizeof(OCV_TABLE[0]);
+static const int CELLS = 2;
+
+BatteryEstimator::BatteryEstimator(HAL& halRef, Movement& moveRef, SensorTask& taskRef)
+    : hal(halRef), movement(moveRef), sensorTask(taskRef), resistance(DEFAULT_R_INTERNAL) {
+}
+
+float BatteryEstimator::modelCurrent() {
+    float duty = (abs(movement.getWheelSpeedA()) + abs(movement.getWheelSpeedB())) / 255.0f;
+    return IDLE_CURRENT_A + duty * MOTOR_FULL_DUTY_A;
+}
+
+float BatteryEstimator::ocvToSoc(float packVolts) {
+    float cell = packVolts / CELLS;
+    if (cell <= OCV_TABLE[0][0]) return 0;
+    if (cell >= OCV_TABLE[OCV_POINTS - 1][0]) return 100;
+    for (int i = 1; i < OCV_POINTS; i++) {
+        if (cell < OCV_TABLE[i][0]) {
+            float t = (cell - OCV_TABLE[i - 1][0]) / (OCV_TABLE[i][0] - OCV_TABLE[i - 1][0]);
+            return OCV_TABLE[i - 1][1] + t * (OCV_TABLE[i][1] - OCV_TABLE[i - 1][1]);
+        }
+    }
+    return 100;
+}
+
+// ============================================================================
+// UPDATE (once per battery sample)
+// ============================================================================
+
+void BatteryEstimator::update() {
+    unsigned long now = millis();
+    int raw;
+    if (sensorTask.isRunning()) {
+        uint32_t consumed = sensorTask.getConsumed();
+        if (consumed == lastConsumed) return;
+        lastConsumed = consumed;
+        raw = sensorTask.getBatteryRaw();
+    } else {
+        if (now - lastUpdateMs < INLINE_PERIOD_MS) return;
+        raw = hal.readBatteryRaw();
+    }
+    
+    float dt = lastUpdateMs == 0 ? 0 : (now - lastUpdateMs) / 1000.0f;
+    lastUpdateMs = now;
+    
+    voltage = HAL::batteryRawToVoltage(raw);
+    current = modelCurrent();
+    battery = voltage >= NO_BATTERY_V;
+    saturated = raw >= ADC_FULL_SCALE;
+    if (!battery) {
+        ready = false;
+        lastCurrent = current;
+        return;
+    }
+    
+    // Coulomb-count proxy: the previous load held for dt (A * s -> mAh)
+    chargeUsedMah += lastCurrent * dt / 3.6f;
+    float alpha = dt / (AVG_CURRENT_TAU_S + dt);
+    avgCurrent = avgCurrent == 0 ? current : avgCurrent + alpha * (current - avgCurrent);
+    
+    if (!saturated) learnResistance(now);
+    
+    float sample = voltage + current * resistance;
+    ocv = ocv == 0 ? sample : ocv + 0.1f * (sample - ocv);
+    
+    fuse(dt);
+    lastCurrent = current;
+}
+
+void BatteryEstimator::learnResistance(unsigned long now) {
+    if (!stepActive) {
+        if (fabs(current - lastCurrent) >= STEP_MIN_A && preStepV > 0) {
+            stepActive = true;
+            stepStart = now;
+            stepFromI = lastCurrent;
+            stepToI = current;
+            stepPreV = preStepV;
+            postSum = 0;
+            postCount = 0;
+        } else {
+            preStepV = preStepV == 0 ? voltage : preStepV + 0.3f * (voltage - preStepV);
+        }
+        return;
+    }
+    
+    if (fabs(current - stepToI) > STEP_HOLD_A) {
+        // Load moved again before the voltage settled: discard
+        stepActive = false;
+        preStepV = voltage;
+        return;
+    }
+    
+    unsigned long held = now - stepStart;
+    if (held < STEP_SETTLE_MS) return;
+    if (held <= STEP_WINDOW_MS) {
+        postSum += voltage;
+        postCount++;
+        return;
+    }
+    
+    stepActive = false;
+    if (postCount < 2) return;
+    float postV = postSum / postCount;
+    preStepV = postV;
+    
+    float r = (stepPreV - postV) / (stepToI - stepFromI);
+    if (r >= R_MIN && r <= R_MAX) {
+        resistance = resistanceSamples == 0 ? r : resistance + R_LEARN_RATE * (r - resistance);
+        resistanceSamples++;
+    }
+}
+
+void BatteryEstimator::fuse(float dt) {
+    float socFromVoltage = ocvToSoc(ocv);
+    
+    if (!ready) {
+        // Start from the voltage curve; a reading pinned at full scale says
+        // nothing about the pack, so assume full and let the curve pull it
+        // down once the ADC is back in range
+        soc = saturated ? 100.0f : socFromVoltage;
+        socVariance = saturated ? SATURATED_VARIANCE : 25.0f;
+        ready = true;
+        return;
+    }
+    
+    // Predict: charge drawn since the last sample
+    soc -= lastCurrent * dt / 3.6f / capacityMah * 100.0f;
+    socVariance += PROCESS_NOISE * dt;
+    
+    // Correct: the voltage curve, trusted less while the motors load the pack.
+    // Nothing to correct from while the reading is pinned at full scale.
+    if (!saturated) {
+        float motorShare = (current - IDLE_CURRENT_A) / (2 * MOTOR_FULL_DUTY_A);
+        float noise = OCV_NOISE_IDLE * (1.0f + 4.0f * motorShare);
+        float gain = socVariance / (socVariance + noise);
+        soc += gain * (socFromVoltage - soc);
+        socVariance *= (1.0f - gain);
+    }
+    soc = constrain(soc, 0.0f, 100.0f);
+}
+
+// ============================================================================
+// GETTERS
+// ============================================================================
+
+bool BatteryEstimator::isReady() {
+    return ready && ocv > 0;    // A restored SoC still waits for a first reading
+}
+
+bool BatteryEstimator::hasBattery() {
+    return battery;
+}
+
+bool BatteryEstimator::isSaturated() {
+    return saturated;
+}
+
+float BatteryEstimator::getVoltage() {
+    return voltage;
+}
+
+float BatteryEstimator::getOpenCircuitVoltage() {
+    return ocv;
+}
+
+float BatteryEstimator::getCurrent() {
+    return current;
+}
+
+float BatteryEstimator::getAverageCurrent() {
+    return avgCurrent;
+}
+
+float BatteryEstimator::getInternalResistance() {
+    return resistance;
+}
+
+uint32_t BatteryEstimator::getResistanceSamples() {
+    return resistanceSamples;
+}
+
+float BatteryEstimator::getChargeUsedMah() {
+    return chargeUsedMah;
+}
+
+float BatteryEstimator::getSoc() {
+    return soc;
+}
+
+float BatteryEstimator::getSocUncertainty() {
+    return sqrtf(socVariance);
+}
+
+int BatteryEstimator::getMinutesLeft() {
+    if (!ready || avgCurrent <= 0) return -1;
+    float remainingMah = soc / 100.0f * capacityMah;
+    return (int)(remainingMah / (avgCurrent * 1000.0f) * 60.0f);
+}
+
+void BatteryEstimator::restore(float socPercent, float usedMah) {
+    soc = constrain(socPercent, 0.0f, 100.0f);
+    socVariance = 25.0f;    // The voltage curve re-checks it on the first samples
+    chargeUsedMah = usedMah;
+    ready = true;
+}
+
+void BatteryEstimator::setCapacity(int mAh) {
+    capacityMah = max(mAh, 100);
+}
+
+int BatteryEstimator::getCapacity() {
+    return capacityMah;
+}
+
+void BatteryEstimator::printReport() {
+    Serial.println("\n--- Battery Estimator ---");
+    if (!battery) {
+        Serial.printf("  No battery sensed (%.2fV)\n", voltage);
+        return;
+    }
+    Serial.printf("  SoC: %.0f%% (±%.1f%%), ~%d min left at %.2fA average\n",
+                  soc, getSocUncertainty(), getMinutesLeft(), avgCurrent);
+    Serial.printf("  Voltage: %.2fV measured, %.2fV open-circuit (%.0f%% by curve)%s\n",
+                  voltage, ocv, ocvToSoc(ocv), saturated ? " - ADC saturated" : "");
+    Serial.printf("  Load: %.2fA modeled, %.1f mAh used of %d mAh\n",
+                  current, chargeUsedMah, capacityMah);
+    Serial.printf("  Internal resistance: %.3f ohm (%s, %lu duty steps)\n",
+                  resistance, resistanceSamples ? "learned" : "default",
+                  (unsigned long)resistanceSamples);
+}
@@ -0,0 +1,136 @@
+#include "bearing.h"
+#include "logger.h"
+
+LightBearing::LightBearing(Movement& movRef, LDRSensor& ldrRef, Odometry& odoRef)
+    : movement(movRef), ldrSensor(ldrRef), odometry(odoRef) {
+    for (int i = 0; i < NUM_BINS; i++) {
+        binSum[i] = 0.0f;
+        binCount[i] = 0;
+    }
+}
+
+void LightBearing::startScan(int spinSpeed) {
+    for (int i = 0; i < NUM_BINS; i++) {
+        binSum[i] = 0.0f;
+        binCount[i] = 0;
+    }
+    swept = 0.0f;
+    lastHeading = odometry.getHeading();
+    scanStartTime = millis();
+    scanning = true;
+    
+    recordSample();
+    movement.spinCW(spinSpeed);
+}
+
+bool LightBearing::update() {
+    if (!scanning) return false;
+    
+    float heading = odometry.getHeading();
+    swept += Odometry::wrap180(heading - lastHeading);
+    lastHeading = heading;
+    recordSample();
+    
+    bool fullTurn = swept >= 360.0f;
+    bool timedOut = millis() - scanStartTime > SCAN_TIMEOUT;
+    if (!fullTurn && !timedOut) return false;
+    
+    movement.stop();
+    scanning = false;
+    valid = fitPeak();
+    
+    if (valid) {
+        LOG_INFO("🧭 Light bearing %.0f° (relative %+.0f°), peak %.3f, confidence %.2f",
+                 bearing, getRelativeBearing(), peakBrightness, confidence);
+    } else {
+        LOG_INFO("🧭 Scan inconclusive (swept %.0f°, confidence %.2f)", swept, confidence);
+    }
+    return true;
+}
+
+void LightBearing::cancel() {
+    if (scanning) {
+        movement.stop();
+        scanning = false;
+    }
+}
+
+void LightBearing::recordSample() {
+    int bin = (int)(odometry.getHeading() / BIN_WIDTH) % NUM_BINS;
+    binSum[bin] += ldrSensor.getInstantBrightness();
+    binCount[bin]++;
+}
+
+bool LightBearing::fitPeak() {
+    // Mean brightness per populated bin; the loop rate is slow compared to the
+    // spin, so some bins can be empty and are skipped.
+    float level[NUM_BINS];
+    int peakBin = -1;
+    float total = 0.0f;
+    int populated = 0;
+    for (int i = 0; i < NUM_BINS; i++) {
+        if (binCount[i] == 0) continue;
+        level[i] = binSum[i] / binCount[i];
+        total += level[i];
+        populated++;
+        if (peakBin < 0 || level[i] > level[peakBin]) peakBin = i;
+    }
+    if (populated < 3) {
+        confidence = 0.0f;
+        return false;
+    }
+    
+    float mean = total / populated;
+    peakBrightness = level[peakBin];
+    confidence = (peakBrightness - mean) / (peakBrightness + 0.001f);
+    
+    // Parabolic interpolation across the peak bin and its neighbours
+    float centre = peakBin + 0.5f;
+    int prev = (peakBin + NUM_BINS - 1) % NUM_BINS;
+    int next = (peakBin + 1) % NUM_BINS;
+    if (binCount[prev] > 0 && binCount[next] > 0) {
+        float ym = level[prev];
+        float y0 = level[peakBin];
+        float yp = level[next];
+        float denom = ym - 2.0f * y0 + yp;
+        if (denom < -0.0001f) {
+            centre += constrain(0.5f * (ym - yp) / denom, -0.5f, 0.5f);
+        }
+    }
+    
+    bearing = Odometry::wrap360(centre * BIN_WIDTH);
+    estimateTime = millis();
+    estimateDistance = odometry.getDistance();
+    return confidence >= MIN_CONFIDENCE;
+}
+
+bool LightBearing::isScanning() {
+    return scanning;
+}
+
+bool LightBearing::hasEstimate() {
+    if (!valid) return false;
+    if (millis() - estimateTime > MAX_AGE) return false;
+    if (odometry.getDistance() - estimateDistance > MAX_TRAVEL_CM) return false;
+    return true;
+}
+
+void LightBearing::invalidate() {
+    valid = false;
+}
+
+float LightBearing::getBearing() {
+    return bearing;
+}
+
+float LightBearing::getRelativeBearing() {
+    return Odometry::wrap180(bearing - odometry.getHeading());
+}
+
+float LightBearing::getPeakBrightness() {
+    return peakBrightness;
+}
+
+float LightBearing::getConfidence() {
+    return confidence;
+}
@@ -1,14 +1,28 @@
 #include "behaviors.h"
+#include "logger.h"
+
+const char* const ObstacleAvoidance::STATE_NAMES[] = {
+    "IDLE", "EXPLORING", "OBSTACLE_DETECTED", "BACKING_UP", "TURNING", "STUCK_ESCAPE"
+};
+const char* const Phototropism::STATE_NAMES[] = {
+    "IDLE", "SCANNING", "ALIGNING", "SEEKING", "APPROACHING"
+};
+const char* const LightNavigator::STATE_NAMES[] = {
+    "IDLE", "ACQUIRING", "SEARCHING", "MOTION_TO_GOAL", "BOUNDARY_TURN", "BOUNDARY_ARC", "ARRIVED"
+};
+
 ObstacleAvoidance::ObstacleAvoidance(HAL& halRef, Movement& movRef, 
-                                     UltrasonicSensor& sensRef, StatusLED& statRef,
-                                     MotorConfig& cfg)
-    : hal(halRef), movement(movRef), sensor(sensRef), status(statRef), config(cfg) {
+                                     UltrasonicSensor& sensRef, LDRSensor& ldrRef,
+                                     StatusLED& statRef, MotorConfig& cfg,
+                                     StuckDetector& stuckRef, Wander& wanderRef)
+    : hal(halRef), movement(movRef), sensor(sensRef), ldrSensor(ldrRef), status(statRef), config(cfg),
+      stuckDetector(stuckRef), wander(wanderRef) {
 }
 
 void ObstacleAvoidance::enable() {
     enabled = true;
     setState(EXPLORING);
-    Serial.println("🤖 Autonomous mode ENABLED");
+    LOG_INFO("🤖 Autonomous mode ENABLED");
 }
 
 void ObstacleAvoidance::disable() {
@@ -16,7 +30,7 @@ void ObstacleAvoidance::disable() {
     movement.stop();
     setState(IDLE);
     status.setStatus(StatusLED::READY);
-    Serial.println("⏹ Autonomous mode DISABLED");
+    LOG_INFO("⏹ Autonomous mode DISABLED");
 }
 
 bool ObstacleAvoidance::isEnabled() {
@@ -27,7 +41,17 @@ ObstacleAvoidance::State ObstacleAvoidance::getState() {
     return currentState;
 }
 
+AvoidanceParams& ObstacleAvoidance::getParams() {
+    return params;
+}
+
 void ObstacleAvoidance::setState(State newState) {
+    // Anything other than exploring drives the motors itself, so the wander
+    // step in progress is void when we come back
+    if (newState != EXPLORING) {
+        wander.interrupt();
+    }
+    transitionLog.record(BehaviorId::AVOIDANCE, currentState, newState, sensor.getDistance());
     currentState = newState;
     stateStartTime = millis();
 }
@@ -68,20 +92,23 @@ void ObstacleAvoidance::handleExploring() {
     
     int distance = sensor.getDistance();
     
-    // static unsigned long lastDebug = 0;
-    // if (millis() - lastDebug > 1000) {
-    //     Serial.printf("[DEBUG] Exploring: dist=%d, moving=%s, speed=%d\n", 
-    //                   distance, 
-    //                   movement.isMoving() ? "YES" : "NO",
-    //                   movement.getCurrentSpeed());
-    //     lastDebug = millis();
-    // }
+#if EMBER_LOG_LEVEL >= LOG_LEVEL_DEBUG
+    static unsigned long lastDebug = 0;
+    if (millis() - lastDebug > 1000) {
+        LOG_DEBUG("[DEBUG] Exploring: dist=%d, moving=%s, speed=%d",
+                  distance,
+                  movement.isMoving() ? "YES" : "NO",
+                  movement.getCurrentSpeed());
+        lastDebug = millis();
+    }
+#endif
 
     // --- PRIORITY 0: OBSTACLE AVOIDANCE ---
     // This is the highest priority behavior. If an obstacle is detected,
     // we immediately change state and do not execute any lower-priority behaviors.
     if (sensor.obstacleDetected()) {
-        Serial.printf("🛑 Obstacle detected at %d cm\n", distance);
+        latencyTracer.arm(sensor.getSampleTag());
+        LOG_INFO("🛑 Obstacle detected at %d cm", distance);
         setState(OBSTACLE_DETECTED);
         return;
     }
@@ -89,34 +116,38 @@ void ObstacleAvoidance::handleExploring() {
     // --- PRIORITY 0.5: STUCK DETECTION ---
     // This is also a high-priority safety behavior.
     if (sensor.isStuck()) {
-        Serial.println("⚠ STUCK - can't get away from obstacle!");
+        LOG_WARN("⚠ STUCK - can't get away from obstacle!");
+        setState(STUCK_ESCAPE);
+        return;
+    }
+    // Fused detector catches wedges at any range and spinning wheels in the open
+    if (stuckDetector.isStuck()) {
+        LOG_WARN("⚠ STUCK - wheels driving but going nowhere (confidence %.2f)",
+                 stuckDetector.getConfidence());
         setState(STUCK_ESCAPE);
         return;
     }
     
     // --- PRIORITY 1: PHOTOTROPISM (Light Seeking) ---
     // This behavior only runs if no obstacles are detected.
-    int leftLDR = hal.readLDR_Left();
-    int rightLDR = hal.readLDR_Right();
-    int diff = leftLDR - rightLDR;
-    const int LDR_THRESHOLD = 200; // How much difference is significant
-
-    if (abs(diff) > LDR_THRESHOLD) {
+    // Filtered brightness from the sensor task, scaled back to ADC counts
+    int diff = lroundf(ldrSensor.getBrightnessDifference() * 4095);
+    if (abs(diff) > params.ldrThreshold) {
         // There is a significant light difference. Turn towards it.
         int baseSpeed = config.baseSpeed;
         // The more the difference, the sharper the turn.
-        int turnAmount = map(abs(diff), LDR_THRESHOLD, 4095, 20, baseSpeed);
+        int turnAmount = map(abs(diff), params.ldrThreshold, 4095, 20, baseSpeed);
 
         // diff > 0 means left is brighter, so we pass a negative turn amount to veer left.
         movement.setVeer(baseSpeed, -diff);
     } else {
         // --- PRIORITY 2: EXPLORATION ---
-        // No obstacles and no significant light source. Just explore.
-        // We can still use distance to modulate speed.
+        // No obstacles and no significant light source. Random-walk for
+        // coverage, still using distance to modulate speed.
         if (sensor.obstacleFar()) {
-            movement.crawl();
+            wander.update(config.crawlSpeed);
         } else {
-            movement.smoothForward(config.baseSpeed);
+            wander.update(config.baseSpeed);
         }
     }
 }
@@ -127,7 +158,7 @@ void ObstacleAvoidance::handleObstacleDetected() {
     delay(200);
     
     // Start backing up
-    Serial.println("← Backing up...");
+    LOG_INFO("← Backing up...");
     setState(BACKING_UP);
 }
 
@@ -143,7 +174,7 @@ void ObstacleAvoidance::handleBackingUp() {
         // Alternate turn direction for variety
         turnDirection *= -1;
         
-        Serial.printf("↻ Turning %s...\n", turnDirection > 0 ? "right" : "left");
+        LOG_INFO("↻ Turning %s...", turnDirection > 0 ? "right" : "left");
         setState(TURNING);
     }
 }
@@ -154,7 +185,7 @@ void ObstacleAvoidance::handleTurning() {
     // Only do the scan once when we first enter turning state
     if (millis() - stateStartTime < 100) {
         // Just entered turning state, start the scan
-        Serial.println("🔍 Scanning for clearer path...");
+        LOG_INFO("🔍 Scanning for clearer path...");
         
         // Look left
         movement.spinCCW(config.baseSpeed);
@@ -173,7 +204,7 @@ void ObstacleAvoidance::handleTurning() {
         sensor.update();
         int rightDist = sensor.getDistance();
         
-        Serial.printf("  [SCAN] Left: %d cm, Right: %d cm\n", leftDist, rightDist);
+        LOG_INFO("  [SCAN] Left: %d cm, Right: %d cm", leftDist, rightDist);
         
         // Return to center before final turn
         movement.spinCCW(config.baseSpeed);
@@ -184,10 +215,10 @@ void ObstacleAvoidance::handleTurning() {
         // Decide which way to turn
         if (leftDist > rightDist) {
             turnDirection = -1;
-            Serial.println("  ↺ LEFT is clearer");
+            LOG_INFO("  ↺ LEFT is clearer");
         } else {
             turnDirection = 1;
-            Serial.println("  ↻ RIGHT is clearer");
+            LOG_INFO("  ↻ RIGHT is clearer");
         }
         
         // Reset timer for the actual turn
@@ -217,11 +248,11 @@ void ObstacleAvoidance::handleTurning() {
         int finalDist = sensor.getDistance();
         
         if (finalDist > 50) {
-            Serial.printf("✓ Path clear (%d cm), resuming\n", finalDist);
+            LOG_INFO("✓ Path clear (%d cm), resuming", finalDist);
             setState(EXPLORING);
             movement.smoothForward(config.baseSpeed);
         } else {
-            Serial.printf("⚠ Still blocked (%d cm), turning 90° more\n", finalDist);
+            LOG_WARN("⚠ Still blocked (%d cm), turning 90° more", finalDist);
             // Turn another 90 degrees in same direction
             if (turnDirection > 0) {
                 movement.spinCW(config.baseSpeed);
@@ -236,7 +267,7 @@ void ObstacleAvoidance::handleTurning() {
 
 void ObstacleAvoidance::handleStuckEscape() {
     status.setStatus(StatusLED::ERROR);
-    Serial.println("🆘 Executing stuck escape maneuver...");
+    LOG_WARN("🆘 Executing stuck escape maneuver...");
     
     // Aggressive escape sequence
     movement.backward(config.maxSpeed);
@@ -253,7 +284,8 @@ void ObstacleAvoidance::handleStuckEscape() {
     delay(200);
     
     // Resume exploring
-    Serial.println("✓ Escape complete");
+    stuckDetector.reset();
+    LOG_INFO("✓ Escape complete");
     setState(EXPLORING);
 }
 
@@ -261,21 +293,24 @@ void ObstacleAvoidance::handleStuckEscape() {
 // PHOTOTROPISM BEHAVIOR IMPLEMENTATION (Phase 3B)
 // ============================================================================
 
-Phototropism::Phototropism(HAL& halRef, Movement& movRef, StatusLED& statRef, LDRSensor& ldrRef)
-    : hal(halRef), movement(movRef), status(statRef), ldrSensor(ldrRef) {}
+Phototropism::Phototropism(HAL& halRef, Movement& movRef, StatusLED& statRef, LDRSensor& ldrRef,
+                           Odometry& odoRef, LightBearing& bearingRef)
+    : hal(halRef), movement(movRef), status(statRef), ldrSensor(ldrRef),
+      odometry(odoRef), lightBearing(bearingRef) {}
 
 void Phototropism::enable() {
     enabled = true;
-    currentState = IDLE;
-    Serial.println("🦋 Phototropism mode ENABLED (moth mode)");
+    setState(IDLE);
+    LOG_INFO("🦋 Phototropism mode ENABLED (moth mode)");
 }
 
 void Phototropism::disable() {
     enabled = false;
+    lightBearing.cancel();
     movement.stop();
-    currentState = IDLE;
+    setState(IDLE);
     status.setStatus(StatusLED::READY);
-    Serial.println("🌑 Phototropism mode DISABLED");
+    LOG_INFO("🌑 Phototropism mode DISABLED");
 }
 
 bool Phototropism::isEnabled() {
@@ -286,6 +321,31 @@ Phototropism::State Phototropism::getState() {
     return currentState;
 }
 
+void Phototropism::setController(Controller c) {
+    controller = c;
+    resetSteering();
+    LOG_INFO("🎛 Phototropism controller: %s", c == PROPORTIONAL ? "PI steering" : "bang-bang");
+}
+
+Phototropism::Controller Phototropism::getController() {
+    return controller;
+}
+
+float Phototropism::getLightThreshold() {
+    return params.lightThreshold;
+}
+
+PhototropismParams& Phototropism::getParams() {
+    return params;
+}
+
+void Phototropism::setState(State newState) {
+    float avgBright = (ldrSensor.getLeftBrightness() + ldrSensor.getRightBrightness()) / 2.0f;
+    transitionLog.record(BehaviorId::PHOTOTROPISM, currentState, newState, (int16_t)(avgBright * 1000));
+    currentState = newState;
+    stateStartTime = millis();
+}
+
 void Phototropism::update() {
     if (!enabled) return;
     
@@ -295,44 +355,190 @@ void Phototropism::update() {
     float avgBright = (leftBright + rightBright) / 2.0f;
     float difference = leftBright - rightBright;  // Positive = left brighter
     
+    if (currentState == IDLE) {
+        // Wait for bright light to appear
+        if (avgBright > params.lightThreshold) {
+            LOG_INFO("💡 Light detected! Avg brightness: %.3f", avgBright);
+            resetSteering();
+            startTrial();
+            if (controller == PROPORTIONAL) {
+                acquireBearing();
+            } else {
+                setState(SEEKING);
+            }
+        }
+        return;
+    }
+    
+    // Scanning and aligning deliberately face away from the light, so the
+    // dimming rule only applies once we are steering toward it.
+    if (currentState == SCANNING) {
+        status.setStatus(StatusLED::SEARCHING);
+        if (lightBearing.update()) {
+            if (lightBearing.hasEstimate()) {
+                setState(ALIGNING);
+            } else {
+                resetSteering();
+                setState(SEEKING);
+            }
+        }
+        return;
+    }
+    
+    if (currentState == ALIGNING) {
+        updateAligning();
+        return;
+    }
+    
+    // If light gets dim, go back to idle (same rule for both controllers)
+    if (avgBright < params.lightThreshold * 0.8f) {  // 80% of threshold
+        LOG_INFO("🌑 Light dimmed (%.3f). Stopping.", avgBright);
+        movement.stop();
+        trialActive = false;
+        lightBearing.invalidate();
+        setState(IDLE);
+        return;
+    }
+    
+    updateTrial(avgBright);
+    
+    if (controller == PROPORTIONAL) {
+        updateProportional(leftBright, rightBright, avgBright);
+    } else {
+        updateBangBang(leftBright, rightBright, avgBright, difference);
+    }
+}
+
+// ============================================================================
+// BEARING ACQUISITION
+// ============================================================================
+
+void Phototropism::acquireBearing() {
+    // Reuse a recent estimate carried by dead reckoning; otherwise scan once.
+    if (lightBearing.hasEstimate()) {
+        setState(ALIGNING);
+        return;
+    }
+    LOG_INFO("🔍 Scanning for light bearing...");
+    lightBearing.startScan(params.seekSpeed);
+    setState(SCANNING);
+}
+
+void Phototropism::updateAligning() {
+    status.setStatus(StatusLED::SEARCHING);
+    float relative = lightBearing.getRelativeBearing();
+    
+    if (fabsf(relative) < ALIGN_TOLERANCE || millis() - stateStartTime > ALIGN_TIMEOUT) {
+        // Facing the light (or close enough) - PI steering takes over from here
+        resetSteering();
+        setState(APPROACHING);
+        return;
+    }
+    
+    if (relative > 0) {
+        movement.spinCW(params.seekSpeed);
+    } else {
+        movement.spinCCW(params.seekSpeed);
+    }
+}
+
+// ============================================================================
+// PI STEERING CONTROLLER
+// ============================================================================
+
+float Phototropism::gainSchedule(float avgBright) {
+    // Close to the source the light subtends a wider angle and the normalized
+    // difference swings much harder per degree of heading, so back the gains
+    // off from 1.0 at the dim edge (80% of threshold) to 0.5 at full brightness.
+    float dimEdge = params.lightThreshold * 0.8f;
+    float t = (avgBright - dimEdge) / (1.0f - dimEdge);
+    t = constrain(t, 0.0f, 1.0f);
+    return 1.0f - 0.5f * t;
+}
+
+void Phototropism::resetSteering() {
+    steerIntegral = 0.0f;
+    lastSteerTime = millis();
+}
+
+void Phototropism::updateProportional(float leftBright, float rightBright, float avgBright) {
+    status.setStatus(StatusLED::SEARCHING);  // CYAN LED
+    
+    unsigned long now = millis();
+    float dt = (now - lastSteerTime) / 1000.0f;
+    lastSteerTime = now;
+    if (dt > 0.2f) dt = 0.2f;  // Don't let a long blocking call dump into the integral
+    
+    // Normalized error: independent of overall light level. Positive = left brighter.
+    float error = (leftBright - rightBright) / (leftBright + rightBright + 0.001f);
+    
+    float gain = gainSchedule(avgBright);
+    float kp = STEER_KP * gain;
+    float ki = STEER_KI * gain;
+    
+    float output = kp * error + steerIntegral;
+    bool saturated = (output > 1.0f && error > 0.0f) || (output < -1.0f && error < 0.0f);
+    
+    // Anti-windup: conditional integration plus a hard clamp
+    if (!saturated) {
+        steerIntegral += ki * error * dt;
+        steerIntegral = constrain(steerIntegral, -STEER_I_LIMIT, STEER_I_LIMIT);
+    }
+    output = constrain(kp * error + steerIntegral, -1.0f, 1.0f);
+    
+    // Forward speed falls off with heading error, so a light far off-axis turns
+    // into a pivot and a centered light gets full approach speed. No stops.
+    float forwardScale = 1.0f - min(fabsf(error) / PIVOT_ERROR, 1.0f);
+    int linear = (int)(params.approachSpeed * forwardScale);
+    
+    // Left brighter (positive output) means turn counter-clockwise (negative angular)
+    int angular = (int)(-output * params.seekSpeed);
+    movement.setTwist(linear, angular);
+    
+    // SEEKING/APPROACHING are now just labels on a continuous controller
+    State labelled = (fabsf(error) > SEEK_ERROR) ? SEEKING : APPROACHING;
+    if (labelled != currentState) {
+        setState(labelled);
+    }
+}
+
+// ============================================================================
+// BANG-BANG CONTROLLER (original state machine)
+// ============================================================================
+
+void Phototropism::updateBangBang(float leftBright, float rightBright, float avgBright, float difference) {
     switch (currentState) {
         case IDLE:
-            // Wait for bright light to appear
-            if (avgBright > LIGHT_THRESHOLD) {
-                Serial.printf("💡 Light detected! Avg brightness: %.3f\n", avgBright);
-                currentState = SEEKING;
-                stateStartTime = millis();
-            }
+        case SCANNING:
+        case ALIGNING:
             break;
             
         case SEEKING:
             status.setStatus(StatusLED::SEARCHING);  // CYAN LED
             
             // Turn toward brighter side
-            if (abs(difference) > SEEK_DELTA) {
+            if (abs(difference) > params.seekDelta) {
                 if (difference > 0) {
                     // Left is brighter - spin left (CCW)
-                    Serial.printf("↺ Turning LEFT (L=%.3f > R=%.3f)\n", leftBright, rightBright);
-                    movement.spinCCW(seekSpeed);
+                    LOG_INFO("↺ Turning LEFT (L=%.3f > R=%.3f)", leftBright, rightBright);
+                    movement.spinCCW(params.seekSpeed);
                 } else {
                     // Right is brighter - spin right (CW)
-                    Serial.printf("↻ Turning RIGHT (R=%.3f > L=%.3f)\n", rightBright, leftBright);
-                    movement.spinCW(seekSpeed);
+                    LOG_INFO("↻ Turning RIGHT (R=%.3f > L=%.3f)", rightBright, leftBright);
+                    movement.spinCW(params.seekSpeed);
                 }
-            } else if (abs(difference) < BALANCE_THRESHOLD) {
+            } else if (abs(difference) < params.balanceThreshold) {
                 // Sensors balanced - face light source!
-                Serial.println("🎯 Light centered! Approaching...");
+                LOG_INFO("🎯 Light centered! Approaching...");
                 movement.stop();
                 delay(200);  // Brief pause
-                currentState = APPROACHING;
-                stateStartTime = millis();
+                setState(APPROACHING);
             }
             
             // Timeout if seeking too long (stuck spinning)
             if (millis() - stateStartTime > 5000) {
-                Serial.println("⏱️ Seek timeout - moving forward anyway");
-                currentState = APPROACHING;
-                stateStartTime = millis();
+                LOG_INFO("⏱️ Seek timeout - moving forward anyway");
+                setState(APPROACHING);
             }
             break;
             
@@ -340,22 +546,276 @@ void Phototropism::update() {
             status.setStatus(StatusLED::SEARCHING);  // CYAN LED
             
             // Move toward light
-            movement.forward(approachSpeed);
-            
-            // If light gets dim, go back to idle
-            if (avgBright < LIGHT_THRESHOLD * 0.8f) {  // 80% of threshold
-                Serial.printf("🌑 Light dimmed (%.3f). Stopping.\n", avgBright);
-                movement.stop();
-                currentState = IDLE;
-                stateStartTime = millis();
-            }
+            movement.forward(params.approachSpeed);
             
             // If light becomes unbalanced while approaching, go back to seeking
-            if (abs(difference) > SEEK_DELTA * 1.5f) {  // 50% more sensitive
-                Serial.println("🔄 Light shifted - re-seeking");
-                currentState = SEEKING;
-                stateStartTime = millis();
+            if (abs(difference) > params.seekDelta * 1.5f) {  // 50% more sensitive
+                LOG_INFO("🔄 Light shifted - re-seeking");
+                setState(SEEKING);
             }
             break;
     }
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// TRIAL METRICS
+// ============================================================================
+
+void Phototropism::startTrial() {
+    trialActive = true;
+    trialStartTime = millis();
+    trialStartDistance = odometry.getDistance();
+}
+
+void Phototropism::updateTrial(float avgBright) {
+    if (!trialActive) return;
+    
+    if (avgBright >= ARRIVAL_THRESHOLD) {
+        trialActive = false;
+        LOG_INFO("🏁 Reached light (%s): %lu ms, path %.0f cm",
+                 controller == PROPORTIONAL ? "PI" : "bang-bang",
+                 millis() - trialStartTime, odometry.getDistance() - trialStartDistance);
+    }
+}
+
+// ============================================================================
+// LIGHT NAVIGATOR IMPLEMENTATION (Bug-style light seeking)
+// ============================================================================
+
+LightNavigator::LightNavigator(Movement& movRef, UltrasonicSensor& sensRef, LDRSensor& ldrRef,
+                               StatusLED& statRef, Odometry& odoRef, LightBearing& bearingRef,
+                               MotorConfig& cfg, Wander& wanderRef)
+    : movement(movRef), sensor(sensRef), ldrSensor(ldrRef), status(statRef),
+      odometry(odoRef), lightBearing(bearingRef), config(cfg), wander(wanderRef) {}
+
+void LightNavigator::enable() {
+    enabled = true;
+    runStartTime = millis();
+    runStartDistance = odometry.getDistance();
+    obstacleEncounters = 0;
+    setState(ACQUIRING);
+    LOG_INFO("🧭 Light navigator ENABLED (seek + circumnavigate)");
+}
+
+void LightNavigator::disable() {
+    enabled = false;
+    lightBearing.cancel();
+    movement.stop();
+    setState(IDLE);
+    status.setStatus(StatusLED::READY);
+    LOG_INFO("⏹ Light navigator DISABLED");
+}
+
+bool LightNavigator::isEnabled() {
+    return enabled;
+}
+
+LightNavigator::State LightNavigator::getState() {
+    return currentState;
+}
+
+void LightNavigator::setState(State newState) {
+    if (newState == SEARCHING) {
+        wander.interrupt();
+    }
+    transitionLog.record(BehaviorId::NAVIGATOR, currentState, newState, sensor.getDistance());
+    currentState = newState;
+    stateStartTime = millis();
+}
+
+void LightNavigator::update() {
+    if (!enabled) return;
+    
+    switch (currentState) {
+        case IDLE:
+            break;
+        case ACQUIRING:
+            handleAcquiring();
+            break;
+        case SEARCHING:
+            handleSearching();
+            break;
+        case MOTION_TO_GOAL:
+            handleMotionToGoal();
+            break;
+        case BOUNDARY_TURN:
+            handleBoundaryTurn();
+            break;
+        case BOUNDARY_ARC:
+            handleBoundaryArc();
+            break;
+        case ARRIVED:
+            handleArrived();
+            break;
+    }
+}
+
+float LightNavigator::goalError() {
+    // Steering error toward the goal, -1..1, positive = turn right (clockwise)
+    float error = constrain(lightBearing.getRelativeBearing() / 90.0f, -1.0f, 1.0f);
+    
+    // Close to the light the forward-facing LDR pair is more accurate than a
+    // dead-reckoned bearing, so let it pull the error toward the bright side.
+    float left = ldrSensor.getLeftBrightness();
+    float right = ldrSensor.getRightBrightness();
+    if ((left + right) / 2.0f > LDR_ASSIST_THRESHOLD) {
+        float ldrError = -(left - right) / (left + right + 0.001f);   // Left brighter = turn left
+        error = constrain(0.5f * error + ldrError, -1.0f, 1.0f);
+    }
+    return error;
+}
+
+bool LightNavigator::checkArrival() {
+    float avg = (ldrSensor.getLeftBrightness() + ldrSensor.getRightBrightness()) / 2.0f;
+    if (avg < ARRIVAL_THRESHOLD) return false;
+    
+    movement.stop();
+    LOG_INFO("🏁 Navigator reached light: %lu ms, path %.0f cm, %d obstacle(s)",
+             millis() - runStartTime, odometry.getDistance() - runStartDistance,
+             obstacleEncounters);
+    setState(ARRIVED);
+    return true;
+}
+
+void LightNavigator::handleAcquiring() {
+    status.setStatus(StatusLED::SEARCHING);
+    
+    if (!lightBearing.isScanning()) {
+        if (lightBearing.hasEstimate()) {
+            setState(MOTION_TO_GOAL);
+            return;
+        }
+        lightBearing.startScan(config.crawlSpeed);
+        return;
+    }
+    
+    if (lightBearing.update()) {
+        setState(lightBearing.hasEstimate() ? MOTION_TO_GOAL : SEARCHING);
+    }
+}
+
+void LightNavigator::handleSearching() {
+    status.setStatus(StatusLED::MOVING);
+    
+    if (sensor.obstacleFar()) {
+        startBoundary();
+        return;
+    }
+    wander.update(config.crawlSpeed);
+    
+    if (millis() - stateStartTime > SEARCH_TIME) {
+        setState(ACQUIRING);
+    }
+}
+
+void LightNavigator::handleMotionToGoal() {
+    status.setStatus(StatusLED::SEARCHING);
+    
+    if (checkArrival()) return;
+    
+    if (!lightBearing.hasEstimate()) {
+        setState(ACQUIRING);
+        return;
+    }
+    
+    if (sensor.obstacleFar()) {
+        startBoundary();
+        return;
+    }
+    
+    float error = goalError();
+    int linear = (int)(config.baseSpeed * (1.0f - 0.7f * fabsf(error)));
+    int angular = (int)(error * config.baseSpeed * 0.8f);
+    movement.setTwist(linear, angular);
+}
+
+void LightNavigator::startBoundary() {
+    latencyTracer.arm(sensor.getSampleTag());
+    obstacleEncounters++;
+    
+    // Go around on the side the goal is on, leaving the wall on the other side
+    if (lightBearing.hasEstimate()) {
+        followSide = (lightBearing.getRelativeBearing() >= 0.0f) ? -1 : 1;
+    } else {
+        followSide = -followSide;
+    }
+    
+    boundaryStartTime = millis();
+    boundaryStartDistance = odometry.getDistance();
+    LOG_INFO("🧱 Obstacle at %d cm - following boundary (wall on %s)",
+             sensor.getDistance(), followSide > 0 ? "right" : "left");
+    setState(BOUNDARY_TURN);
+}
+
+void LightNavigator::handleBoundaryTurn() {
+    status.setStatus(StatusLED::OBSTACLE);
+    
+    // Turn away from the wall until the way ahead is clear
+    if (sensor.getDistance() > sensor.getWarnDistance() + CLEAR_MARGIN) {
+        setState(BOUNDARY_ARC);
+        return;
+    }
+    
+    if (followSide > 0) {
+        movement.spinCCW(config.crawlSpeed);
+    } else {
+        movement.spinCW(config.crawlSpeed);
+    }
+    
+    // A full revolution without a gap: boxed in, start over from a scan
+    if (millis() - stateStartTime > (unsigned long)config.turnDuration * 4) {
+        LOG_WARN("⚠ No gap found - rescanning");
+        movement.stop();
+        setState(ACQUIRING);
+    }
+}
+
+void LightNavigator::handleBoundaryArc() {
+    status.setStatus(StatusLED::OBSTACLE);
+    
+    if (checkArrival()) return;
+    
+    if (sensor.obstacleFar()) {
+        setState(BOUNDARY_TURN);
+        return;
+    }
+    
+    unsigned long following = millis() - boundaryStartTime;
+    
+    // Leave the boundary once the goal is roughly ahead and the way is clear
+    if (following > MIN_FOLLOW_TIME && lightBearing.hasEstimate() &&
+        fabsf(lightBearing.getRelativeBearing()) < LEAVE_BEARING &&
+        sensor.getDistance() > sensor.getWarnDistance() + CLEAR_MARGIN) {
+        LOG_INFO("↗ Leaving boundary after %.0f cm - goal is clear",
+                 odometry.getDistance() - boundaryStartDistance);
+        setState(MOTION_TO_GOAL);
+        return;
+    }
+    
+    if (following > MAX_FOLLOW_TIME) {
+        LOG_INFO("⏱️ Boundary too long - rescanning for light");
+        lightBearing.invalidate();
+        movement.stop();
+        setState(ACQUIRING);
+        return;
+    }
+    
+    // Arc back toward the wall side so the scallops hug the boundary
+    int linear = config.crawlSpeed;
+    int angular = (int)(followSide * ARC_CURVATURE * config.crawlSpeed);
+    movement.setTwist(linear, angular);
+}
+
+void LightNavigator::handleArrived() {
+    status.setStatus(StatusLED::READY);
+    
+    float avg = (ldrSensor.getLeftBrightness() + ldrSensor.getRightBrightness()) / 2.0f;
+    if (avg < ARRIVAL_THRESHOLD * 0.8f) {
+        LOG_INFO("🌑 Light moved or dimmed - reacquiring");
+        lightBearing.invalidate();
+        runStartTime = millis();
+        runStartDistance = odometry.getDistance();
+        obstacleEncounters = 0;
+        setState(ACQUIRING);
+    }
+}
@@ -0,0 +1,34 @@
+#include "boot_timeline.h"
+#include <esp_timer.h>
+
+BootTimeline bootTimeline;
+
+void BootTimeline::mark(const char* stage) {
+    if (count >= MAX_STAGES) return;
+    stages[count].name = stage;
+    stages[count].us = esp_timer_get_time();
+    count++;
+}
+
+void BootTimeline::markReady() {
+    mark("ready");
+    readyUs = esp_timer_get_time();
+}
+
+void BootTimeline::printReport() {
+    Serial.println("\n--- Boot timeline ---");
+    Serial.println("  stage                     at ms   took ms");
+    uint32_t previous = 0;
+    for (int i = 0; i < count; i++) {
+        uint32_t took = stages[i].us - previous;
+        Serial.printf("  %-22s %8lu.%01lu %7lu.%01lu\n", stages[i].name,
+                      (unsigned long)(stages[i].us / 1000), (unsigned long)(stages[i].us / 100 % 10),
+                      (unsigned long)(took / 1000), (unsigned long)(took / 100 % 10));
+        previous = stages[i].us;
+    }
+    if (readyUs > 0) {
+        Serial.printf("  Ready to drive %lu.%01lu ms after app start (target %lu ms)%s\n",
+                      (unsigned long)(readyUs / 1000), (unsigned long)(readyUs / 100 % 10),
+                      (unsigned long)(TARGET_US / 1000), readyUs > TARGET_US ? " - OVER" : "");
+    }
+}
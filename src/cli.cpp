@@ -1,27 +1,188 @@
-#include <Arduino.h>
-#include "hal.h"
-
-void processSerialCommands(HAL& hal) {
-    if (Serial.available()) {
-        String cmd = Serial.readStringUntil('\n');
-        cmd.trim();
-        if (cmd.equalsIgnoreCase("STOP")) {
-            hal.stopMotors();
-            Serial.println("Motors stopped.");
+#include "cli.h"
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+CommandLine commandLine;
+
+void CommandLine::begin(const Command* table, size_t count, Handler emergencyStop) {
+    commands = table;
+    commandCount = count;
+    onSpace = emergencyStop;
+    length = 0;
+    discarding = false;
+}
+
+// ============================================================================
+// INPUT
+// ============================================================================
+
+bool CommandLine::feed(char c) {
+    if (c == '\r' || c == '\n') {
+        if (discarding) {
+            discarding = false;
+            length = 0;
+            Serial.print("> ");
+            return false;
+        }
+        if (length == 0) return false;     // Blank line, or the \n of a \r\n
+        dispatch();
+        return true;
+    }
+    if (discarding) return false;
+
+    // Spacebar on an empty line: act now, don't wait for Enter
+    if (c == ' ' && length == 0) {
+        if (onSpace) {
+            Args none = {};
+            onSpace(none);
+        }
+        Serial.print("> ");
+        return true;
+    }
+
+    if (c == '\b' || c == 0x7F) {
+        if (length > 0) length--;
+        return false;
+    }
+
+    if (length >= LINE_SIZE - 1) {
+        overflows++;
+        discarding = true;
+        length = 0;
+        Serial.printf("❓ Line too long (max %u characters), ignored\n", (unsigned)(LINE_SIZE - 1));
+        return false;
+    }
+    line[length++] = c;
+    return false;
+}
+
+// ============================================================================
+// DISPATCH
+// ============================================================================
+
+const CommandLine::Command* CommandLine::find(const char* name) {
+    for (size_t i = 0; i < commandCount; i++) {
+        if (strcasecmp(name, commands[i].name) == 0 ||
+            (commands[i].alias && strcasecmp(name, commands[i].alias) == 0)) {
+            return &commands[i];
+        }
+    }
+    return nullptr;
+}
+
+bool CommandLine::parseArg(char type, const char* token, Args& args) {
+    auto& value = args.v[args.count];
+    switch (type) {
+        case 'i': {
+            char* end;
+            value.i = strtol(token, &end, 0);
+            if (end == token || *end != '\0') return false;
+            break;
+        }
+        case 'c':
+            if (token[0] == '\0' || token[1] != '\0') return false;
+            value.c = toupper(token[0]);
+            break;
+        case 'b':
+            if (!strcasecmp(token, "on") || !strcmp(token, "1")) value.b = true;
+            else if (!strcasecmp(token, "off") || !strcmp(token, "0")) value.b = false;
+            else return false;
+            break;
+        case 'w':
+            value.w = token;
+            break;
+        default:
+            return false;
+    }
+    args.count++;
+    return true;
+}
+
+void CommandLine::dispatch() {
+    line[length] = '\0';
+    length = 0;
+
+    // Tokenize in place: separators become terminators
+    char* tokens[1 + MAX_ARGS];
+    uint8_t tokenCount = 0;
+    char* p = line;
+    bool tooMany = false;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') *p++ = '\0';
+        if (!*p) break;
+        if (tokenCount == 1 + MAX_ARGS) {
+            tooMany = true;
+            break;
+        }
+        tokens[tokenCount++] = p;
+        while (*p && *p != ' ' && *p != '\t') p++;
+    }
+    if (tokenCount == 0) {
+        Serial.print("> ");
+        return;
+    }
+
+    const Command* cmd = find(tokens[0]);
+    if (!cmd) {
+        Serial.printf("❓ Unknown command '%s'. Type 'help' (or 'h').\n", tokens[0]);
+        Serial.print("> ");
+        return;
+    }
+
+    // Check the argument count and types before the handler sees them
+    const char* spec = cmd->spec ? cmd->spec : "";
+    const char* optional = strchr(spec, '|');
+    size_t required = optional ? (size_t)(optional - spec) : strlen(spec);
+    size_t allowed = strlen(spec) - (optional ? 1 : 0);
+    size_t given = tokenCount - 1;
+
+    Args args = {};
+    bool ok = !tooMany && given >= required && given <= allowed;
+    for (size_t i = 0, t = 0; ok && i < given; i++, t++) {
+        if (spec[t] == '|') t++;
+        if (!parseArg(spec[t], tokens[1 + i], args)) {
+            Serial.printf("❓ Bad argument '%s'\n", tokens[1 + i]);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        cmd->handler(args);
+    } else {
+        printUsage(*cmd);
+    }
+    Serial.print("> ");
+}
+
+// ============================================================================
+// HELP
+// ============================================================================
+
+void CommandLine::printUsage(const Command& cmd) {
+    Serial.printf("  Usage: %s %s\n", cmd.name, cmd.usage ? cmd.usage : "");
+}
+
+void CommandLine::printHelp() {
+    Serial.println("\n╔════════════════════════════════════════╗");
+    Serial.println("║          EMBER COMMAND HELP           ║");
+    Serial.println("╚════════════════════════════════════════╝");
+    Serial.println("Type a command and press Enter; the short form in () works too.");
+    Serial.println("SPACE on an empty line is an immediate emergency stop.");
+
+    const char* group = nullptr;
+    char left[40];
+    for (size_t i = 0; i < commandCount; i++) {
+        const Command& cmd = commands[i];
+        if (!group || strcmp(group, cmd.group) != 0) {
+            group = cmd.group;
+            Serial.printf("\n%s:\n", group);
+        }
+        snprintf(left, sizeof(left), "%s %s", cmd.name, cmd.usage ? cmd.usage : "");
+        if (cmd.alias) {
+            Serial.printf("  %-28s (%s) %s\n", left, cmd.alias, cmd.help);
         } else {
-            char motor = toupper(cmd.charAt(0));
-            char dir = toupper(cmd.charAt(2));
-            int speed = cmd.substring(4).toInt();
-            bool forward = (dir == 'F');
-            if (motor == 'A') {
-                hal.setMotorA(speed, forward);
-                Serial.printf("Motor A %s at %d\n", forward ? "forward" : "reverse", speed);
-            } else if (motor == 'B') {
-                hal.setMotorB(speed, forward);
-                Serial.printf("Motor B %s at %d\n", forward ? "forward" : "reverse", speed);
-            } else {
-                Serial.println("Invalid command. Use: A/B F/R speed or STOP");
-            }
+            Serial.printf("  %-28s     %s\n", left, cmd.help);
         }
     }
 }
@@ -0,0 +1,266 @@
+#include "deadline_monitor.h"
+#include "logger.h"
+#include <esp_task_wdt.h>
+
+DeadlineMonitor deadlineMonitor;
+
+int DeadlineMonitor::registerActivity(const char* name, uint32_t periodMs, uint32_t deadlineMs,
+                                      Reaction reaction) {
+    if (activityCount >= MAX_ACTIVITIES) return -1;
+    Activity& a = activities[activityCount];
+    a.name = name;
+    a.periodUs = periodMs * 1000;
+    a.deadlineUs = deadlineMs * 1000;
+    a.reaction = reaction;
+    a.task = nullptr;
+    a.startUs = 0;
+    a.endUs = 0;
+    a.running = false;
+    a.flagged = false;
+    a.section = nullptr;
+    a.overrunSlot = -1;
+    a.holdingMotors = false;
+    a.activations = 0;
+    a.worstUs = 0;
+    return activityCount++;
+}
+
+bool DeadlineMonitor::begin(HAL& halRef, uint32_t checkPeriodMs) {
+    hal = &halRef;
+    holdMutex = xSemaphoreCreateMutexStatic(&holdMutexStorage);
+    
+    esp_timer_create_args_t args = {};
+    args.callback = timerCallback;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;   // Highest-priority task on the chip
+    args.name = "deadline";
+    if (esp_timer_create(&args, &timer) != ESP_OK) return false;
+    return esp_timer_start_periodic(timer, checkPeriodMs * 1000ULL) == ESP_OK;
+}
+
+// ============================================================================
+// ACTIVITY SIDE (called by the watched code)
+// ============================================================================
+
+void DeadlineMonitor::start(int id) {
+    if (id < 0 || id >= activityCount) return;
+    Activity& a = activities[id];
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    
+    if (a.task == nullptr) {
+        a.task = xTaskGetCurrentTaskHandle();
+        if (a.reaction == WATCHDOG_RESET) {
+            esp_task_wdt_init(max((a.deadlineUs + 999999) / 1000000, 1u), true);
+            esp_task_wdt_add(a.task);
+        }
+    }
+    
+    portENTER_CRITICAL(&lock);
+    if (a.overrunSlot >= 0) {
+        // Finalize a starvation record: how late this start actually was
+        overruns[a.overrunSlot].overrunUs = (now - a.endUs) - a.periodUs - a.deadlineUs;
+        a.overrunSlot = -1;
+    }
+    a.startUs = now;
+    a.section = nullptr;
+    a.flagged = false;
+    a.running = true;
+    portEXIT_CRITICAL(&lock);
+    a.activations++;
+}
+
+void DeadlineMonitor::finish(int id) {
+    if (id < 0 || id >= activityCount) return;
+    Activity& a = activities[id];
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint32_t elapsed = now - a.startUs;
+    if (elapsed > a.worstUs) a.worstUs = elapsed;
+    
+    int slot = -1;
+    portENTER_CRITICAL(&lock);
+    if (a.overrunSlot >= 0 && !overruns[a.overrunSlot].starved) {
+        slot = a.overrunSlot;
+        overruns[slot].overrunUs = elapsed - a.deadlineUs;
+        a.overrunSlot = -1;
+    }
+    a.running = false;
+    a.flagged = false;
+    a.endUs = now;
+    portEXIT_CRITICAL(&lock);
+    
+    if (a.reaction == WATCHDOG_RESET) {
+        esp_task_wdt_reset();
+    }
+    releaseMotors(a);
+    
+    if (slot >= 0) {
+        const char* where = overruns[slot].section;
+        LOG_WARN("⏰ %s overran its %lu ms deadline by %.1f ms (in %s)",
+                 a.name, (unsigned long)(a.deadlineUs / 1000),
+                 overruns[slot].overrunUs / 1000.0f, where ? where : "?");
+    }
+}
+
+void DeadlineMonitor::section(int id, const char* name) {
+    if (id < 0 || id >= activityCount) return;
+    activities[id].section = name;
+}
+
+void DeadlineMonitor::setPeriod(int id, uint32_t periodMs) {
+    if (id < 0 || id >= activityCount) return;
+    activities[id].periodUs = periodMs * 1000;
+}
+
+void DeadlineMonitor::setReaction(int id, Reaction reaction) {
+    if (id < 0 || id >= activityCount) return;
+    Activity& a = activities[id];
+    if (a.task != nullptr && a.reaction != reaction) {
+        if (reaction == WATCHDOG_RESET) {
+            esp_task_wdt_init(max((a.deadlineUs + 999999) / 1000000, 1u), true);
+            esp_task_wdt_add(a.task);
+        } else if (a.reaction == WATCHDOG_RESET) {
+            esp_task_wdt_delete(a.task);
+        }
+    }
+    a.reaction = reaction;
+}
+
+DeadlineMonitor::Reaction DeadlineMonitor::getReaction(int id) {
+    if (id < 0 || id >= activityCount) return LOG_ONLY;
+    return activities[id].reaction;
+}
+
+uint32_t DeadlineMonitor::getOverrunCount() {
+    return overrunTotal;
+}
+
+// ============================================================================
+// MONITOR SIDE (esp_timer task)
+// ============================================================================
+
+void DeadlineMonitor::timerCallback(void* arg) {
+    static_cast<DeadlineMonitor*>(arg)->check();
+}
+
+int DeadlineMonitor::logOverrun(int id, bool starved, uint32_t overrunUs) {
+    int slot = overrunTotal % MAX_OVERRUNS;
+    Overrun& o = overruns[slot];
+    o.timeMs = millis();
+    o.activity = id;
+    o.starved = starved;
+    o.section = (const char*)activities[id].section;
+    o.overrunUs = overrunUs;
+    overrunTotal = overrunTotal + 1;
+    return slot;
+}
+
+void DeadlineMonitor::check() {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    
+    for (int i = 0; i < activityCount; i++) {
+        Activity& a = activities[i];
+        if (a.activations == 0) continue;   // Not started yet
+        
+        bool caught = false;
+        portENTER_CRITICAL(&lock);
+        if (!a.flagged) {
+            if (a.running && now - a.startUs > a.deadlineUs) {
+                a.overrunSlot = logOverrun(i, false, now - a.startUs - a.deadlineUs);
+                a.flagged = true;
+                caught = true;
+            } else if (!a.running && now - a.endUs > a.periodUs + a.deadlineUs) {
+                a.overrunSlot = logOverrun(i, true, now - a.endUs - a.periodUs - a.deadlineUs);
+                a.flagged = true;
+                caught = true;
+            }
+        }
+        portEXIT_CRITICAL(&lock);
+        
+        if (caught) react(a);
+    }
+}
+
+void DeadlineMonitor::react(Activity& a) {
+    switch (a.reaction) {
+        case LOG_ONLY:
+            break;
+        case STOP_MOTORS:
+        case WATCHDOG_RESET:
+            // Safe state until the activation ends: a zero limit cuts the
+            // outputs now and scales whatever the late code commands next to
+            // nothing. With WATCHDOG_RESET the TWDT resets the chip if the
+            // activity still doesn't finish within its timeout.
+            if (!hal) break;
+            portENTER_CRITICAL(&lock);
+            if (!a.holdingMotors) {
+                a.holdingMotors = true;
+                motorHolds++;
+            }
+            portEXIT_CRITICAL(&lock);
+            applyMotorHold();
+            break;
+    }
+}
+
+// Brings the motor limit in line with the hold count. The count is only
+// touched under the spinlock; the LEDC writes in setMotorLimit() run outside
+// it, with interrupts on, serialized by a mutex so a hold and a release
+// racing from two tasks can't leave the limit at the wrong value.
+void DeadlineMonitor::applyMotorHold() {
+    xSemaphoreTake(holdMutex, portMAX_DELAY);
+    portENTER_CRITICAL(&lock);
+    bool want = motorHolds > 0;
+    portEXIT_CRITICAL(&lock);
+    if (want && !motorsHeld) {
+        heldMotorLimit = hal->getMotorLimit();
+        hal->setMotorLimit(0);
+        motorsHeld = true;
+    } else if (!want && motorsHeld) {
+        if (hal->getMotorLimit() == 0) hal->setMotorLimit(heldMotorLimit);
+        motorsHeld = false;
+    }
+    xSemaphoreGive(holdMutex);
+}
+
+// Activity side (finish): lift the hold once no activity holds it any more
+void DeadlineMonitor::releaseMotors(Activity& a) {
+    if (!a.holdingMotors) return;
+    
+    // The motors stay stopped until the next command. If something (the power
+    // manager) set a new limit meanwhile, that one stands.
+    portENTER_CRITICAL(&lock);
+    a.holdingMotors = false;
+    motorHolds--;
+    portEXIT_CRITICAL(&lock);
+    applyMotorHold();
+    LOG_WARN("⏰ %s finished: motor hold released", a.name);
+}
+
+const char* DeadlineMonitor::reactionName(Reaction r) {
+    switch (r) {
+        case STOP_MOTORS:    return "stop motors";
+        case WATCHDOG_RESET: return "watchdog reset";
+        default:             return "log";
+    }
+}
+
+void DeadlineMonitor::printReport() {
+    Serial.println("\n--- Deadline Monitor ---");
+    for (int i = 0; i < activityCount; i++) {
+        Activity& a = activities[i];
+        Serial.printf("  %-8s period %lu ms, deadline %lu ms, worst %.1f ms, %lu runs, on overrun: %s\n",
+                      a.name, (unsigned long)(a.periodUs / 1000), (unsigned long)(a.deadlineUs / 1000),
+                      a.worstUs / 1000.0f, (unsigned long)a.activations, reactionName(a.reaction));
+    }
+    
+    uint32_t total = overrunTotal;
+    uint32_t held = min(total, (uint32_t)MAX_OVERRUNS);
+    Serial.printf("  Overruns: %lu total, last %lu:\n", (unsigned long)total, (unsigned long)held);
+    for (uint32_t i = total - held; i < total; i++) {
+        const Overrun& o = overruns[i % MAX_OVERRUNS];
+        Serial.printf("    %8.3fs %-8s %s by %.1f ms in %s\n",
+                      o.timeMs / 1000.0f, activities[o.activity].name,
+                      o.starved ? "starved" : "overran",
+                      o.overrunUs / 1000.0f, o.section ? o.section : "?");
+    }
+}
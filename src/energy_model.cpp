@@ -0,0 +1,138 @@
+#include "energy_model.h"
+#include "logger.h"
+
+// Per-tick rates in energy units (FULL = 1000000). Sitting in the dark at
+// 80 MHz costs ~160/tick, about 10 minutes from full; full light at
+// efficiency 1.0 pays ~400/tick.
+static const int32_t LIGHT_CREDIT = 400;    // At brightness 1.0, efficiency 1.0
+static const int32_t BASAL_COST = 80;       // At efficiency 1.0
+static const int32_t MOTOR_COST = 200;      // Both wheels at full PWM
+static const int32_t PING_COST = 25;
+static const int32_t CPU_COST_DIVISOR = 4;  // MHz / 4 per tick: 20 at 80 MHz, 60 at 240 MHz
+
+EnergyModel::EnergyModel(LDRSensor& ldrRef, Movement& moveRef, UltrasonicSensor& sonarRef,
+                         GenomeManager& genomeRef)
+    : ldr(ldrRef), movement(moveRef), sonar(sonarRef), genetics(genomeRef) {
+}
+
+// ============================================================================
+// INTEGRATION
+// ============================================================================
+
+bool EnergyModel::update() {
+    unsigned long now = millis();
+    if (nextTickMs == 0) {
+        nextTickMs = now + TICK_MS;
+        lastPings = sonar.getPingCount();
+        return false;
+    }
+    if ((long)(now - nextTickMs) < 0) return false;
+
+    // Sample the inputs once; every tick due now integrates the same values
+    int32_t brightness = (ldr.getLeftBrightness() + ldr.getRightBrightness()) * 500;
+    int32_t efficiency = genetics.getEfficiency() * 1000;
+    int32_t duty = abs(movement.getWheelSpeedA()) + abs(movement.getWheelSpeedB());
+    int32_t cpuMhz = getCpuFrequencyMhz();
+    uint32_t pingCount = sonar.getPingCount();
+    int32_t pings = pingCount - lastPings;
+    lastPings = pingCount;
+
+    bool died = false;
+    while ((long)(now - nextTickMs) >= 0) {
+        nextTickMs += TICK_MS;
+        died |= step(brightness, efficiency, duty, pings, cpuMhz);
+        pings = 0;      // Already charged
+    }
+    return died;
+}
+
+bool EnergyModel::step(int32_t brightness, int32_t efficiency, int32_t duty, int32_t pings,
+                       int32_t cpuMhz) {
+    if (!alive) return false;
+
+    int32_t credit = constrain(brightness, 0, 1000) * efficiency / 1000 * LIGHT_CREDIT / 1000;
+    int32_t basal = BASAL_COST * efficiency / 1000;
+    int32_t motors = MOTOR_COST * duty / 510;
+    int32_t sonarCost = PING_COST * pings;
+    int32_t cpu = cpuMhz / CPU_COST_DIVISOR;
+
+    gained += credit;
+    spentBasal += basal;
+    spentMotors += motors;
+    spentSonar += sonarCost;
+    spentCpu += cpu;
+
+    energy += credit - basal - motors - sonarCost - cpu;
+    if (energy > FULL) energy = FULL;
+    aliveTicks++;
+
+    if (energy <= 0) {
+        energy = 0;
+        alive = false;
+        deaths++;
+        LOG_WARN("💀 Out of energy after %lus (death #%lu)", (unsigned long)getAliveSeconds(),
+                 (unsigned long)deaths);
+        return true;
+    }
+    return false;
+}
+
+void EnergyModel::reset() {
+    energy = FULL;
+    alive = true;
+    aliveTicks = 0;
+    gained = spentBasal = spentMotors = spentSonar = spentCpu = 0;
+    nextTickMs = 0;
+}
+
+// ============================================================================
+// HIBERNATE
+// ============================================================================
+
+EnergyModel::Snapshot EnergyModel::snapshot() {
+    Snapshot s;
+    s.energy = energy;
+    s.aliveTicks = aliveTicks;
+    s.deaths = deaths;
+    s.alive = alive;
+    return s;
+}
+
+void EnergyModel::restore(const Snapshot& s, uint32_t sleptMs) {
+    energy = s.energy;
+    aliveTicks = s.aliveTicks;
+    deaths = s.deaths;
+    alive = s.alive;
+    if (!alive) return;
+
+    // Dormant: basal upkeep only. Dying in the sleep stops the clock there.
+    int32_t basal = BASAL_COST * (int32_t)(genetics.getEfficiency() * 1000) / 1000;
+    uint32_t ticks = sleptMs / TICK_MS;
+    uint32_t survivable = basal > 0 ? energy / basal : ticks;
+    if (ticks >= survivable) {
+        aliveTicks += survivable;
+        energy = 0;
+        alive = false;
+        deaths++;
+        return;
+    }
+    aliveTicks += ticks;
+    energy -= ticks * basal;
+    spentBasal += ticks * basal;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+void EnergyModel::printReport() {
+    Serial.println("\n--- Energy ---");
+    Serial.printf("  %s, energy %ld.%ld%%, alive %lus, deaths %lu\n", alive ? "ALIVE" : "DEAD",
+                  (long)(energy / 10000), (long)(energy / 1000 % 10),
+                  (unsigned long)getAliveSeconds(), (unsigned long)deaths);
+    Serial.printf("  Efficiency gene %.3f\n", genetics.getEfficiency());
+    Serial.printf("  Since reset, %% of a full store: +%lu light, -%lu basal, -%lu motors, "
+                  "-%lu sonar, -%lu CPU\n", (unsigned long)(gained / 10000),
+                  (unsigned long)(spentBasal / 10000), (unsigned long)(spentMotors / 10000),
+                  (unsigned long)(spentSonar / 10000), (unsigned long)(spentCpu / 10000));
+}
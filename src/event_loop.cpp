@@ -0,0 +1,244 @@
+#include "event_loop.h"
+
+EventLoop eventLoop;
+
+// Typical ESP32 draw with radios off (datasheet ranges, mid-points). There is
+// no current sensor on the robot, so savings are estimated from measured
+// residency: time at each level, awake vs. blocked in wait().
+static const float ACTIVE_MA[EventLoop::LEVEL_COUNT] = { 25.0f, 36.0f, 50.0f };   // 80/160/240 MHz
+static const float WAITI_MA[EventLoop::LEVEL_COUNT]  = { 14.0f, 22.0f, 30.0f };   // Idle, clock running
+static const float LIGHT_SLEEP_MA = 0.8f;
+
+static const char* LEVEL_NAMES[EventLoop::LEVEL_COUNT] = { "LOW", "MID", "HIGH" };
+static const char* EVENT_NAMES[EventLoop::EVENT_COUNT] = { "sensor", "timer", "uart", "button" };
+
+bool EventLoop::begin(uint32_t tickMs, int buttonPin) {
+    loopTask = xTaskGetCurrentTaskHandle();     // begin() runs in setup(), on the loop task
+    
+    esp_pm_config_esp32_t pm;
+    pm.max_freq_mhz = 240;
+    pm.min_freq_mhz = 80;
+    pm.light_sleep_enable = true;
+    pmSupported = esp_pm_configure(&pm) == ESP_OK;
+    if (pmSupported) {
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "motors", &cpuLock);
+        esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "active", &apbLock);
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "ping", &pingLock);
+        esp_pm_lock_acquire(cpuLock);
+    } else {
+        setCpuFrequencyMhz(levelMHz(HIGH_POWER));
+    }
+    level = HIGH_POWER;
+    
+    esp_timer_create_args_t args = {};
+    args.callback = timerCallback;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "loop_tick";
+    if (esp_timer_create(&args, &timer) != ESP_OK) return false;
+    if (esp_timer_start_periodic(timer, tickMs * 1000ULL) != ESP_OK) return false;
+    
+    Serial.onReceive([this]() { post(EVENT_UART); });
+    
+    if (buttonPin >= 0) {
+        pinMode(buttonPin, INPUT_PULLUP);
+        attachInterrupt(buttonPin, buttonISR, FALLING);
+    }
+    
+    lastWakeUs = micros();
+    return true;
+}
+
+// ============================================================================
+// EVENTS
+// ============================================================================
+
+void EventLoop::post(uint32_t bits) {
+    if (loopTask) xTaskNotify(loopTask, bits, eSetBits);
+}
+
+void IRAM_ATTR EventLoop::postFromISR(uint32_t bits) {
+    if (!loopTask) return;
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(loopTask, bits, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void EventLoop::timerCallback(void* arg) {
+    static_cast<EventLoop*>(arg)->post(EVENT_TIMER);
+}
+
+void IRAM_ATTR EventLoop::buttonISR() {
+    eventLoop.postFromISR(EVENT_BUTTON);
+}
+
+uint32_t EventLoop::wait(uint32_t maxWaitMs) {
+    uint32_t now = micros();
+    awakeUs[level] += now - lastWakeUs;
+    
+    uint32_t bits = 0;
+    BaseType_t got = xTaskNotifyWait(0, UINT32_MAX, &bits, pdMS_TO_TICKS(maxWaitMs));
+    
+    uint32_t after = micros();
+    waitUs[level] += after - now;
+    lastWakeUs = after;
+    
+    if (got == pdTRUE) {
+        wakeups++;
+        for (int i = 0; i < EVENT_COUNT; i++) {
+            if (bits & (1u << i)) events[i]++;
+        }
+    } else {
+        timeouts++;
+    }
+    return bits;
+}
+
+// ============================================================================
+// CLOCK LEVELS
+// ============================================================================
+
+void EventLoop::setDemand(Level target) {
+    if (!powerSaving) target = HIGH_POWER;
+    if (target > maxLevel) target = maxLevel;
+    if (target != level) applyLevel(target);
+}
+
+EventLoop::Level EventLoop::getLevel() {
+    return level;
+}
+
+void EventLoop::setMaxLevel(Level cap) {
+    maxLevel = cap;
+    if (level > maxLevel) applyLevel(maxLevel);
+}
+
+void EventLoop::applyLevel(Level target) {
+    if (pmSupported) {
+        // Take the new lock before dropping the old one so the clock never dips
+        if (target == HIGH_POWER) esp_pm_lock_acquire(cpuLock);
+        if (target == MID_POWER) esp_pm_lock_acquire(apbLock);
+        if (level == HIGH_POWER) esp_pm_lock_release(cpuLock);
+        if (level == MID_POWER) esp_pm_lock_release(apbLock);
+    } else {
+        // pulseIn() times the echo in CPU cycles: never switch mid-ping.
+        // A deferred switch is retried on the next setDemand().
+        portENTER_CRITICAL(&lock);
+        if (pingsActive > 0) {
+            portEXIT_CRITICAL(&lock);
+            deferredSwitches++;
+            return;
+        }
+        switching = true;
+        portEXIT_CRITICAL(&lock);
+        
+        setCpuFrequencyMhz(levelMHz(target));
+        switching = false;
+    }
+    
+    uint32_t now = micros();
+    awakeUs[level] += now - lastWakeUs;
+    lastWakeUs = now;
+    level = target;
+}
+
+uint32_t EventLoop::levelMHz(Level l) {
+    switch (l) {
+        case HIGH_POWER: return 240;
+        case MID_POWER:  return 160;
+        default:         return 80;
+    }
+}
+
+void EventLoop::setPowerSaving(bool on) {
+    powerSaving = on;
+    if (!on) setDemand(HIGH_POWER);
+}
+
+bool EventLoop::isPowerSaving() {
+    return powerSaving;
+}
+
+bool EventLoop::hasPowerManagement() {
+    return pmSupported;
+}
+
+void EventLoop::pingBegin() {
+    if (pmSupported) {
+        esp_pm_lock_acquire(pingLock);
+        return;
+    }
+    for (;;) {
+        portENTER_CRITICAL(&lock);
+        if (!switching) {
+            pingsActive = pingsActive + 1;
+            portEXIT_CRITICAL(&lock);
+            return;
+        }
+        portEXIT_CRITICAL(&lock);
+        vTaskDelay(1);      // Clock switch in progress on core 1
+    }
+}
+
+void EventLoop::pingEnd() {
+    if (pmSupported) {
+        esp_pm_lock_release(pingLock);
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    pingsActive = pingsActive - 1;
+    portEXIT_CRITICAL(&lock);
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+float EventLoop::estimateMa(Level l, float waitFraction) {
+    float active = pmSupported && l != HIGH_POWER ? ACTIVE_MA[LOW_POWER] : ACTIVE_MA[l];
+    float idle;
+    if (pmSupported) {
+        idle = l == LOW_POWER ? LIGHT_SLEEP_MA : (l == MID_POWER ? WAITI_MA[LOW_POWER] : WAITI_MA[l]);
+    } else {
+        idle = WAITI_MA[l];
+    }
+    return (1.0f - waitFraction) * active + waitFraction * idle;
+}
+
+void EventLoop::printReport() {
+    Serial.println("\n--- Event Loop / Power ---");
+    Serial.printf("  Clock control: %s, power saving %s, now %s\n",
+                  pmSupported ? "esp_pm (DFS + light sleep)" : "direct DFS (no CONFIG_PM_ENABLE)",
+                  powerSaving ? "ON" : "OFF", LEVEL_NAMES[level]);
+    Serial.printf("  Wakeups: %lu (timeouts %lu) - sensor %lu, timer %lu, uart %lu, button %lu\n",
+                  (unsigned long)wakeups, (unsigned long)timeouts,
+                  (unsigned long)events[0], (unsigned long)events[1],
+                  (unsigned long)events[2], (unsigned long)events[3]);
+    if (deferredSwitches > 0) {
+        Serial.printf("  Clock switches deferred by a ping: %lu\n", (unsigned long)deferredSwitches);
+    }
+    
+    uint64_t total = 0;
+    for (int l = 0; l < LEVEL_COUNT; l++) total += awakeUs[l] + waitUs[l];
+    if (total == 0) return;
+    
+    // Baseline: the old loop, always at 240 MHz, idling in delay()
+    float avgMa = 0, baseMa = 0;
+    Serial.println("  Level  Clock   Time   Blocked  Est. mA  Saving vs 240 MHz");
+    for (int l = 0; l < LEVEL_COUNT; l++) {
+        uint64_t levelUs = awakeUs[l] + waitUs[l];
+        if (levelUs == 0) continue;
+        float share = (float)levelUs / total;
+        float blocked = (float)waitUs[l] / levelUs;
+        float est = estimateMa((Level)l, blocked);
+        float base = (1.0f - blocked) * ACTIVE_MA[HIGH_POWER] + blocked * WAITI_MA[HIGH_POWER];
+        avgMa += share * est;
+        baseMa += share * base;
+        Serial.printf("  %-5s  %3lu MHz  %5.1f%%  %5.1f%%  %6.1f   %5.1f mA (%.0f%%)\n",
+                      LEVEL_NAMES[l],
+                      (unsigned long)(pmSupported && l != HIGH_POWER ? 80 : levelMHz((Level)l)),
+                      share * 100, blocked * 100, est, base - est, (base - est) * 100 / base);
+    }
+    Serial.printf("  Average: ~%.1f mA vs ~%.1f mA always-on (%.0f%% less, estimated)\n",
+                  avgMa, baseMa, baseMa > 0 ? (baseMa - avgMa) * 100 / baseMa : 0);
+}
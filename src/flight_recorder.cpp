@@ -0,0 +1,257 @@
+#include "flight_recorder.h"
+#include "protocol.h"
+#include "serial_tx.h"
+#include "logger.h"
+
+FlightRecorder flightRecorder;
+
+using FlightFormat::PageHeader;
+using FlightFormat::headerValid;
+
+static const char* const PARTITION_LABEL = "flightrec";
+
+// Dump: page bytes per console line
+static const size_t DUMP_CHUNK = 64;
+
+// Records at or below the sensor rate; 0 or less is off
+static int clampRate(int hz) {
+    return hz > FlightRecorder::MAX_RATE_HZ ? FlightRecorder::MAX_RATE_HZ : hz;
+}
+
+bool FlightRecorder::begin(uint8_t core) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         PARTITION_LABEL);
+    if (!partition) return false;
+    sectorCount = partition->size / PAGE_SIZE;
+    scan();
+
+    // Same priority as the log task: both only ever wait on slow I/O
+    BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "recorder", 4096, this, 1, &handle, core);
+    if (ok != pdPASS) {
+        handle = nullptr;
+        partition = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// Resume after the newest page: highest sequence number wins
+void FlightRecorder::scan() {
+    bool found = false;
+    uint32_t newestSeq = 0;
+    uint32_t newestSector = 0;
+    validPages = 0;
+    for (uint32_t s = 0; s < sectorCount; s++) {
+        PageHeader h;
+        if (esp_partition_read(partition, s * PAGE_SIZE, &h, sizeof(h)) != ESP_OK) continue;
+        if (!headerValid(h)) continue;
+        validPages++;
+        if (!found || (int32_t)(h.seq - newestSeq) > 0) {
+            found = true;
+            newestSeq = h.seq;
+            newestSector = s;
+        }
+    }
+    nextSector = found ? (newestSector + 1) % sectorCount : 0;
+    nextSeq = found ? newestSeq + 1 : 0;
+}
+
+// ============================================================================
+// RECORDING (loop)
+// ============================================================================
+
+bool FlightRecorder::due() {
+    if (!partition || params.rateHz <= 0) return false;
+    unsigned long now = millis();
+    if ((long)(now - nextDueMs) < 0) return false;
+
+    uint32_t period = 1000 / clampRate(params.rateHz);
+    dueMs = nextDueMs;
+    nextDueMs += period;
+    if ((long)(now - nextDueMs) >= 0) {
+        // Stalled or just switched on: restart the schedule from now
+        dueMs = now;
+        nextDueMs = now + period;
+    }
+    return true;
+}
+
+uint32_t FlightRecorder::msUntilDue() {
+    if (!partition || params.rateHz <= 0) return UINT32_MAX;
+    long left = (long)(nextDueMs - millis());
+    return left > 0 ? left : 0;
+}
+
+void FlightRecorder::record(Sample& s) {
+    uint16_t period = 1000 / max(clampRate(params.rateHz), 1);
+    if (!encoder.empty() && period != encoder.getPeriod()) seal();
+
+    if (encoder.empty()) encoder.start(pages[active], dueMs, period);
+    encodedBytes += encoder.add(s.values, dueMs);
+    recorded++;
+
+    if (encoder.full()) seal();
+}
+
+void FlightRecorder::seal() {
+    if (encoder.empty()) return;
+    encoder.seal(nextSeq++);
+
+    if (sealed >= 0) {
+        pagesDropped++;         // Writer still busy with the other buffer: reuse this one
+    } else {
+        sealed = active;
+        active ^= 1;
+        if (handle) xTaskNotifyGive(handle);
+    }
+}
+
+void FlightRecorder::flush(uint32_t maxMs) {
+    if (!partition) return;
+    seal();
+    unsigned long start = millis();
+    while (sealed >= 0 && millis() - start < maxMs) {
+        delay(1);
+    }
+}
+
+void FlightRecorder::requestDump() {
+    seal();     // Include the newest records
+    dumpRequested = true;
+    if (handle) xTaskNotifyGive(handle);
+}
+
+void FlightRecorder::requestErase() {
+    eraseRequested = true;
+    if (handle) xTaskNotifyGive(handle);
+}
+
+// ============================================================================
+// WRITER TASK (core 0)
+// ============================================================================
+
+void FlightRecorder::taskEntry(void* param) {
+    FlightRecorder* self = static_cast<FlightRecorder*>(param);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->sealed >= 0 || self->eraseRequested || self->dumpRequested) {
+            if (self->eraseRequested) {
+                self->eraseAll();
+                self->eraseRequested = false;
+            }
+            if (self->sealed >= 0) {
+                self->writePage(self->pages[self->sealed]);
+                self->sealed = -1;
+            }
+            if (self->dumpRequested) {
+                self->dump();
+                self->dumpRequested = false;
+            }
+        }
+    }
+}
+
+void FlightRecorder::writePage(const uint8_t* page) {
+    unsigned long start = millis();
+    size_t offset = nextSector * PAGE_SIZE;
+    bool ok = esp_partition_erase_range(partition, offset, PAGE_SIZE) == ESP_OK;
+    
+    // The cache was off on both cores for the erase: loop() stood still too
+    uint32_t eraseMs = millis() - start;
+    if (eraseMs > worstEraseMs) worstEraseMs = eraseMs;
+    if (eraseMs > LOOP_DEADLINE_MS) {
+        longErases++;
+        LOG_WARN("⚠ Recorder sector erase took %lu ms (loop deadline %lu ms)",
+                 (unsigned long)eraseMs, (unsigned long)LOOP_DEADLINE_MS);
+    }
+    
+    if (!ok || esp_partition_write(partition, offset, page, PAGE_SIZE) != ESP_OK) {
+        flashErrors++;
+    } else {
+        pagesWritten++;
+        if (validPages < sectorCount) validPages++;
+    }
+    nextSector = (nextSector + 1) % sectorCount;
+    lastWriteMs = millis() - start;
+}
+
+void FlightRecorder::eraseAll() {
+    // A sector at a time with a yield in between, so core 1 is never held off for long
+    for (uint32_t s = 0; s < sectorCount; s++) {
+        if (esp_partition_erase_range(partition, s * PAGE_SIZE, PAGE_SIZE) != ESP_OK) flashErrors++;
+        vTaskDelay(1);
+    }
+    validPages = 0;
+    nextSector = 0;
+    static const char done[] = "🗑 Flight recorder erased\n";
+    serialTx.write((const uint8_t*)done, sizeof(done) - 1);
+}
+
+void FlightRecorder::dump() {
+    char line[16 + DUMP_CHUNK * 2];
+    uint8_t chunk[DUMP_CHUNK];
+    uint32_t dumped = 0;
+
+    int n = snprintf(line, sizeof(line), "FR-BEGIN %lu\n", (unsigned long)validPages);
+    serialTx.write((const uint8_t*)line, n);
+
+    // Oldest first: the sector after the newest is the oldest once the log has wrapped
+    for (uint32_t k = 0; k < sectorCount; k++) {
+        uint32_t s = (nextSector + k) % sectorCount;
+        PageHeader h;
+        if (esp_partition_read(partition, s * PAGE_SIZE, &h, sizeof(h)) != ESP_OK) continue;
+        if (!headerValid(h)) continue;
+
+        size_t total = HEADER_SIZE + h.used;
+        for (size_t offset = 0; offset < total; offset += DUMP_CHUNK) {
+            size_t len = min(DUMP_CHUNK, total - offset);
+            if (esp_partition_read(partition, s * PAGE_SIZE + offset, chunk, len) != ESP_OK) break;
+            n = snprintf(line, sizeof(line), "FR %lu ", (unsigned long)h.seq);
+            for (size_t i = 0; i < len; i++) {
+                n += snprintf(line + n, sizeof(line) - n, "%02x", chunk[i]);
+            }
+            line[n++] = '\n';
+            serialTx.write((const uint8_t*)line, n);
+        }
+        dumped++;
+    }
+
+    n = snprintf(line, sizeof(line), "FR-END %lu\n", (unsigned long)dumped);
+    serialTx.write((const uint8_t*)line, n);
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+void FlightRecorder::printStatus() {
+    Serial.println("\n--- Flight Recorder ---");
+    if (!partition) {
+        Serial.println("  No 'flightrec' partition (flash with partitions_ember.csv) - not recording");
+        return;
+    }
+    Serial.printf("  Partition: %lu KB (%lu pages) at 0x%06lx, %lu pages hold data\n",
+                  (unsigned long)(partition->size / 1024), (unsigned long)sectorCount,
+                  (unsigned long)partition->address, (unsigned long)validPages);
+    if (params.rateHz <= 0) {
+        Serial.println("  Recording: OFF (set rec.rate_hz)");
+    } else {
+        Serial.printf("  Recording: %d Hz, current page %u/%u bytes (%u records)\n",
+                      clampRate(params.rateHz), (unsigned)encoder.getUsed(), (unsigned)PAGE_SIZE,
+                      encoder.getCount());
+    }
+    if (recorded > 0 && params.rateHz > 0) {
+        uint32_t perRecordX10 = encodedBytes * 10 / recorded;
+        uint32_t capacity = sectorCount * (PAGE_SIZE - HEADER_SIZE) * 10 / max(perRecordX10, (uint32_t)1);
+        Serial.printf("  %lu records, %lu.%lu bytes each: flash holds ~%lu min at this rate\n",
+                      (unsigned long)recorded, (unsigned long)(perRecordX10 / 10),
+                      (unsigned long)(perRecordX10 % 10),
+                      (unsigned long)(capacity / clampRate(params.rateHz) / 60));
+    }
+    Serial.printf("  Pages: %lu written, %lu dropped (writer busy), %lu flash errors, last write %lu ms\n",
+                  (unsigned long)pagesWritten, (unsigned long)pagesDropped,
+                  (unsigned long)flashErrors, (unsigned long)lastWriteMs);
+    Serial.printf("  Erase stall (both cores): worst %lu ms, %lu over the %lu ms loop deadline\n",
+                  (unsigned long)worstEraseMs, (unsigned long)longErases,
+                  (unsigned long)LOOP_DEADLINE_MS);
+}
@@ -0,0 +1,205 @@
+#include "genome.h"
+#include "protocol.h"
+#include "logger.h"
+#include <Preferences.h>
+
+static const char* const NVS_NAMESPACE = "ember";
+static const char* const NVS_KEY = "genome";
+
+static const uint16_t GENE_MAX = 0xFFFF;
+
+const Genome::GeneSpec Genome::SPECS[GENE_COUNT] = {
+    { "light_threshold", 0.05f, 0.95f },
+    { "efficiency",      0.5f,  1.5f  },
+    { "seek_delta",      0.02f, 0.4f  },
+    { "seek_speed",      60.0f, 200.0f },
+    { "approach_speed",  60.0f, 255.0f },
+    { "base_speed",      80.0f, 255.0f },
+};
+
+// Hardware RNG: bots flashed with the same image still differ
+static float randomUnit() {
+    return (esp_random() >> 8) / 16777216.0f;
+}
+
+// ============================================================================
+// GENES
+// ============================================================================
+
+float Genome::get(Gene g) const {
+    return SPECS[g].min + (SPECS[g].max - SPECS[g].min) * genes[g] / (float)GENE_MAX;
+}
+
+void Genome::set(Gene g, float value) {
+    float f = (value - SPECS[g].min) / (SPECS[g].max - SPECS[g].min);
+    f = constrain(f, 0.0f, 1.0f);
+    genes[g] = (uint16_t)lroundf(f * GENE_MAX);
+}
+
+void Genome::randomize() {
+    for (int i = 0; i < GENE_COUNT; i++) {
+        genes[i] = esp_random() & GENE_MAX;
+    }
+    generation = 0;
+}
+
+void Genome::mutate(float rate, float step) {
+    for (int i = 0; i < GENE_COUNT; i++) {
+        if (randomUnit() >= rate) continue;
+        int32_t delta = lroundf((randomUnit() * 2.0f - 1.0f) * step * GENE_MAX);
+        genes[i] = constrain((int32_t)genes[i] + delta, (int32_t)0, (int32_t)GENE_MAX);
+    }
+    generation++;
+}
+
+Genome Genome::crossover(const Genome& a, const Genome& b) {
+    Genome child = a;
+    uint32_t pick = esp_random();
+    for (int i = 0; i < GENE_COUNT; i++) {
+        if (pick & (1u << i)) child.genes[i] = b.genes[i];
+    }
+    child.generation = max(a.generation, b.generation) + 1;
+    return child;
+}
+
+// Big-endian genes, then generation, id, reserved
+void Genome::toHex(char* out) const {
+    uint8_t bytes[HEX_LENGTH / 2];
+    size_t n = 0;
+    for (int i = 0; i < GENE_COUNT; i++) {
+        bytes[n++] = genes[i] >> 8;
+        bytes[n++] = genes[i] & 0xFF;
+    }
+    bytes[n++] = generation >> 8;
+    bytes[n++] = generation & 0xFF;
+    bytes[n++] = botId;
+    bytes[n++] = reserved;
+    for (size_t i = 0; i < n; i++) {
+        snprintf(out + i * 2, 3, "%02x", bytes[i]);
+    }
+}
+
+bool Genome::fromHex(const char* hex) {
+    if (strlen(hex) != HEX_LENGTH) return false;
+    uint8_t bytes[HEX_LENGTH / 2];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        char pair[3] = { hex[i * 2], hex[i * 2 + 1], '\0' };
+        char* end;
+        bytes[i] = strtoul(pair, &end, 16);
+        if (*end != '\0') return false;
+    }
+    size_t n = 0;
+    for (int i = 0; i < GENE_COUNT; i++, n += 2) {
+        genes[i] = (bytes[n] << 8) | bytes[n + 1];
+    }
+    generation = (bytes[n] << 8) | bytes[n + 1];
+    botId = bytes[n + 2];
+    reserved = bytes[n + 3];
+    return true;
+}
+
+// ============================================================================
+// GENOME MANAGER
+// ============================================================================
+
+GenomeManager::GenomeManager(Phototropism& photoRef, MotorConfig& cfgRef)
+    : phototropism(photoRef), config(cfgRef) {
+    memset(&genome, 0, sizeof(genome));
+}
+
+void GenomeManager::begin() {
+    if (!load()) {
+        // Start from the compiled-in defaults; randomizing is the
+        // experiment's job ("randomize" for Generation 0)
+        const PhototropismParams& photo = phototropism.getParams();
+        firstBoot = true;
+        genome.set(Genome::LIGHT_THRESHOLD, photo.lightThreshold);
+        genome.set(Genome::EFFICIENCY, 1.0f);
+        genome.set(Genome::SEEK_DELTA, photo.seekDelta);
+        genome.set(Genome::SEEK_SPEED, photo.seekSpeed);
+        genome.set(Genome::APPROACH_SPEED, photo.approachSpeed);
+        genome.set(Genome::BASE_SPEED, config.baseSpeed);
+        genome.generation = 0;
+        genome.botId = 0;
+        genome.reserved = 0;
+        save();
+    }
+    apply();
+}
+
+void GenomeManager::apply() {
+    PhototropismParams& photo = phototropism.getParams();
+    photo.lightThreshold = genome.get(Genome::LIGHT_THRESHOLD);
+    photo.seekDelta = genome.get(Genome::SEEK_DELTA);
+    photo.seekSpeed = lroundf(genome.get(Genome::SEEK_SPEED));
+    photo.approachSpeed = lroundf(genome.get(Genome::APPROACH_SPEED));
+    config.baseSpeed = lroundf(genome.get(Genome::BASE_SPEED));
+    efficiency = genome.get(Genome::EFFICIENCY);
+}
+
+void GenomeManager::swap(const Genome& g) {
+    genome = g;
+    firstBoot = false;
+    apply();
+    if (!save()) {
+        LOG_WARN("⚠ Genome applied but not saved (NVS write failed)");
+    }
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+// Blob: version byte, genome, CRC-16 of both
+
+struct GenomeBlob {
+    uint8_t version;
+    Genome genome;
+    uint16_t crc;
+} __attribute__((packed));
+
+bool GenomeManager::save() {
+    GenomeBlob blob;
+    blob.version = SCHEMA_VERSION;
+    blob.genome = genome;
+    blob.crc = Protocol::crc16((const uint8_t*)&blob, offsetof(GenomeBlob, crc));
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) return false;
+    size_t written = prefs.putBytes(NVS_KEY, &blob, sizeof(blob));
+    prefs.end();
+    return written == sizeof(blob);
+}
+
+bool GenomeManager::load() {
+    GenomeBlob blob;
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) return false;
+    size_t len = prefs.getBytesLength(NVS_KEY) == sizeof(blob) ?
+                 prefs.getBytes(NVS_KEY, &blob, sizeof(blob)) : 0;
+    prefs.end();
+
+    if (len != sizeof(blob) || blob.version != SCHEMA_VERSION ||
+        Protocol::crc16((const uint8_t*)&blob, offsetof(GenomeBlob, crc)) != blob.crc) {
+        return false;
+    }
+    genome = blob.genome;
+    return true;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+void GenomeManager::print() {
+    char hex[Genome::HEX_LENGTH + 1];
+    genome.toHex(hex);
+    Serial.println("=================================");
+    Serial.printf("Bot ID: %u\n", genome.botId);
+    Serial.printf("Generation: %u\n", genome.generation);
+    for (int i = 0; i < Genome::GENE_COUNT; i++) {
+        Serial.printf("  %-16s %8.3f   [%g..%g]\n", Genome::SPECS[i].name,
+                      genome.get((Genome::Gene)i), Genome::SPECS[i].min, Genome::SPECS[i].max);
+    }
+    Serial.printf("Encoded: %s%s\n", hex, firstBoot ? " (defaults, first boot)" : "");
+    Serial.println("=================================");
+}
@@ -1,10 +1,27 @@
 #include "hal.h"
 #include "pins.h"
+#include "config.h"
+#include "trace.h"
 #include <algorithm> // For std::sort
+#include <driver/gpio.h>
+
+// Motor driver and LED pins latched low through deep sleep
+static const int SLEEP_HOLD_PINS[] = {
+    Pins::MOTOR_A_EN, Pins::MOTOR_B_EN, Pins::MOTOR_STBY,
+    Pins::MOTOR_A_IN1, Pins::MOTOR_A_IN2, Pins::MOTOR_B_IN1, Pins::MOTOR_B_IN2,
+    Pins::LED_RED, Pins::LED_GREEN, Pins::LED_BLUE
+};
 
 HAL::HAL() {}
 
 bool HAL::init() {
+    // Drive every latched pin low before releasing the deep-sleep latch, so
+    // on a warm wake nothing floats between the release and stopMotors()
+    for (int pin : SLEEP_HOLD_PINS) {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+    }
+    
     // Configure motor PWM channels (20kHz, 8-bit)
     ledcSetup(MOTOR_A_PWM_CHANNEL, PWM_FREQ, PWM_RESOLUTION);
     ledcSetup(MOTOR_B_PWM_CHANNEL, PWM_FREQ, PWM_RESOLUTION);
@@ -19,15 +36,12 @@ bool HAL::init() {
     ledcAttachPin(Pins::LED_GREEN, RGB_G_PWM_CHANNEL);
     ledcAttachPin(Pins::LED_BLUE, RGB_B_PWM_CHANNEL);
     
-    // Motor direction pins (digital)
-    pinMode(Pins::MOTOR_A_IN1, OUTPUT);
-    pinMode(Pins::MOTOR_A_IN2, OUTPUT);
-    pinMode(Pins::MOTOR_B_IN1, OUTPUT);
-    pinMode(Pins::MOTOR_B_IN2, OUTPUT);
-    
-    // TB6612FNG Standby pin - HIGH to enable motor driver
-    pinMode(Pins::MOTOR_STBY, OUTPUT);
-    digitalWrite(Pins::MOTOR_STBY, HIGH); // Enable motor driver
+    // Everything is at a defined low now: release the latch (no-op on a
+    // cold boot). Direction pins are outputs from the loop above.
+    for (int pin : SLEEP_HOLD_PINS) {
+        gpio_hold_dis((gpio_num_t)pin);
+    }
+    gpio_deep_sleep_hold_dis();
     
     // Ultrasonic sensor pins
     pinMode(Pins::US_TRIGGER, OUTPUT);
@@ -40,17 +54,33 @@ bool HAL::init() {
     // Battery sense pin (ADC)
     // ADC is configured automatically when analogRead is called
     
-    // Initialize motors stopped
+    // Initialize motors stopped, then wake the driver
     stopMotors();
     
-    // Test RGB (quick flash to show init complete)
-    setRGB(255, 0, 0);
-    delay(100);
-    setRGB(0, 0, 0);
+    // TB6612FNG Standby pin - HIGH to enable motor driver
+    digitalWrite(Pins::MOTOR_STBY, HIGH);
     
     return true;
 }
 
+void HAL::prepareForSleep() {
+    // PWM stops in deep sleep and the pads would float: drive everything low
+    // (driver disabled, both bridges off) and hold it until init() releases it
+    stopMotors();
+    setRGB(0, 0, 0);
+    ledcDetachPin(Pins::MOTOR_A_EN);
+    ledcDetachPin(Pins::MOTOR_B_EN);
+    ledcDetachPin(Pins::LED_RED);
+    ledcDetachPin(Pins::LED_GREEN);
+    ledcDetachPin(Pins::LED_BLUE);
+    for (int pin : SLEEP_HOLD_PINS) {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+        gpio_hold_en((gpio_num_t)pin);
+    }
+    gpio_deep_sleep_hold_en();
+}
+
 // ============================================================================
 // LED CONTROL
 // ============================================================================
@@ -60,9 +90,17 @@ void HAL::setLED(bool state) {
 }
 
 void HAL::setRGB(uint8_t r, uint8_t g, uint8_t b) {
-    ledcWrite(RGB_R_PWM_CHANNEL, r);
-    ledcWrite(RGB_G_PWM_CHANNEL, g);
-    ledcWrite(RGB_B_PWM_CHANNEL, b);
+    ledcWrite(RGB_R_PWM_CHANNEL, r * ledBrightness / 100);
+    ledcWrite(RGB_G_PWM_CHANNEL, g * ledBrightness / 100);
+    ledcWrite(RGB_B_PWM_CHANNEL, b * ledBrightness / 100);
+}
+
+void HAL::setLedBrightness(int percent) {
+    ledBrightness = constrain(percent, 0, 100);
+}
+
+int HAL::getLedBrightness() {
+    return ledBrightness;
 }
 
 // ============================================================================
@@ -70,7 +108,7 @@ void HAL::setRGB(uint8_t r, uint8_t g, uint8_t b) {
 // ============================================================================
 
 void HAL::setMotorA(int speed, bool forward) {
-    speed = constrain(speed, 0, 255);
+    speed = constrain(speed, 0, 255) * motorLimit / 100;
     
     // Set direction
     digitalWrite(Pins::MOTOR_A_IN1, forward ? HIGH : LOW);
@@ -78,10 +116,11 @@ void HAL::setMotorA(int speed, bool forward) {
     
     // Set speed with hardware PWM
     ledcWrite(MOTOR_A_PWM_CHANNEL, speed);
+    traceMotor(0, speed, forward);
 }
 
 void HAL::setMotorB(int speed, bool forward) {
-    speed = constrain(speed, 0, 255);
+    speed = constrain(speed, 0, 255) * motorLimit / 100;
     
     // Set direction
     digitalWrite(Pins::MOTOR_B_IN1, forward ? HIGH : LOW);
@@ -89,6 +128,7 @@ void HAL::setMotorB(int speed, bool forward) {
     
     // Set speed with hardware PWM
     ledcWrite(MOTOR_B_PWM_CHANNEL, speed);
+    traceMotor(1, speed, forward);
 }
 
 void HAL::stopMotors() {
@@ -99,6 +139,8 @@ void HAL::stopMotors() {
     digitalWrite(Pins::MOTOR_A_IN2, LOW);
     digitalWrite(Pins::MOTOR_B_IN1, LOW);
     digitalWrite(Pins::MOTOR_B_IN2, LOW);
+    traceMotor(0, 0, true);
+    traceMotor(1, 0, true);
 }
 
 void HAL::brakeMotors() {
@@ -110,12 +152,38 @@ void HAL::brakeMotors() {
     digitalWrite(Pins::MOTOR_A_IN2, HIGH);
     digitalWrite(Pins::MOTOR_B_IN1, HIGH);
     digitalWrite(Pins::MOTOR_B_IN2, HIGH);
+    traceMotor(0, 0, true);
+    traceMotor(1, 0, true);
 }
 
 void HAL::coastMotors() {
     // Coast - just disable PWM, let motors spin down naturally
     ledcWrite(MOTOR_A_PWM_CHANNEL, 0);
     ledcWrite(MOTOR_B_PWM_CHANNEL, 0);
+    traceMotor(0, 0, true);
+    traceMotor(1, 0, true);
+}
+
+void HAL::traceMotor(int motor, int speed, bool forward) {
+    motorCause[motor] = latencyTracer.onMotorCommand(motor, speed, forward);
+}
+
+uint32_t HAL::getMotorCause(int motor) {
+    return motorCause[motor & 1];
+}
+
+void HAL::setMotorLimit(int percent) {
+    // Applies from the next command; callers re-issue their current one.
+    // Zero also cuts the outputs at once (the deadline monitor's hold).
+    motorLimit = constrain(percent, 0, 100);
+    if (motorLimit == 0) {
+        ledcWrite(MOTOR_A_PWM_CHANNEL, 0);
+        ledcWrite(MOTOR_B_PWM_CHANNEL, 0);
+    }
+}
+
+int HAL::getMotorLimit() {
+    return motorLimit;
 }
 
 // ============================================================================
@@ -134,6 +202,16 @@ long HAL::measurePulse() {
     return pulseIn(Pins::US_ECHO, HIGH, US_TIMEOUT);
 }
 
+int HAL::pingUltrasonic() {
+    long duration = measurePulse();
+    
+    // Timeout means no echo within range
+    if (duration == 0) {
+        return US_MAX_DISTANCE;
+    }
+    return constrain((int)(duration / 58), 2, US_MAX_DISTANCE);
+}
+
 int HAL::readUltrasonic() {
     // Use a median filter to reject noise and get a stable reading.
     const int numReadings = 5;
@@ -165,16 +243,21 @@ int HAL::readUltrasonic() {
 // ============================================================================
 
 float HAL::readBatteryVoltage() {
+    return batteryRawToVoltage(readBatteryRaw());
+}
+
+int HAL::readBatteryRaw() {
     // Read ADC value (0-4095 for 12-bit ADC)
-    int adcValue = analogRead(Pins::BATTERY_SENSE);
-    
+    return analogRead(Pins::BATTERY_SENSE);
+}
+
+float HAL::batteryRawToVoltage(int adcValue) {
     // This ratio is calculated by measuring the actual battery voltage with a
     // multimeter and dividing it by the raw ADC value reported by the calibration
     // sketch. This accounts for all hardware variations.
     // Example: 7.65V / 2350 ADC = 0.003255
-    const float ADC_TO_VOLTAGE_RATIO = 0.001788; // Recalibrated: 7.32V / 4095 ADC
-    
-    float voltage = adcValue * ADC_TO_VOLTAGE_RATIO;
+    // Settable at runtime as adc.battery_ratio (see params.h)
+    float voltage = adcValue * adcCalibration.batteryVoltsPerCount;
     
     return voltage;
 }
@@ -0,0 +1,196 @@
+#include "hibernate.h"
+#include "logger.h"
+#include "flight_recorder.h"
+#include <esp_sleep.h>
+
+// ============================================================================
+// RTC STATE (kept through deep sleep, re-initialized on any other boot)
+// ============================================================================
+
+static const uint32_t RTC_MAGIC = 0x454D4231;   // "EMB1"
+
+// Estimated draw while asleep: ESP32 deep sleep is ~10 uA, but the DevKit
+// regulator and the battery/LDR dividers stay powered. Measure and adjust.
+static const float SLEEP_CURRENT_MA = 2.0f;
+
+struct HibernateState {
+    uint32_t magic;
+    bool enabled;
+    bool hibernating;
+    bool phototropismOn;
+    uint8_t controller;
+    float threshold;
+    uint32_t intervalS;
+    
+    MotorConfig motorConfig;
+    AdcCalibration adc;         // The wake sample runs before the NVS load
+    float soc;
+    float chargeUsedMah;
+    EnergyModel::Snapshot energy;
+    
+    uint32_t hibernations;
+    uint32_t wakes;
+    uint32_t darkWakes;
+    uint32_t sleptS;            // Timer intervals slept this hibernation
+    uint32_t totalSleptS;
+};
+
+static RTC_DATA_ATTR HibernateState rtc = {
+    RTC_MAGIC, false, false, false, 0, 0.7f, 60,
+    MotorConfig(), AdcCalibration(), 0.0f, 0.0f, { EnergyModel::FULL, 0, 0, true },
+    0, 0, 0, 0, 0
+};
+
+Hibernate::Hibernate(HAL& halRef, Movement& moveRef, LDRSensor& ldrRef, Phototropism& photoRef,
+                     MotorConfig& cfgRef, BatteryEstimator& batteryRef, EnergyModel& energyRef)
+    : hal(halRef), movement(moveRef), ldrSensor(ldrRef), phototropism(photoRef),
+      config(cfgRef), battery(batteryRef), energy(energyRef) {
+}
+
+// ============================================================================
+// WAKE PATH (top of setup)
+// ============================================================================
+
+Hibernate::Wake Hibernate::resume() {
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    if (cause == ESP_SLEEP_WAKEUP_UNDEFINED || rtc.magic != RTC_MAGIC) {
+        wake = COLD_BOOT;
+        return wake;
+    }
+    if (!rtc.hibernating) {
+        wake = WARM_OTHER;
+        return wake;
+    }
+    
+    rtc.wakes++;
+    if (cause == ESP_SLEEP_WAKEUP_TIMER) {
+        rtc.sleptS += rtc.intervalS;
+        rtc.totalSleptS += rtc.intervalS;
+    }
+    
+    adcCalibration = rtc.adc;
+    if (sampleBrightness() < rtc.threshold) {
+        rtc.darkWakes++;
+        sleep();    // Does not return
+    }
+    
+    rtc.hibernating = false;
+    wake = WARM_LIGHT;
+    return wake;
+}
+
+bool Hibernate::isWarm() {
+    return wake != COLD_BOOT;
+}
+
+float Hibernate::sampleBrightness() {
+    // Fill the LDR filter straight from the ADC: no HAL init or sensor task yet
+    for (int i = 0; i < 5; i++) {
+        ldrSensor.ingest(hal.readLDR_Left(), hal.readLDR_Right());
+    }
+    return (ldrSensor.getLeftBrightness() + ldrSensor.getRightBrightness()) / 2.0f;
+}
+
+void Hibernate::restore() {
+    if (wake != WARM_LIGHT) return;
+    
+    config = rtc.motorConfig;
+    adcCalibration = rtc.adc;
+    
+    float drainMah = SLEEP_CURRENT_MA * rtc.sleptS / 3600.0f;
+    float drainPercent = drainMah / battery.getCapacity() * 100.0f;
+    battery.restore(rtc.soc - drainPercent, rtc.chargeUsedMah + drainMah);
+    energy.restore(rtc.energy, rtc.sleptS * 1000);
+    
+    if (rtc.phototropismOn && energy.isAlive()) {
+        phototropism.setController((Phototropism::Controller)rtc.controller);
+        phototropism.enable();
+    }
+    
+    Serial.printf("🌅 Warm resume: light after %lu s asleep (%lu dark wakes)\n",
+                  (unsigned long)rtc.sleptS, (unsigned long)rtc.darkWakes);
+    rtc.sleptS = 0;
+}
+
+// ============================================================================
+// ENTERING HIBERNATE
+// ============================================================================
+
+void Hibernate::update(bool busy) {
+    if (!rtc.enabled || busy || !phototropism.isEnabled() ||
+        phototropism.getState() != Phototropism::IDLE || movement.isMoving()) {
+        darkSince = 0;
+        return;
+    }
+    
+    if (darkSince == 0) {
+        darkSince = millis();
+    } else if (millis() - darkSince >= DARK_HOLD_MS) {
+        enter();
+    }
+}
+
+void Hibernate::enter() {
+    rtc.magic = RTC_MAGIC;
+    rtc.hibernating = true;
+    rtc.phototropismOn = phototropism.isEnabled();
+    rtc.controller = (uint8_t)phototropism.getController();
+    rtc.threshold = phototropism.getLightThreshold();
+    rtc.motorConfig = config;
+    rtc.adc = adcCalibration;
+    rtc.soc = battery.getSoc();
+    rtc.chargeUsedMah = battery.getChargeUsedMah();
+    rtc.energy = energy.snapshot();
+    rtc.hibernations++;
+    rtc.sleptS = 0;
+    rtc.darkWakes = 0;
+    
+    logger.flush();
+    flightRecorder.flush();
+    Serial.printf("😴 Dark for %lus - hibernating, checking the light every %lus\n",
+                  DARK_HOLD_MS / 1000, (unsigned long)rtc.intervalS);
+    Serial.flush();
+    
+    movement.stop();
+    hal.prepareForSleep();
+    sleep();
+}
+
+void Hibernate::sleep() {
+    esp_sleep_enable_timer_wakeup((uint64_t)rtc.intervalS * 1000000ULL);
+    esp_deep_sleep_start();
+}
+
+// ============================================================================
+// SETTINGS
+// ============================================================================
+
+void Hibernate::setEnabled(bool on) {
+    rtc.magic = RTC_MAGIC;
+    rtc.enabled = on;
+    darkSince = 0;
+}
+
+bool Hibernate::isEnabled() {
+    return rtc.enabled;
+}
+
+void Hibernate::setInterval(uint32_t seconds) {
+    rtc.intervalS = constrain(seconds, (uint32_t)5, (uint32_t)3600);
+}
+
+void Hibernate::printStatus() {
+    Serial.println("\n--- Hibernate ---");
+    Serial.printf("  Mode: %s, wake check every %lus, threshold %.2f\n",
+                  rtc.enabled ? "ENABLED" : "disabled", (unsigned long)rtc.intervalS,
+                  phototropism.getLightThreshold());
+    if (darkSince != 0) {
+        Serial.printf("  Dark and idle for %lus of %lus\n",
+                      (millis() - darkSince) / 1000, DARK_HOLD_MS / 1000);
+    }
+    Serial.printf("  This boot: %s\n", wake == WARM_LIGHT ? "warm resume (light)" :
+                  wake == WARM_OTHER ? "warm (other wake)" : "cold");
+    Serial.printf("  Hibernations: %lu, wakes: %lu, slept %lu min total\n",
+                  (unsigned long)rtc.hibernations, (unsigned long)rtc.wakes,
+                  (unsigned long)(rtc.totalSleptS / 60));
+}
@@ -0,0 +1,189 @@
+#include "logger.h"
+#include "protocol_link.h"
+#include "serial_tx.h"
+
+Logger logger;
+
+static const char* resolvePointer(uint32_t value, void*) {
+    return (const char*)(uintptr_t)value;
+}
+
+Logger::Logger() {
+    for (size_t i = 0; i < RING_SIZE; i++) {
+        ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool Logger::begin(uint8_t core) {
+    // Priority 1 on core 0: below the sensor task, never competing with loop()
+    BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "log", 4096, this, 1, &handle, core);
+    if (ok != pdPASS) {
+        handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// PRODUCERS (any task, either core)
+// ============================================================================
+
+void Logger::push(uint8_t level, const char* fmt, const Arg* args, uint8_t count) {
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &ring[pos & (RING_SIZE - 1)];
+        int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);     // Full
+            return;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record& r = slot->record;
+    r.timeMs = millis();
+    r.fmt = fmt;
+    r.level = level;
+    r.count = count;
+    r.types = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        r.args[i] = args[i].value;
+        r.types |= args[i].type << (i * 2);
+    }
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    uint32_t depth = pos + 1 - tail.load(std::memory_order_relaxed);
+    if (depth > highWater) highWater = depth;
+    if (handle) xTaskNotifyGive(handle);
+}
+
+// ============================================================================
+// CONSUMER (log task)
+// ============================================================================
+
+bool Logger::pop(Record& out) {
+    uint32_t pos = tail.load(std::memory_order_relaxed);
+    Slot& slot = ring[pos & (RING_SIZE - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != pos + 1) return false;
+    out = slot.record;
+    slot.seq.store(pos + RING_SIZE, std::memory_order_release);
+    tail.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::taskEntry(void* param) {
+    Logger* self = static_cast<Logger*>(param);
+    Record r;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        while (self->pop(r)) {
+            self->emit(r);
+        }
+        uint32_t lost = self->dropped.load(std::memory_order_relaxed);
+        if (lost != self->reportedDrops && self->output == OUTPUT_TEXT) {
+            int n = snprintf(self->line, LINE_SIZE, "⚠ log: %lu record(s) dropped (ring full)\n",
+                             (unsigned long)(lost - self->reportedDrops));
+            serialTx.write((const uint8_t*)self->line, n);
+        }
+        self->reportedDrops = lost;
+    }
+}
+
+void Logger::emit(const Record& r) {
+    switch (output) {
+        case OUTPUT_TEXT:   emitText(r); break;
+        case OUTPUT_BINARY: emitBinary(r); break;
+        case OUTPUT_OFF:    break;
+    }
+    written++;
+}
+
+void Logger::emitText(const Record& r) {
+    // Stamped with the time of the call, not of the write
+    size_t n = snprintf(line, LINE_SIZE, "[%lu.%03lu] ", (unsigned long)(r.timeMs / 1000),
+                        (unsigned long)(r.timeMs % 1000));
+    n += LogFormat::format(line + n, LINE_SIZE - n - 1, r.fmt, r.args, r.types, r.count,
+                           resolvePointer, nullptr);
+    // Call sites keep the trailing newline they had as Serial.printf()s
+    if (n == 0 || line[n - 1] != '\n') line[n++] = '\n';
+    serialTx.write((const uint8_t*)line, n);
+}
+
+void Logger::emitBinary(const Record& r) {
+    // Restart the table rather than run out of ids mid-record
+    if (dictionaryStale || dictCount + 1 + r.count > DICT_SIZE) {
+        dictCount = 0;
+        dictionaryStale = false;
+    }
+
+    Protocol::LogRecordPayload p;
+    p.timeMs = r.timeMs;
+    p.formatId = lookup(r.fmt);
+    p.level = r.level;
+    p.count = r.count;
+    p.reserved = 0;
+    p.types = r.types;
+    for (uint8_t i = 0; i < LogFormat::MAX_ARGS; i++) {
+        p.args[i] = 0;
+        if (i >= r.count) continue;
+        p.args[i] = LogFormat::argType(r.types, i) == LogFormat::ARG_STR ?
+                    lookup((const char*)(uintptr_t)r.args[i]) : r.args[i];
+    }
+    protocolLink.sendFrame(Protocol::LOG_RECORD, &p, sizeof(p));
+}
+
+uint8_t Logger::lookup(const char* str) {
+    for (int i = 0; i < dictCount; i++) {
+        if (dict[i] == str) return i;
+    }
+    uint8_t id = dictCount;
+    dict[dictCount++] = str;
+
+    // Send the text in chunks, terminating NUL included (max 255 bytes)
+    size_t len = strlen(str) + 1;
+    if (len > 255) len = 255;
+    Protocol::LogFormatPayload p;
+    p.id = id;
+    for (size_t offset = 0; offset < len; offset += Protocol::LOG_CHUNK) {
+        size_t n = len - offset < Protocol::LOG_CHUNK ? len - offset : Protocol::LOG_CHUNK;
+        p.offset = offset;
+        memcpy(p.text, str + offset, n);
+        if (offset + n == len) p.text[n - 1] = '\0';
+        protocolLink.sendFrame(Protocol::LOG_FORMAT, &p, 2 + n);
+    }
+    return id;
+}
+
+// ============================================================================
+// CONTROL
+// ============================================================================
+
+void Logger::setOutput(Output out) {
+    // Resend every string: the host may have just connected
+    if (out == OUTPUT_BINARY) dictionaryStale = true;
+    output = out;
+}
+
+void Logger::flush(uint32_t maxMs) {
+    unsigned long start = millis();
+    while (tail.load(std::memory_order_acquire) != head.load(std::memory_order_acquire) &&
+           millis() - start < maxMs) {
+        delay(1);
+    }
+    if (output == OUTPUT_TEXT) Serial.flush();
+}
+
+void Logger::printStatus() {
+    static const char* const outputs[] = { "text", "binary frames", "off" };
+    static const char* const levels[] = { "off", "error", "warn", "info", "debug" };
+    Serial.println("\n--- Log ---");
+    Serial.printf("  Level: %s (compile-time), output: %s, task %s\n", levels[EMBER_LOG_LEVEL],
+                  outputs[output], handle ? "running" : "NOT running");
+    Serial.printf("  Records: %lu written, %lu dropped, ring peak %lu / %u\n",
+                  (unsigned long)written, (unsigned long)dropped.load(),
+                  (unsigned long)highWater, (unsigned)RING_SIZE);
+}
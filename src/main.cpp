@@ -5,6 +5,30 @@
 #include "status.h"
 #include "sensors.h"
 #include "behaviors.h"
+#include "odometry.h"
+#include "bearing.h"
+#include "stuck_detector.h"
+#include "wander.h"
+#include "sensor_task.h"
+#include "profiler.h"
+#include "trace.h"
+#include "transition_log.h"
+#include "deadline_monitor.h"
+#include "resource_monitor.h"
+#include "event_loop.h"
+#include "power_manager.h"
+#include "hibernate.h"
+#include "protocol_link.h"
+#include "cli.h"
+#include "telemetry_stream.h"
+#include "logger.h"
+#include "params.h"
+#include "genome.h"
+#include "energy_model.h"
+#include "flight_recorder.h"
+#include "postmortem.h"
+#include "boot_timeline.h"
+#include "serial_tx.h"
 #include "pins.h"
 
 // ============================================================================
@@ -13,12 +37,101 @@
 
 HAL hal;
 MotorConfig motorConfig;
+AdcCalibration adcCalibration;
 Movement movement(hal, motorConfig);
 StatusLED status(hal);
 UltrasonicSensor sensor(hal);
 LDRSensor ldrSensor(hal);
-ObstacleAvoidance autonomousMode(hal, movement, sensor, status, motorConfig);
-Phototropism phototropismMode(hal, movement, status, ldrSensor);  // 
+SensorTask sensorTask(hal, sensor, ldrSensor);
+BatteryEstimator batteryEstimator(hal, movement, sensorTask);
+PowerManager powerManager(hal, movement, sensorTask, batteryEstimator);
+Odometry odometry(movement, motorConfig);
+LightBearing lightBearing(movement, ldrSensor, odometry);
+StuckDetector stuckDetector(hal, movement, odometry, sensor, ldrSensor, sensorTask);
+Wander wander(movement, odometry);
+CoverageMap coverage(odometry);
+ObstacleAvoidance autonomousMode(hal, movement, sensor, ldrSensor, status, motorConfig, stuckDetector,
+                                 wander);
+Phototropism phototropismMode(hal, movement, status, ldrSensor, odometry, lightBearing);
+LightNavigator navigatorMode(movement, sensor, ldrSensor, status, odometry, lightBearing,
+                             motorConfig, wander);
+GenomeManager genetics(phototropismMode, motorConfig);
+EnergyModel energyModel(ldrSensor, movement, sensor, genetics);
+Hibernate hibernate(hal, movement, ldrSensor, phototropismMode, motorConfig, batteryEstimator,
+                    energyModel);
+TelemetryStream telemetryStream(ldrSensor, sensor, movement, batteryEstimator, powerManager,
+                                energyModel);
+
+// Registered in setup(): deadlineMonitor may not be constructed yet at static init
+int loopDeadline = -1;
+
+// Console baud; the binary link can raise it at runtime (CMD_BAUD)
+#ifndef EMBER_SERIAL_BAUD
+#define EMBER_SERIAL_BAUD 115200
+#endif
+
+// Room for the whole boot log, so printing it never stalls the loop
+#ifndef EMBER_SERIAL_TX_BUFFER
+#define EMBER_SERIAL_TX_BUFFER 2048
+#endif
+
+// Binary DRIVE commands stop the motors unless refreshed in time
+unsigned long driveDeadline = 0;
+
+// Keep the clock up for a while after the last console command
+const unsigned long CONSOLE_ACTIVE_MS = 5000;
+unsigned long lastCommandMs = 0;
+
+// ============================================================================
+// PARAMETERS
+// ============================================================================
+// Registered before the NVS load: each field's compiled-in value is its default.
+// Fields the genome sets (GenomeManager::apply: light threshold, seek delta,
+// seek/approach speed, base speed) are not registered; the genome owns them.
+
+void registerParameters() {
+    params.add("motor.crawl", &motorConfig.crawlSpeed, 0, 255, "Crawl PWM");
+    params.add("motor.max", &motorConfig.maxSpeed, 0, 255, "Run PWM");
+    params.add("motor.turn_ms", &motorConfig.turnDuration, 100, 5000, "ms for a ~90° spin (odometry)");
+    params.add("motor.cruise_cms", &motorConfig.cruiseSpeedCmS, 1, 200, "Ground speed at base PWM, cm/s");
+    params.add("motor.a_inverted", &motorConfig.motorA_inverted, "Motor A wired reversed");
+    params.add("motor.b_inverted", &motorConfig.motorB_inverted, "Motor B wired reversed");
+    params.add("motor.a_trim", &motorConfig.motorA_trim, -50, 50, "Motor A PWM trim");
+    params.add("motor.b_trim", &motorConfig.motorB_trim, -50, 50, "Motor B PWM trim");
+
+    RangeThresholds& range = sensor.getThresholds();
+    params.add("range.stop_cm", &range.stopDistance, 5, 100, "Obstacle stop distance");
+    params.add("range.warn_cm", &range.warnDistance, 10, 200, "Slow-down distance");
+
+    PhototropismParams& photo = phototropismMode.getParams();
+    params.add("photo.balance", &photo.balanceThreshold, 0.0f, 0.3f, "Bang-bang centred difference");
+
+    params.add("avoid.ldr_threshold", &autonomousMode.getParams().ldrThreshold, 0, 4095,
+               "LDR difference worth veering for");
+
+    WanderParams& walk = wander.getParams();
+    params.add("wander.speed", &walk.speed, 0, 255, "Step PWM");
+    params.add("wander.persistence", &walk.persistence, 0.0f, 1.0f, "Turn shrink toward heading");
+    params.add("wander.turn_sigma", &walk.turnSigma, 0.0f, 180.0f, "Correlated walk turn spread, deg");
+    params.add("wander.levy_mu", &walk.levyMu, 1.1f, 3.0f, "Levy step exponent");
+    params.add("wander.min_step_cm", &walk.minStepCm, 1.0f, 500.0f, "Shortest step");
+    params.add("wander.max_step_cm", &walk.maxStepCm, 1.0f, 1000.0f, "Longest step");
+
+    params.add("adc.dark_left", &adcCalibration.darkLeft, 0.0f, 1.0f, "Left LDR reading in darkness");
+    params.add("adc.light_left", &adcCalibration.lightLeft, 0.0f, 1.0f, "Left LDR reading in light");
+    params.add("adc.dark_right", &adcCalibration.darkRight, 0.0f, 1.0f, "Right LDR reading in darkness");
+    params.add("adc.light_right", &adcCalibration.lightRight, 0.0f, 1.0f, "Right LDR reading in light");
+    params.add("adc.battery_ratio", &adcCalibration.batteryVoltsPerCount, 0.0005f, 0.005f,
+               "Pack volts per ADC count");
+
+    params.add("rec.rate_hz", &flightRecorder.getParams().rateHz, 0, FlightRecorder::MAX_RATE_HZ,
+               "Flight recorder rate (0 = off)");
+
+    params.requireNotAbove("range.stop_cm", "range.warn_cm");
+    params.requireNotAbove("wander.min_step_cm", "wander.max_step_cm");
+    params.requireApart("adc.dark_left", "adc.light_left", 0.01f);     // mapBrightness divides by the span
+    params.requireApart("adc.dark_right", "adc.light_right", 0.01f);
+}
 
 // ============================================================================
 // TEST SEQUENCES
@@ -141,46 +254,6 @@ void runRGBTest() {
     Serial.println("✓ RGB test complete\n");
 }
 
-void printHelp() {
-    Serial.println("\n╔════════════════════════════════════════╗");
-    Serial.println("║          EMBER COMMAND HELP           ║");
-    Serial.println("╚════════════════════════════════════════╝");
-    Serial.println();
-    Serial.println("Basic Movement:");
-    Serial.println("  f/F - Forward       b/B - Backward");
-    Serial.println("  r/R - Turn Right");
-    Serial.println("  < - Spin CCW        > - Spin CW");
-    Serial.println("  c/C - Crawl (slow)  m/M - Run (fast)");
-    Serial.println();
-    Serial.println("Control:");
-    Serial.println("  s/S - Stop (disables autonomous)");
-    Serial.println("  SPACE - Emergency stop");
-    Serial.println();
-    Serial.println("Smooth Movement:");
-    Serial.println("  w/W - Smooth Forward");
-    Serial.println("  x/X - Smooth Backward");
-    Serial.println("  q/Q - Smooth Stop");
-    Serial.println();
-    Serial.println("Test Sequences:");
-    Serial.println("  t/T - Basic movement test");
-    Serial.println("  y/Y - Smooth movement test");
-    Serial.println("  g/G - RGB LED test");
-    Serial.println();
-    Serial.println("Information:");
-    Serial.println("  h/H - This help menu");
-    Serial.println("  i/I - Show system info");
-    Serial.println();
-    Serial.println("Sensors:");
-    Serial.println("  u/U - Read ultrasonic");
-    Serial.println("  l/L - Read LDR sensors (light)");
-    Serial.println("  p/P - Show sensor status (dist, stuck, batt)");
-    Serial.println("  j/J - Show motor driver pin status");
-    Serial.println();
-    Serial.println("Autonomous:");
-    Serial.println("  a/A - Toggle autonomous mode");
-    Serial.println("  k/K - Toggle phototropism mode (light seeking)"); 
-}
-
 void printSystemInfo() {
     Serial.println("\n╔════════════════════════════════════════╗");
     Serial.println("║         EMBER SYSTEM INFO             ║");
@@ -191,7 +264,8 @@ void printSystemInfo() {
     Serial.printf("  Cores: %d\n", ESP.getChipCores());
     Serial.printf("  CPU Freq: %d MHz\n", ESP.getCpuFreqMHz());
     Serial.printf("  Flash: %d MB\n", ESP.getFlashChipSize() / 1048576);
-    Serial.printf("  Free Heap: %d KB\n", ESP.getFreeHeap() / 1024);
+    Serial.printf("  Free Heap: %d KB (lowest %d KB)\n", ESP.getFreeHeap() / 1024,
+                  ESP.getMinFreeHeap() / 1024);
     Serial.println();
     Serial.println("Motor Configuration:");
     Serial.printf("  Base Speed: %d\n", motorConfig.baseSpeed);
@@ -203,6 +277,9 @@ void printSystemInfo() {
     Serial.printf("  Motor A Trim: %+d\n", motorConfig.motorA_trim);
     Serial.printf("  Motor B Trim: %+d\n", motorConfig.motorB_trim);
     Serial.println();
+    Serial.println("Parameters:");
+    params.printStatus();
+    Serial.println();
     Serial.println("Current State:");
     Serial.printf("  Moving: %s\n", movement.isMoving() ? "Yes" : "No");
     Serial.printf("  Speed: %d\n", movement.getCurrentSpeed());
@@ -230,6 +307,14 @@ void printMotorDriverStatus() {
     Serial.println("\nSpeed (PWM) and Standby:");
     // Note: We can't directly read the PWM value, but we can check STBY
     Serial.printf("  STBY Pin (13): %s\n", digitalRead(Pins::MOTOR_STBY) ? "HIGH (Enabled)" : "LOW (DISABLED!)");
+    for (int m = 0; m < 2; m++) {
+        uint32_t cause = hal.getMotorCause(m);
+        if (cause == LatencyTracer::NO_CAUSE) {
+            Serial.printf("  Motor %c caused by sample: - (not a traced reaction)\n", 'A' + m);
+        } else {
+            Serial.printf("  Motor %c caused by sample: #%lu\n", 'A' + m, (unsigned long)cause);
+        }
+    }
     Serial.println("\nHidden State (from Movement class):");
     Serial.printf("  Current Speed: %d\n", movement.getCurrentSpeed());
     Serial.printf("  Is Moving: %s\n", movement.isMoving() ? "Yes" : "No");
@@ -237,33 +322,881 @@ void printMotorDriverStatus() {
 }
 
 // ============================================================================
-// SETUP
+// BINARY PROTOCOL
 // ============================================================================
 
-void setup() {
-    Serial.begin(115200);
-    delay(1000); // Give serial time to stabilize
+// A dead bot (energy 0) stays still until "revive": everything that would
+// drive it, from the console or the link, asks here first
+bool refuseWhenDead() {
+    if (energyModel.isAlive()) return false;
+    Serial.println("💀 Dead (energy 0) - use 'revive' first");
+    return true;
+}
+
+// Autonomous, phototropism and the navigator each own the motors: enabling one
+// makes the others step aside, so only one of them drives in a loop pass
+void stopMotorModes() {
+    if (autonomousMode.isEnabled()) autonomousMode.disable();
+    if (phototropismMode.isEnabled()) phototropismMode.disable();
+    if (navigatorMode.isEnabled()) navigatorMode.disable();
+}
+
+void emergencyStop() {
+    lightBearing.cancel();
+    autonomousMode.disable();
+    phototropismMode.disable();
+    navigatorMode.disable();
+    movement.stop();
+    driveDeadline = 0;
+    status.setStatus(StatusLED::READY);
+}
+
+uint8_t handleBinaryCommand(uint8_t type, const uint8_t* payload, size_t len) {
+    lastCommandMs = millis();
     
-    // Show we're booting
-    status.setStatus(StatusLED::BOOTING);
+    switch (type) {
+        case Protocol::CMD_STOP:
+            Serial.println("🛑 EMERGENCY STOP (link)");
+            emergencyStop();
+            return Protocol::ACK_OK;
+            
+        case Protocol::CMD_DRIVE: {
+            if (len != sizeof(Protocol::DrivePayload)) return Protocol::ACK_BAD_LENGTH;
+            Protocol::DrivePayload p;
+            memcpy(&p, payload, sizeof(p));
+            // Direct drive and the autonomous modes would fight over the motors
+            if (autonomousMode.isEnabled() || phototropismMode.isEnabled() ||
+                navigatorMode.isEnabled()) {
+                return Protocol::ACK_REJECTED;
+            }
+            if ((p.linear != 0 || p.angular != 0) && refuseWhenDead()) {
+                return Protocol::ACK_DEAD;
+            }
+            movement.setTwist(p.linear, p.angular);
+            driveDeadline = p.timeoutMs ? millis() + p.timeoutMs : 0;
+            status.setStatus(movement.isMoving() ? StatusLED::MOVING : StatusLED::READY);
+            return Protocol::ACK_OK;
+        }
+        
+        case Protocol::CMD_MODE: {
+            if (len != sizeof(Protocol::ModePayload)) return Protocol::ACK_BAD_LENGTH;
+            Protocol::ModePayload p;
+            memcpy(&p, payload, sizeof(p));
+            bool drives = p.mode == Protocol::MODE_AUTONOMOUS || p.mode == Protocol::MODE_PHOTOTROPISM ||
+                          p.mode == Protocol::MODE_NAVIGATOR;
+            if (p.enable && drives && refuseWhenDead()) return Protocol::ACK_DEAD;
+            switch (p.mode) {
+                case Protocol::MODE_AUTONOMOUS:
+                    if (p.enable == autonomousMode.isEnabled()) break;
+                    if (p.enable) {
+                        stopMotorModes();
+                        wander.seed(wander.getParams().seed);
+                        coverage.start();
+                        autonomousMode.enable();
+                    } else {
+                        autonomousMode.disable();
+                    }
+                    break;
+                case Protocol::MODE_PHOTOTROPISM:
+                    if (p.enable && !phototropismMode.isEnabled()) {
+                        stopMotorModes();
+                        phototropismMode.enable();
+                    }
+                    if (!p.enable && phototropismMode.isEnabled()) phototropismMode.disable();
+                    break;
+                case Protocol::MODE_NAVIGATOR:
+                    if (p.enable && !navigatorMode.isEnabled()) {
+                        stopMotorModes();
+                        navigatorMode.enable();
+                    }
+                    if (!p.enable && navigatorMode.isEnabled()) navigatorMode.disable();
+                    break;
+                case Protocol::MODE_HIBERNATE:
+                    hibernate.setEnabled(p.enable);
+                    break;
+                default:
+                    return Protocol::ACK_REJECTED;
+            }
+            return Protocol::ACK_OK;
+        }
+        
+        default:
+            return Protocol::ACK_UNKNOWN_TYPE;
+    }
+}
+
+void recordFlightSample() {
+    FlightRecorder::Sample s;
+    s.values[FlightRecorder::F_DISTANCE] = sensor.getDistance();
+    s.values[FlightRecorder::F_LIGHT_LEFT] = ldrSensor.getLeftBrightness() * 1000;
+    s.values[FlightRecorder::F_LIGHT_RIGHT] = ldrSensor.getRightBrightness() * 1000;
+    s.values[FlightRecorder::F_WHEEL_A] = movement.getWheelSpeedA();
+    s.values[FlightRecorder::F_WHEEL_B] = movement.getWheelSpeedB();
+    s.values[FlightRecorder::F_ENERGY] = energyModel.getEnergyTenths();
+    s.values[FlightRecorder::F_BEHAVIOR] = FlightRecorder::packBehavior(
+        (autonomousMode.isEnabled() ? 1 : 0) | (phototropismMode.isEnabled() ? 2 : 0) |
+        (navigatorMode.isEnabled() ? 4 : 0),
+        autonomousMode.getState(), phototropismMode.getState(), navigatorMode.getState());
+    s.values[FlightRecorder::F_BATTERY] = batteryEstimator.getVoltage() * 100;
+    s.values[FlightRecorder::F_POWER] = powerManager.getMode();
+    flightRecorder.record(s);
+}
+
+void sendBinaryTelemetry() {
+    uint8_t mask = protocolLink.getTelemetryMask();
+    uint32_t now = millis();
     
+    if (mask & Protocol::REC_SENSORS) {
+        Protocol::SensorRecord r;
+        r.timeMs = now;
+        r.sampleSeq = sensor.getSampleTag().seq;
+        r.distanceCm = sensor.getDistance();
+        r.rawDistanceCm = sensor.getRawDistance();
+        r.lightLeft = ldrSensor.getLeftBrightness() * 1000;
+        r.lightRight = ldrSensor.getRightBrightness() * 1000;
+        protocolLink.sendTelemetry(Protocol::TLM_SENSORS, &r, sizeof(r));
+    }
+    if (mask & Protocol::REC_MOTORS) {
+        Protocol::MotorRecord r;
+        r.timeMs = now;
+        r.wheelA = movement.getWheelSpeedA();
+        r.wheelB = movement.getWheelSpeedB();
+        r.limitPercent = hal.getMotorLimit();
+        r.reserved = 0;
+        r.headingDeciDeg = (int16_t)(odometry.getHeading() * 10) % 3600;
+        r.xMm = odometry.getX() * 10;
+        r.yMm = odometry.getY() * 10;
+        protocolLink.sendTelemetry(Protocol::TLM_MOTORS, &r, sizeof(r));
+    }
+    if (mask & Protocol::REC_BEHAVIOR) {
+        Protocol::BehaviorRecord r;
+        r.timeMs = now;
+        r.enabledMask = (autonomousMode.isEnabled() ? 1 << (Protocol::MODE_AUTONOMOUS - 1) : 0) |
+                        (phototropismMode.isEnabled() ? 1 << (Protocol::MODE_PHOTOTROPISM - 1) : 0) |
+                        (navigatorMode.isEnabled() ? 1 << (Protocol::MODE_NAVIGATOR - 1) : 0) |
+                        (hibernate.isEnabled() ? 1 << (Protocol::MODE_HIBERNATE - 1) : 0);
+        r.avoidanceState = autonomousMode.getState();
+        r.phototropismState = phototropismMode.getState();
+        r.navigatorState = navigatorMode.getState();
+        r.powerMode = powerManager.getMode();
+        r.clockLevel = eventLoop.getLevel();
+        protocolLink.sendTelemetry(Protocol::TLM_BEHAVIOR, &r, sizeof(r));
+    }
+    if (mask & Protocol::REC_BATTERY) {
+        Protocol::BatteryRecord r;
+        r.timeMs = now;
+        r.measuredMv = batteryEstimator.getVoltage() * 1000;
+        r.openCircuitMv = batteryEstimator.getOpenCircuitVoltage() * 1000;
+        r.socPermille = batteryEstimator.getSoc() * 10;
+        r.minutesLeft = constrain(batteryEstimator.getMinutesLeft(), -1, 32767);
+        r.currentMa = batteryEstimator.getCurrent() * 1000;
+        r.resistanceMilliOhm = batteryEstimator.getInternalResistance() * 1000;
+        protocolLink.sendTelemetry(Protocol::TLM_BATTERY, &r, sizeof(r));
+    }
+}
+
+// ============================================================================
+// CONSOLE COMMANDS
+// ============================================================================
+// One handler per command; the table below maps names, short forms and
+// argument specs onto them (see cli.h). Arguments arrive already parsed.
+
+// ----------------------------------------------------------------------------
+// BASIC MOVEMENT
+// ----------------------------------------------------------------------------
+void cmdForward(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("→ Forward");
+    status.setStatus(StatusLED::MOVING);
+    movement.forward(motorConfig.baseSpeed);
+}
+
+void cmdBackward(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("← Backward");
+    status.setStatus(StatusLED::MOVING);
+    movement.backward(motorConfig.baseSpeed);
+}
+
+void cmdTurnRight(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("↻ Turn Right");
+    status.setStatus(StatusLED::MOVING);
+    movement.turnRight(motorConfig.baseSpeed);
+    delay(motorConfig.turnDuration);
+    movement.stop();
+    status.setStatus(StatusLED::READY);
+    Serial.println("  (Turn complete)");
+}
+
+void cmdSpinCCW(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("⟲ Spin CCW");
+    status.setStatus(StatusLED::MOVING);
+    movement.spinCCW(motorConfig.baseSpeed);
+}
+
+void cmdSpinCW(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("⟳ Spin CW");
+    status.setStatus(StatusLED::MOVING);
+    movement.spinCW(motorConfig.baseSpeed);
+}
+
+void cmdCrawl(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("🐌 Crawl");
+    status.setStatus(StatusLED::MOVING);
+    movement.crawl();
+}
+
+void cmdRun(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("🏃 Run");
+    status.setStatus(StatusLED::MOVING);
+    movement.run();
+}
+
+void cmdSpeed(const CommandLine::Args& args) {
+    // Base speed is a gene: change it through the genome so it is saved and
+    // the next mutate/breed starts from it
+    const Genome::GeneSpec& spec = Genome::SPECS[Genome::BASE_SPEED];
+    int top = min((int)spec.max, motorConfig.maxSpeed);
+    if (args.v[0].i < spec.min || args.v[0].i > top) {
+        Serial.printf("❓ Speed must be %d-%d\n", (int)spec.min, top);
+        return;
+    }
+    Genome g = genetics.current();
+    g.set(Genome::BASE_SPEED, args.v[0].i);
+    genetics.swap(g);
+    Serial.printf("⚙ Base speed %d (gene saved)\n", motorConfig.baseSpeed);
+}
+
+void cmdMotor(const CommandLine::Args& args) {
+    char motor = args.v[0].c;
+    char dir = args.v[1].c;
+    long speed = args.v[2].i;
+    if ((motor != 'A' && motor != 'B') || (dir != 'F' && dir != 'R') || speed < 0 || speed > 255) {
+        Serial.println("❓ Use: motor <A|B> <F|R> <0-255>");
+        return;
+    }
+    if (speed > 0 && refuseWhenDead()) return;
+    bool forward = (dir == 'F');
+    if (motor == 'A') {
+        hal.setMotorA(speed, forward);
+    } else {
+        hal.setMotorB(speed, forward);
+    }
+    Serial.printf("Motor %c %s at %ld\n", motor, forward ? "forward" : "reverse", speed);
+}
+
+// ----------------------------------------------------------------------------
+// CONTROL
+// ----------------------------------------------------------------------------
+void cmdStop(const CommandLine::Args&) {
+    Serial.println("⏹ Stop");
+    lightBearing.cancel();
+    driveDeadline = 0;
+    if (navigatorMode.isEnabled()) {
+        navigatorMode.disable();
+    }
+    // Disable autonomous mode if running
+    if (autonomousMode.isEnabled()) {
+        autonomousMode.disable();
+    } else {
+        movement.stop();
+        status.setStatus(StatusLED::READY);
+    }
+}
+
+void cmdEmergencyStop(const CommandLine::Args&) {
+    Serial.println("🛑 EMERGENCY STOP");
+    emergencyStop();
+}
+
+// ----------------------------------------------------------------------------
+// SMOOTH MOVEMENT
+// ----------------------------------------------------------------------------
+void cmdSmoothForward(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("→ Smooth Forward");
+    status.setStatus(StatusLED::MOVING);
+    movement.smoothForward(motorConfig.baseSpeed);
+}
+
+void cmdSmoothBackward(const CommandLine::Args&) {
+    if (refuseWhenDead()) return;
+    Serial.println("← Smooth Backward");
+    status.setStatus(StatusLED::MOVING);
+    movement.smoothBackward(motorConfig.baseSpeed);
+}
+
+void cmdSmoothStop(const CommandLine::Args&) {
+    Serial.println("⏹ Smooth Stop");
+    movement.smoothStop();
+    status.setStatus(StatusLED::READY);
+}
+
+// ----------------------------------------------------------------------------
+// TEST SEQUENCES
+// ----------------------------------------------------------------------------
+void cmdTest(const CommandLine::Args&) {
+    if (!refuseWhenDead()) runTestSequence();
+}
+
+void cmdSmoothTest(const CommandLine::Args&) {
+    if (!refuseWhenDead()) runSmoothTestSequence();
+}
+
+void cmdRGBTest(const CommandLine::Args&) { runRGBTest(); }
+
+// ----------------------------------------------------------------------------
+// INFORMATION
+// ----------------------------------------------------------------------------
+void cmdHelp(const CommandLine::Args&) { commandLine.printHelp(); }
+void cmdInfo(const CommandLine::Args&) { printSystemInfo(); }
+void cmdProfile(const CommandLine::Args&) { Profiler::printReport(); }
+void cmdLatency(const CommandLine::Args&) { latencyTracer.printReport(); }
+void cmdDeadlines(const CommandLine::Args&) { deadlineMonitor.printReport(); }
+void cmdResources(const CommandLine::Args&) { resourceMonitor.printReport(); }
+void cmdEvents(const CommandLine::Args&) { eventLoop.printReport(); }
+void cmdPower(const CommandLine::Args&) { powerManager.printReport(); }
+void cmdBattery(const CommandLine::Args&) { batteryEstimator.printReport(); }
+void cmdLink(const CommandLine::Args&) { protocolLink.printStatus(); }
+void cmdEnergy(const CommandLine::Args&) { energyModel.printReport(); }
+void cmdRecorder(const CommandLine::Args&) { flightRecorder.printStatus(); }
+void cmdBoot(const CommandLine::Args&) { bootTimeline.printReport(); }
+
+void cmdPostmortem(const CommandLine::Args& args) {
+    if (args.has(0)) {
+        if (strcasecmp(args.v[0].w, "clear") != 0) {
+            Serial.println("❓ Use: postmortem [clear]");
+            return;
+        }
+        postmortem.clearCounts();
+        Serial.println("✓ Reset counts cleared");
+        return;
+    }
+    postmortem.printReport();
+}
+
+void cmdRecorderDump(const CommandLine::Args&) {
+    if (!flightRecorder.isReady()) {
+        flightRecorder.printStatus();
+        return;
+    }
+    // Printed by the recorder task; capture with tools/flight_decode.py
+    flightRecorder.requestDump();
+}
+
+void cmdRecorderErase(const CommandLine::Args&) {
+    if (!flightRecorder.isReady()) {
+        flightRecorder.printStatus();
+        return;
+    }
+    flightRecorder.requestErase();
+}
+
+void cmdRevive(const CommandLine::Args&) {
+    energyModel.reset();
+    status.setStatus(StatusLED::READY);
+    Serial.println("💚 Energy reset to 100% (genome kept, alive clock restarted)");
+}
+
+void cmdLog(const CommandLine::Args& args) {
+    if (args.has(0)) {
+        if (strcasecmp(args.v[0].w, "text") == 0) {
+            logger.setOutput(Logger::OUTPUT_TEXT);
+        } else if (strcasecmp(args.v[0].w, "binary") == 0) {
+            logger.setOutput(Logger::OUTPUT_BINARY);
+        } else if (strcasecmp(args.v[0].w, "off") == 0) {
+            logger.setOutput(Logger::OUTPUT_OFF);
+        } else {
+            Serial.println("❓ Use: log [text|binary|off]");
+            return;
+        }
+    }
+    logger.printStatus();
+}
+
+void cmdTransitions(const CommandLine::Args&) {
+    transitionLog.printRecent(20);
+    transitionLog.printDwell();
+}
+
+void cmdOverrun(const CommandLine::Args& args) {
+    static const char* const keys[] = { "log", "stop", "reset" };
+    static const char* const names[] = { "log only", "stop motors", "watchdog reset" };
+    int next = (deadlineMonitor.getReaction(loopDeadline) + 1) % 3;
+    if (args.has(0)) {
+        next = -1;
+        for (int i = 0; i < 3; i++) {
+            if (strcasecmp(args.v[0].w, keys[i]) == 0) next = i;
+        }
+        if (next < 0) {
+            Serial.println("❓ Use: overrun [log|stop|reset]");
+            return;
+        }
+    }
+    deadlineMonitor.setReaction(loopDeadline, (DeadlineMonitor::Reaction)next);
+    Serial.printf("⏰ Loop overrun reaction: %s\n", names[next]);
+}
+
+void cmdStream(const CommandLine::Args& args) {
+    telemetryStream.setEnabled(args.has(0) ? args.v[0].b : !telemetryStream.isEnabled());
+    Serial.printf("📈 Telemetry stream %s (%d Hz)\n", telemetryStream.isEnabled() ? "ON" : "OFF",
+                  telemetryStream.getRate());
+}
+
+void cmdRate(const CommandLine::Args& args) {
+    if (!telemetryStream.setRate(args.v[0].i)) {
+        Serial.printf("❓ Rate must be %d-%d Hz\n", TelemetryStream::MIN_RATE_HZ,
+                      TelemetryStream::MAX_RATE_HZ);
+        return;
+    }
+    Serial.printf("📈 Telemetry rate %d Hz\n", telemetryStream.getRate());
+}
+
+void cmdFields(const CommandLine::Args& args) {
+    if (args.has(0)) {
+        uint16_t mask;
+        if (!telemetryStream.parseFields(args.v[0].w, mask)) {
+            Serial.print("❓ Fields: all, logger, or a comma list of");
+            for (int i = 0; i < TelemetryStream::FIELD_COUNT; i++) {
+                Serial.printf(" %s", TELEMETRY_FIELD_NAMES[i]);
+            }
+            Serial.println();
+            return;
+        }
+        telemetryStream.setFields(mask);
+    }
+    telemetryStream.printStatus();
+}
+
+void cmdPowerSaving(const CommandLine::Args& args) {
+    // Idle-hook load sampling keeps the CPUs out of WAITI, so the two exclude each other
+    eventLoop.setPowerSaving(args.has(0) ? args.v[0].b : !eventLoop.isPowerSaving());
+    resourceMonitor.setLoadSampling(!eventLoop.isPowerSaving());
+    Serial.printf("🔋 Power saving %s\n", eventLoop.isPowerSaving() ?
+                  "ON" : "OFF (240 MHz, CPU load sampling on)");
+}
+
+void cmdHibernate(const CommandLine::Args& args) {
+    hibernate.setEnabled(args.has(0) ? args.v[0].b : !hibernate.isEnabled());
+    hibernate.printStatus();
+}
+
+// ----------------------------------------------------------------------------
+// SENSORS
+// ----------------------------------------------------------------------------
+void cmdUltrasonic(const CommandLine::Args&) {
+    if (sensorTask.isRunning()) {
+        // Pinging from here would collide with the core 0 capture
+        Serial.printf("Distance: %d cm (last ping %d cm)\n",
+                      sensor.getDistance(), sensor.getRawDistance());
+    } else {
+        int dist = hal.readUltrasonic();
+        Serial.printf("Distance: %d cm\n", dist);
+    }
+}
+
+void cmdLight(const CommandLine::Args&) {
+    float leftBright = ldrSensor.getLeftBrightness();
+    float rightBright = ldrSensor.getRightBrightness();
+    Serial.println("--- LDR Sensors ---");
+    Serial.printf("  Left:  %.3f (0=dark, 1=bright)\n", leftBright);
+    Serial.printf("  Right: %.3f (0=dark, 1=bright)\n", rightBright);
+    Serial.printf("  Difference: %.3f ", abs(leftBright - rightBright));
+    if (leftBright > rightBright + 0.1f) {
+        Serial.println("(LEFT brighter)");
+    } else if (rightBright > leftBright + 0.1f) {
+        Serial.println("(RIGHT brighter)");
+    } else {
+        Serial.println("(balanced)");
+    }
+}
+
+void cmdSensors(const CommandLine::Args&) {
+    int dist = sensor.getDistance();
+    bool stuck = sensor.isStuck();
+    // The sensor task owns the ADC while it runs
+    float voltage = sensorTask.isRunning() ? sensorTask.getBatteryVoltage()
+                                           : hal.readBatteryVoltage();
+    Serial.println("--- Sensor Status ---");
+    Serial.printf("  Filtered Distance: %d cm\n", dist);
+    Serial.printf("  Is Stuck: %s\n", stuck ? "YES" : "No");
+    stuckDetector.printStatus();
+    sensorTask.printStatus();
+    Serial.printf("  Battery Voltage: %.2f V\n", voltage);
+}
+
+void cmdDriver(const CommandLine::Args&) { printMotorDriverStatus(); }
+
+void cmdScan(const CommandLine::Args&) {
+    Serial.printf("Odometry: heading %.0f°, x %.0f cm, y %.0f cm, travelled %.0f cm\n",
+                  odometry.getHeading(), odometry.getX(), odometry.getY(),
+                  odometry.getDistance());
+    if (lightBearing.hasEstimate()) {
+        Serial.printf("Light bearing: %.0f° (relative %+.0f°), confidence %.2f\n",
+                      lightBearing.getBearing(), lightBearing.getRelativeBearing(),
+                      lightBearing.getConfidence());
+    }
+    if (!autonomousMode.isEnabled() && !phototropismMode.isEnabled() &&
+        !navigatorMode.isEnabled() && !refuseWhenDead()) {
+        Serial.println("🔍 Scanning...");
+        status.setStatus(StatusLED::SEARCHING);
+        lightBearing.startScan(motorConfig.crawlSpeed);
+    }
+}
+
+void cmdCoverage(const CommandLine::Args&) {
+    coverage.printReport();
+    Serial.printf("  Wander: %s, seed 0x%08lX, %d steps\n",
+                  wander.getParams().strategy == WanderParams::LEVY_FLIGHT ? "Levy flight" : "correlated walk",
+                  (unsigned long)wander.getParams().seed, wander.getStepCount());
+}
+
+// ----------------------------------------------------------------------------
+// AUTONOMOUS MODES
+// ----------------------------------------------------------------------------
+void cmdAutonomous(const CommandLine::Args& args) {
+    bool enable = args.has(0) ? args.v[0].b : !autonomousMode.isEnabled();
+    if (enable == autonomousMode.isEnabled()) return;
+    if (enable) {
+        if (refuseWhenDead()) return;
+        stopMotorModes();
+        // Same seed every run, so coverage numbers are comparable
+        wander.seed(wander.getParams().seed);
+        coverage.start();
+        autonomousMode.enable();
+    } else {
+        autonomousMode.disable();
+        coverage.printReport();
+    }
+}
+
+void cmdPhototropism(const CommandLine::Args& args) {
+    bool enable = args.has(0) ? args.v[0].b : !phototropismMode.isEnabled();
+    if (enable == phototropismMode.isEnabled()) return;
+    if (enable) {
+        if (refuseWhenDead()) return;
+        stopMotorModes();
+        phototropismMode.enable();
+    } else {
+        phototropismMode.disable();
+    }
+}
+
+void cmdController(const CommandLine::Args& args) {
+    Phototropism::Controller next =
+        phototropismMode.getController() == Phototropism::PROPORTIONAL ?
+        Phototropism::BANG_BANG : Phototropism::PROPORTIONAL;
+    if (args.has(0)) {
+        if (strcasecmp(args.v[0].w, "pi") == 0) {
+            next = Phototropism::PROPORTIONAL;
+        } else if (strcasecmp(args.v[0].w, "bang") == 0) {
+            next = Phototropism::BANG_BANG;
+        } else {
+            Serial.println("❓ Use: controller [pi|bang]");
+            return;
+        }
+    }
+    phototropismMode.setController(next);
+}
+
+void cmdNavigator(const CommandLine::Args& args) {
+    bool enable = args.has(0) ? args.v[0].b : !navigatorMode.isEnabled();
+    if (enable == navigatorMode.isEnabled()) return;
+    if (enable) {
+        if (refuseWhenDead()) return;
+        stopMotorModes();
+        navigatorMode.enable();
+    } else {
+        navigatorMode.disable();
+    }
+}
+
+// ----------------------------------------------------------------------------
+// PARAMETERS
+// ----------------------------------------------------------------------------
+void cmdGet(const CommandLine::Args& args) {
+    const ParamRegistry::Param* p = params.find(args.v[0].w);
+    if (!p) {
+        Serial.printf("❓ Unknown parameter '%s' (try: list)\n", args.v[0].w);
+        return;
+    }
+    params.print(*p);
+}
+
+void cmdSet(const CommandLine::Args& args) {
+    ParamRegistry::Result r = params.set(args.v[0].w, args.v[1].w);
+    if (r == ParamRegistry::CONFLICT) {
+        Serial.printf("❌ %s: needs %s\n", args.v[0].w, params.getConflict());
+        return;
+    }
+    if (r != ParamRegistry::OK) {
+        Serial.printf("❌ %s: %s\n", args.v[0].w, ParamRegistry::resultName(r));
+        return;
+    }
+    params.print(*params.find(args.v[0].w));
+}
+
+void cmdList(const CommandLine::Args& args) {
+    params.list(args.has(0) ? args.v[0].w : "");
+}
+
+void cmdBatch(const CommandLine::Args& args) {
+    const char* failedAt;
+    ParamRegistry::Result r = params.batch(args.v[0].w, &failedAt);
+    if (r == ParamRegistry::CONFLICT) {
+        Serial.printf("❌ Nothing applied - needs %s\n", params.getConflict());
+        return;
+    }
+    if (r != ParamRegistry::OK) {
+        Serial.printf("❌ Nothing applied - %s at '%s'\n", ParamRegistry::resultName(r), failedAt);
+        return;
+    }
+    Serial.println("✓ Batch applied (save to keep)");
+}
+
+void cmdSave(const CommandLine::Args&) {
+    if (params.save()) {
+        Serial.printf("💾 %d parameters saved to NVS\n", params.getCount());
+    } else {
+        Serial.println("❌ NVS write failed");
+    }
+}
+
+void cmdDefaults(const CommandLine::Args&) {
+    params.resetDefaults();
+    Serial.println("↺ Defaults restored (save to keep)");
+}
+
+// ----------------------------------------------------------------------------
+// GENOME
+// ----------------------------------------------------------------------------
+// Every change is applied on the spot and saved; the bot keeps running.
+
+void cmdGenome(const CommandLine::Args&) { genetics.print(); }
+
+void cmdRandomize(const CommandLine::Args&) {
+    Genome g = genetics.current();
+    g.randomize();
+    genetics.swap(g);
+    Serial.println("🎲 New random genome created and saved!");
+    genetics.print();
+}
+
+void cmdMutate(const CommandLine::Args& args) {
+    float rate = GenomeManager::DEFAULT_MUTATION_RATE;
+    float step = GenomeManager::DEFAULT_MUTATION_STEP;
+    if (args.has(0)) rate = strtof(args.v[0].w, nullptr);
+    if (args.has(1)) step = strtof(args.v[1].w, nullptr);
+    if (!(rate > 0 && rate <= 1) || !(step > 0 && step <= 1)) {
+        Serial.println("❓ Use: mutate [rate 0-1] [step 0-1]");
+        return;
+    }
+    Genome g = genetics.current();
+    g.mutate(rate, step);
+    genetics.swap(g);
+    Serial.println("🧬 Genome mutated and saved!");
+    genetics.print();
+}
+
+void cmdBreed(const CommandLine::Args& args) {
+    Genome mate;
+    if (!mate.fromHex(args.v[0].w)) {
+        Serial.printf("❓ Mate must be %u hex digits (see: genome)\n", (unsigned)Genome::HEX_LENGTH);
+        return;
+    }
+    Genome child = Genome::crossover(genetics.current(), mate);
+    child.botId = genetics.current().botId;
+    genetics.swap(child);
+    Serial.println("🧬 Crossover applied and saved!");
+    genetics.print();
+}
+
+void cmdGene(const CommandLine::Args& args) {
+    for (int i = 0; i < Genome::GENE_COUNT; i++) {
+        if (strcasecmp(args.v[0].w, Genome::SPECS[i].name) != 0) continue;
+        Genome g = genetics.current();
+        g.set((Genome::Gene)i, strtof(args.v[1].w, nullptr));
+        genetics.swap(g);
+        genetics.print();
+        return;
+    }
+    Serial.print("❓ Genes:");
+    for (int i = 0; i < Genome::GENE_COUNT; i++) {
+        Serial.printf(" %s", Genome::SPECS[i].name);
+    }
+    Serial.println();
+}
+
+void cmdBotId(const CommandLine::Args& args) {
+    if (args.v[0].i < 0 || args.v[0].i > 255) {
+        Serial.println("❓ Bot ID must be 0-255");
+        return;
+    }
+    Genome g = genetics.current();
+    g.botId = args.v[0].i;
+    genetics.swap(g);
+    Serial.printf("🏷 Bot ID %u saved\n", g.botId);
+}
+
+// ----------------------------------------------------------------------------
+// COMMAND TABLE
+// ----------------------------------------------------------------------------
+// Short forms are the original one-key commands, so old habits still work
+// (followed by Enter). Help lists the table in order, one section per group.
+
+constexpr CommandLine::Command COMMANDS[] = {
+    // name          alias spec   usage                    handler             group               help
+    { "forward",     "f",  "",    "",                      cmdForward,         "Basic Movement",   "Forward at base speed" },
+    { "backward",    "b",  "",    "",                      cmdBackward,        "Basic Movement",   "Backward at base speed" },
+    { "right",       "r",  "",    "",                      cmdTurnRight,       "Basic Movement",   "Turn right (timed)" },
+    { "ccw",         "<",  "",    "",                      cmdSpinCCW,         "Basic Movement",   "Spin counter-clockwise" },
+    { "cw",          ">",  "",    "",                      cmdSpinCW,          "Basic Movement",   "Spin clockwise" },
+    { "crawl",       "c",  "",    "",                      cmdCrawl,           "Basic Movement",   "Crawl (slow)" },
+    { "run",         "m",  "",    "",                      cmdRun,             "Basic Movement",   "Run (fast)" },
+    { "speed",       nullptr, "i", "<0-255>",              cmdSpeed,           "Basic Movement",   "Set base speed (base_speed gene)" },
+    { "motor",       nullptr, "cci", "<A|B> <F|R> <0-255>", cmdMotor,          "Basic Movement",   "Drive one motor directly" },
+
+    { "stop",        "s",  "",    "",                      cmdStop,            "Control",          "Stop (disables autonomous)" },
+
+    { "sforward",    "w",  "",    "",                      cmdSmoothForward,   "Smooth Movement",  "Smooth forward" },
+    { "sbackward",   "x",  "",    "",                      cmdSmoothBackward,  "Smooth Movement",  "Smooth backward" },
+    { "sstop",       "q",  "",    "",                      cmdSmoothStop,      "Smooth Movement",  "Smooth stop" },
+
+    { "test",        "t",  "",    "",                      cmdTest,            "Test Sequences",   "Basic movement test" },
+    { "smoothtest",  "y",  "",    "",                      cmdSmoothTest,      "Test Sequences",   "Smooth movement test" },
+    { "rgbtest",     "g",  "",    "",                      cmdRGBTest,         "Test Sequences",   "RGB LED test" },
+
+    { "help",        "h",  "",    "",                      cmdHelp,            "Information",      "This help menu" },
+    { "info",        "i",  "",    "",                      cmdInfo,            "Information",      "System info" },
+    { "profile",     "z",  "",    "",                      cmdProfile,         "Information",      "Loop profile report (min/avg/p99/max, then reset)" },
+    { "latency",     "d",  "",    "",                      cmdLatency,         "Information",      "Obstacle reaction latency report" },
+    { "transitions", "#",  "",    "",                      cmdTransitions,     "Information",      "Behavior transitions and state dwell times" },
+    { "deadlines",   "!",  "",    "",                      cmdDeadlines,       "Information",      "Deadline overrun report" },
+    { "overrun",     "@",  "|w",  "[log|stop|reset]",      cmdOverrun,         "Information",      "Loop overrun reaction (no arg: cycle)" },
+    { "resources",   "%",  "",    "",                      cmdResources,       "Information",      "Heap, stack, CPU idle and UART report" },
+    { "stream",      "$",  "|b",  "[on|off]",              cmdStream,          "Information",      "Telemetry stats line (serial_logger.py format)" },
+    { "rate",        nullptr, "i", "<1-100>",              cmdRate,            "Information",      "Telemetry stream rate, Hz" },
+    { "fields",      nullptr, "|w", "[all|logger|a,b,..]", cmdFields,          "Information",      "Telemetry fields and drop counters (res = resources)" },
+    { "events",      "^",  "",    "",                      cmdEvents,          "Information",      "Event loop wakeups and clock residency / current saving" },
+    { "powersave",   "~",  "|b",  "[on|off]",              cmdPowerSaving,     "Information",      "Power saving (off = 240 MHz + CPU load sampling)" },
+    { "power",       "&",  "",    "",                      cmdPower,           "Information",      "Battery power mode, feature scaling and mode residency" },
+    { "battery",     "*",  "",    "",                      cmdBattery,         "Information",      "State of charge, internal resistance, minutes left" },
+    { "hibernate",   "=",  "|b",  "[on|off]",              cmdHibernate,       "Information",      "Deep sleep while phototropism waits in the dark" },
+    { "link",        ":",  "",    "",                      cmdLink,            "Information",      "Binary link counters (see include/protocol.h)" },
+    { "energy",      nullptr, "", "",                      cmdEnergy,          "Information",      "Simulated energy, alive time and where it went" },
+    { "revive",      nullptr, "", "",                      cmdRevive,          "Information",      "Reset energy to 100% for a new trial" },
+    { "rec",         nullptr, "", "",                      cmdRecorder,        "Information",      "Flight recorder status (rate: set rec.rate_hz)" },
+    { "recdump",     nullptr, "", "",                      cmdRecorderDump,    "Information",      "Dump the flight recorder as hex (tools/flight_decode.py)" },
+    { "recerase",    nullptr, "", "",                      cmdRecorderErase,   "Information",      "Erase the flight recorder partition" },
+    { "boot",        nullptr, "", "",                      cmdBoot,            "Information",      "Boot timeline: time per setup() stage, time to ready" },
+    { "postmortem",  nullptr, "|w", "[clear]",             cmdPostmortem,      "Information",      "Reset cause counts and what ran before the last reset" },
+    { "log",         nullptr, "|w", "[text|binary|off]",   cmdLog,             "Information",      "Deferred log output and drop counters" },
+
+    { "sonar",       "u",  "",    "",                      cmdUltrasonic,      "Sensors",          "Read ultrasonic" },
+    { "light",       "l",  "",    "",                      cmdLight,           "Sensors",          "Read LDR sensors" },
+    { "sensors",     "p",  "",    "",                      cmdSensors,         "Sensors",          "Sensor status (dist, stuck, batt)" },
+    { "driver",      "j",  "",    "",                      cmdDriver,          "Sensors",          "Motor driver pin status" },
+    { "scan",        "o",  "",    "",                      cmdScan,            "Sensors",          "Spin-scan for light bearing (shows odometry)" },
+    { "coverage",    "e",  "",    "",                      cmdCoverage,        "Sensors",          "Exploration coverage report" },
+
+    { "auto",        "a",  "|b",  "[on|off]",              cmdAutonomous,      "Autonomous",       "Autonomous mode (restarts coverage benchmark)" },
+    { "photo",       "k",  "|b",  "[on|off]",              cmdPhototropism,    "Autonomous",       "Phototropism mode (light seeking)" },
+    { "controller",  "v",  "|w",  "[pi|bang]",             cmdController,      "Autonomous",       "Phototropism controller (no arg: toggle)" },
+    { "navigator",   "n",  "|b",  "[on|off]",              cmdNavigator,       "Autonomous",       "Light navigator (seek light around obstacles)" },
+
+    { "get",         nullptr, "w", "<name>",               cmdGet,             "Parameters",       "Show one parameter, range and default flag" },
+    { "set",         nullptr, "ww", "<name> <value>",      cmdSet,             "Parameters",       "Set a parameter (range-checked)" },
+    { "list",        nullptr, "|w", "[prefix]",            cmdList,            "Parameters",       "List parameters, e.g. list photo." },
+    { "batch",       nullptr, "w", "<a=1,b=2,..>",         cmdBatch,           "Parameters",       "Set several at once; all or nothing" },
+    { "save",        nullptr, "",  "",                     cmdSave,            "Parameters",       "Persist all parameters to NVS" },
+    { "defaults",    nullptr, "",  "",                     cmdDefaults,        "Parameters",       "Restore compiled-in defaults" },
+
+    { "genome",      nullptr, "",  "",                     cmdGenome,          "Genome",           "Show genes and the hex encoding" },
+    { "randomize",   nullptr, "",  "",                     cmdRandomize,       "Genome",           "New random genome (generation 0)" },
+    { "mutate",      nullptr, "|ww", "[rate] [step]",      cmdMutate,          "Genome",           "Mutate each gene with p=rate by up to ±step of range" },
+    { "breed",       nullptr, "w", "<mate hex>",           cmdBreed,           "Genome",           "Uniform crossover with another bot's genome" },
+    { "gene",        nullptr, "ww", "<name> <value>",      cmdGene,            "Genome",           "Set one gene (clamped to its range)" },
+    { "id",          nullptr, "i", "<0-255>",              cmdBotId,           "Genome",           "Set bot ID" },
+};
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+// What setup() found, printed once the robot is already running
+struct BootResults {
+    ParamRegistry::LoadResult params;
+    bool logger;
+    bool recorder;
+    bool eventLoop;
+    bool sensorTask;
+    bool resourceMonitor;
+    bool deadlineMonitor;
+};
+
+BootResults boot;
+
+void printBootLog() {
     Serial.println("\n\n");
     Serial.println("╔════════════════════════════════════════╗");
     Serial.println("║      EMBER v0.3 - Mobile Life         ║");
     Serial.println("║     Phase 3B: Phototropism (Moth)     ║");
     Serial.println("╚════════════════════════════════════════╝");
     Serial.println();
-    
-    if (!hal.init()) {
-        Serial.println("❌ HAL initialization FAILED!");
-        status.setStatus(StatusLED::ERROR);
-        while (true) { 
-            delay(1000); 
-        }
-    }
+    postmortem.printBootReport();
     
     Serial.println("✓ HAL initialized");
     Serial.println("✓ PWM configured (Motors: 20kHz, RGB: 5kHz)");
+    switch (boot.params) {
+        case ParamRegistry::LOAD_OK:
+            Serial.println("✓ Parameters loaded from NVS");
+            break;
+        case ParamRegistry::LOAD_EMPTY:
+            Serial.println("✓ Parameters: compiled-in defaults");
+            break;
+        case ParamRegistry::LOAD_CORRUPT:
+        case ParamRegistry::LOAD_VERSION:
+            Serial.println("⚠ Saved parameters rejected (CRC/schema) - using defaults");
+            break;
+    }
+    Serial.printf("✓ Genome: bot %u, generation %u\n", genetics.current().botId,
+                  genetics.current().generation);
+    if (boot.logger) {
+        Serial.println("✓ Deferred log task on core 0");
+    } else {
+        Serial.println("⚠ Log task failed to start - log records are queued, not printed");
+    }
+    if (boot.recorder) {
+        Serial.println("✓ Flight recorder on core 0");
+    } else {
+        Serial.println("⚠ Flight recorder off - no 'flightrec' partition");
+    }
+    if (boot.eventLoop) {
+        Serial.printf("✓ Event loop (%s)\n", eventLoop.hasPowerManagement() ?
+                      "DFS + light sleep" : "DFS 80/160/240 MHz");
+    } else {
+        Serial.println("⚠ Event loop tick failed - waking on sensor/UART only");
+    }
+    if (boot.sensorTask) {
+        Serial.printf("✓ Sensor task on core 0 (control loop on core %d)\n", xPortGetCoreID());
+    } else {
+        Serial.println("⚠ Sensor task failed to start - sensing inline");
+    }
+    if (boot.resourceMonitor) {
+        Serial.println("✓ Resource monitor sampling at 1 Hz");
+    } else {
+        Serial.println("⚠ Resource monitor failed to hook idle tasks");
+    }
+    if (boot.deadlineMonitor) {
+        Serial.println("✓ Deadline monitor armed");
+    } else {
+        Serial.println("⚠ Deadline monitor failed to start");
+    }
     Serial.println();
     
     Serial.println("Motor Configuration:");
@@ -273,13 +1206,95 @@ void setup() {
     Serial.printf("  Turn Duration: %d ms\n", motorConfig.turnDuration);
     Serial.println();
     
+    uint32_t readyUs = bootTimeline.getReadyUs();
+    Serial.printf("✓ Robot Ready in %lu.%01lu ms ('boot' for the timeline)\n",
+                  (unsigned long)(readyUs / 1000), (unsigned long)(readyUs / 100 % 10));
+    Serial.println();
+    Serial.println("Type 'help' (or 'h') and Enter for commands, SPACE to stop");
+    Serial.print("> ");
+}
+
+void setup() {
+    bootTimeline.mark("runtime");
+    
+    // Output queues in the UART driver instead of blocking on the hardware
+    // FIFO, and nothing waits for a serial host to attach
+    Serial.setTxBufferSize(EMBER_SERIAL_TX_BUFFER);
+    Serial.begin(EMBER_SERIAL_BAUD);
+    serialTx.begin();
+    
+    // Hibernate wake: sample the light and, if still dark, go straight back to sleep
+    hibernate.resume();
+    bootTimeline.mark("wake check");
+    
+    // Motor driver pins driven and both bridges stopped before anything else
+    if (!hal.init()) {
+        Serial.println("❌ HAL initialization FAILED!");
+        status.setStatus(StatusLED::ERROR);
+        while (true) { 
+            delay(1000); 
+        }
+    }
+    if (!hibernate.isWarm()) {
+        status.setStatus(StatusLED::BOOTING);   // Red until ready
+    }
+    bootTimeline.mark("motors safe");
+    
+    // Takes over the previous boot's RTC history before anything records into it
+    postmortem.begin();
+    protocolLink.begin(handleBinaryCommand);
+    commandLine.begin(COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0]), cmdEmergencyStop);
+    transitionLog.describe(BehaviorId::AVOIDANCE, "avoidance",
+                           ObstacleAvoidance::STATE_NAMES, ObstacleAvoidance::STATE_COUNT);
+    transitionLog.describe(BehaviorId::PHOTOTROPISM, "phototropism",
+                           Phototropism::STATE_NAMES, Phototropism::STATE_COUNT);
+    transitionLog.describe(BehaviorId::NAVIGATOR, "navigator",
+                           LightNavigator::STATE_NAMES, LightNavigator::STATE_COUNT);
+    bootTimeline.mark("console");
+    
+    // Saved tuning replaces the compiled-in values before anything uses them
+    registerParameters();
+    boot.params = params.load();
+    
+    // Genes own the fields they map to, so they go on top of the parameters
+    genetics.begin();
+    bootTimeline.mark("parameters");
+    
+    // Behaviors log through a ring drained by a low-priority task on core 0
+    boot.logger = logger.begin(0);
+    boot.recorder = flightRecorder.begin(0);
+    bootTimeline.mark("log tasks");
+    
+    // Wake-up sources for loop(); must be up before the sensor task posts to it
+    boot.eventLoop = eventLoop.begin(50, Pins::BOOT_BUTTON);
+    
+    // Sensing moves to core 0; loop() keeps running control on core 1
+    boot.sensorTask = sensorTask.begin(0);
+    powerManager.begin();
+    bootTimeline.mark("sensors");
+    
+    boot.resourceMonitor = resourceMonitor.begin();
+    if (boot.resourceMonitor) {
+        resourceMonitor.watchTask("sensors", sensorTask.getHandle());
+        resourceMonitor.watchTask("log", logger.getHandle());
+        resourceMonitor.watchTask("recorder", flightRecorder.getHandle());
+        resourceMonitor.setLoadSampling(!eventLoop.isPowerSaving());
+    }
+    // Loop runs on every sensor sample (40 ms); anything blocking for 100 ms is an overrun
+    loopDeadline = deadlineMonitor.registerActivity("loop", 40, FlightRecorder::LOOP_DEADLINE_MS);
+    boot.deadlineMonitor = deadlineMonitor.begin(hal);
+    bootTimeline.mark("monitors");
+    
     movement.stop();
+    hibernate.restore();
     status.setStatus(StatusLED::READY);
+    bootTimeline.markReady();
     
-    Serial.println("✓ Robot Ready");
-    Serial.println();
-    Serial.println("Press 'h' for help, 'l' to read LDR sensors");
-    Serial.print("> ");
+    // Everything below is for people: the robot is already up
+    postmortem.saveResetCount();
+    bootTimeline.mark("reset count");
+    printBootLog();
+    bootTimeline.mark("boot log");
 }
 
 // ============================================================================
@@ -287,232 +1302,117 @@ void setup() {
 // ============================================================================
 
 void loop() {
-    // Check for serial commands
-    if (Serial.available()) {
-        char cmd = Serial.read();
-        
-        // Clear buffer
-        while (Serial.available() && (Serial.peek() == '\n' || Serial.peek() == '\r')) {
-            Serial.read();
-        }
-        
-        switch (cmd) {
-            // ================================================================
-            // BASIC MOVEMENT
-            // ================================================================
-            case 'f': case 'F':
-                Serial.println("→ Forward");
-                status.setStatus(StatusLED::MOVING);
-                movement.forward(motorConfig.baseSpeed);
-                break;
-                
-            case 'b': case 'B':
-                Serial.println("← Backward");
-                status.setStatus(StatusLED::MOVING);
-                movement.backward(motorConfig.baseSpeed);
-                break;
-                
-            case 'r': case 'R':
-                Serial.println("↻ Turn Right");
-                status.setStatus(StatusLED::MOVING);
-                movement.turnRight(motorConfig.baseSpeed);
-                delay(motorConfig.turnDuration);
-                movement.stop();
-                status.setStatus(StatusLED::READY);
-                Serial.println("  (Turn complete)");
-                break;
-                
-            case '<':
-                Serial.println("⟲ Spin CCW");
-                status.setStatus(StatusLED::MOVING);
-                movement.spinCCW(motorConfig.baseSpeed);
-                break;
-                
-            case '>':
-                Serial.println("⟳ Spin CW");
-                status.setStatus(StatusLED::MOVING);
-                movement.spinCW(motorConfig.baseSpeed);
-                break;
-                
-            case 'c': case 'C':
-                Serial.println("🐌 Crawl");
-                status.setStatus(StatusLED::MOVING);
-                movement.crawl();
-                break;
-                
-            case 'm': case 'M':
-                Serial.println("🏃 Run");
-                status.setStatus(StatusLED::MOVING);
-                movement.run();
-                break;
-                
-            case 's': case 'S':
-                Serial.println("⏹ Stop");
-                // Disable autonomous mode if running
-                if (autonomousMode.isEnabled()) {
-                    autonomousMode.disable();
-                } else {
-                    movement.stop();
-                    status.setStatus(StatusLED::READY);
-                }
-                break;
-            
-            // ================================================================
-            // SMOOTH MOVEMENT
-            // ================================================================
-            case 'w': case 'W':
-                Serial.println("→ Smooth Forward");
-                status.setStatus(StatusLED::MOVING);
-                movement.smoothForward(motorConfig.baseSpeed);
-                break;
-                
-            case 'x': case 'X':
-                Serial.println("← Smooth Backward");
-                status.setStatus(StatusLED::MOVING);
-                movement.smoothBackward(motorConfig.baseSpeed);
-                break;
-                
-            case 'q': case 'Q':
-                Serial.println("⏹ Smooth Stop");
-                movement.smoothStop();
-                status.setStatus(StatusLED::READY);
-                break;
-            
-            // ================================================================
-            // TEST SEQUENCES
-            // ================================================================
-            case 't': case 'T':
-                runTestSequence();
-                break;
-                
-            case 'y': case 'Y':
-                runSmoothTestSequence();
-                break;
-                
-            case 'g': case 'G':
-                runRGBTest();
-                break;
-            
-            // ================================================================
-            // INFORMATION
-            // ================================================================
-            case 'h': case 'H':
-                printHelp();
-                break;
-                
-            case 'i': case 'I':
-                printSystemInfo();
-                break;
-
-            // ================================================================
-            // ULTRASONIC READING
-            // ================================================================                
-            case 'u': case 'U':
-                {
-                    int dist = hal.readUltrasonic();
-                    Serial.printf("Distance: %d cm\n", dist);
-                }
-                break;
-
-            // ================================================================
-            // LDR READING (Phase 3A)
-            // ================================================================
-            case 'l': case 'L':
-                {
-                    float leftBright = ldrSensor.getLeftBrightness();
-                    float rightBright = ldrSensor.getRightBrightness();
-                    Serial.println("--- LDR Sensors ---");
-                    Serial.printf("  Left:  %.3f (0=dark, 1=bright)\n", leftBright);
-                    Serial.printf("  Right: %.3f (0=dark, 1=bright)\n", rightBright);
-                    Serial.printf("  Difference: %.3f ", abs(leftBright - rightBright));
-                    if (leftBright > rightBright + 0.1f) {
-                        Serial.println("(LEFT brighter)");
-                    } else if (rightBright > leftBright + 0.1f) {
-                        Serial.println("(RIGHT brighter)");
-                    } else {
-                        Serial.println("(balanced)");
-                    }
-                }
-                break;
-
-            // ================================================================
-            // SENSOR DIAGNOSTICS
-            // ================================================================
-            case 'p': case 'P':
-                {
-                    int dist = sensor.getDistance();
-                    bool stuck = sensor.isStuck();
-                    float voltage = hal.readBatteryVoltage();
-                    Serial.println("--- Sensor Status ---");
-                    Serial.printf("  Filtered Distance: %d cm\n", dist);
-                    Serial.printf("  Is Stuck: %s\n", stuck ? "YES" : "No");
-                    Serial.printf("  Battery Voltage: %.2f V\n", voltage);
-                }
-                break;
-
-            // ================================================================
-            // MOTOR DIAGNOSTICS
-            // ================================================================
-            case 'j': case 'J':
-                printMotorDriverStatus();
-                break;
-
-            // ================================================================
-            // AUTONOMOUS MODE
-            // ================================================================
-            case 'a': case 'A':
-                if (autonomousMode.isEnabled()) {
-                    autonomousMode.disable();
-                } else {
-                    autonomousMode.enable();
-                }
-                break;                
-
-            // ================================================================
-            // PHOTOTROPISM MODE (Phase 3B)
-            // ================================================================
-            case 'k': case 'K':
-                if (phototropismMode.isEnabled()) {
-                    phototropismMode.disable();
-                } else {
-                    phototropismMode.enable();
-                }
-                break;
-                                
-            // ================================================================
-            // EMERGENCY STOP
-            // ================================================================
-
-            case ' ': // Spacebar for emergency stop
-                Serial.println("🛑 EMERGENCY STOP");
-                autonomousMode.disable();
-                movement.stop();
-                status.setStatus(StatusLED::READY);
-                break;
-
-            // ================================================================
-            // UNKNOWN
-            // ================================================================
-            default:
-                Serial.println("❓ Unknown command. Press 'h' for help.");
-                break;
+    deadlineMonitor.start(loopDeadline);
+    deadlineMonitor.section(loopDeadline, "commands");
+    PROFILE_BEGIN(LOOP);
+    PROFILE_BEGIN(COMMANDS);
+    
+    // Console text; binary frames are split off and handled inside poll().
+    // Bytes are consumed as they arrive, and at most one command runs per pass.
+    int input;
+    while ((input = protocolLink.poll()) >= 0) {
+        if (commandLine.feed((char)input)) {
+            lastCommandMs = millis();
+            break;
         }
-        
-        // Print prompt
-        Serial.print("> ");
     }
+    PROFILE_END(COMMANDS);
     
     // Update status LED (for animations/blinking)
-    status.update();
+    {
+        PROFILE_SCOPE(STATUS_LED);
+        deadlineMonitor.section(loopDeadline, "status");
+        status.update();
+    }
 
     // Always update sensors so diagnostics are live
-    sensor.update();
-    ldrSensor.update();
+    {
+        PROFILE_SCOPE(ULTRASONIC);
+        deadlineMonitor.section(loopDeadline, "ultrasonic");
+        sensor.update();
+    }
+    {
+        PROFILE_SCOPE(LDR);
+        deadlineMonitor.section(loopDeadline, "ldr");
+        ldrSensor.update();
+    }
+    {
+        PROFILE_SCOPE(ESTIMATORS);
+        deadlineMonitor.section(loopDeadline, "estimators");
+        odometry.update();
+        stuckDetector.update();
+        coverage.update();
+        resourceMonitor.update();
+        batteryEstimator.update();
+        powerManager.update();
+        postmortem.update(batteryEstimator.getVoltage(), powerManager.getMode());
+        if (energyModel.update()) {
+            // Dead: stays still until "revive" (refuseWhenDead() blocks
+            // every command that would drive it)
+            emergencyStop();
+            status.setStatus(StatusLED::ERROR);
+        }
+    }
+
+    // Manual bearing scan (phototropism and the navigator drive their own scans)
+    if (!phototropismMode.isEnabled() && !navigatorMode.isEnabled() && lightBearing.update()) {
+        status.setStatus(StatusLED::READY);
+    }
 
     // Update autonomous mode
-    autonomousMode.update();
+    {
+        PROFILE_SCOPE(AVOIDANCE);
+        deadlineMonitor.section(loopDeadline, "avoidance");
+        autonomousMode.update();
+    }
     // Update phototropism mode
-    phototropismMode.update();
+    {
+        PROFILE_SCOPE(PHOTOTROPISM);
+        deadlineMonitor.section(loopDeadline, "phototropism");
+        phototropismMode.update();
+    }
+    // Update light navigator
+    {
+        PROFILE_SCOPE(NAVIGATOR);
+        deadlineMonitor.section(loopDeadline, "navigator");
+        navigatorMode.update();
+    }
+    
+    // Binary link: DRIVE deadman and the telemetry stream
+    if (driveDeadline != 0 && (long)(millis() - driveDeadline) >= 0) {
+        movement.stop();
+        status.setStatus(StatusLED::READY);
+        driveDeadline = 0;
+    }
+    if (protocolLink.telemetryDue()) {
+        sendBinaryTelemetry();
+    }
+    telemetryStream.update();
+    if (flightRecorder.due()) {
+        recordFlightSample();
+    }
     
-    delay(5);
+    PROFILE_END(LOOP);
+    deadlineMonitor.finish(loopDeadline);
+    
+    // Dark and nothing else to do: deep sleep until the light comes back
+    bool consoleActive = millis() - lastCommandMs < CONSOLE_ACTIVE_MS;
+    hibernate.update(autonomousMode.isEnabled() || navigatorMode.isEnabled() ||
+                     lightBearing.isScanning() || consoleActive);
+    
+    // Clock follows what the robot is doing
+    bool active = autonomousMode.isEnabled() || phototropismMode.isEnabled() ||
+                  navigatorMode.isEnabled() || lightBearing.isScanning() || consoleActive;
+    eventLoop.setDemand(movement.isMoving() ? EventLoop::HIGH_POWER :
+                        active ? EventLoop::MID_POWER : EventLoop::LOW_POWER);
+    
+    // Sleep until the next sensor sample, tick, keystroke, stats line or button press.
+    // Bytes already buffered (one command is read per pass) mean no wait.
+    uint32_t events = eventLoop.wait(Serial.available() || protocolLink.hasPending() ? 0 :
+                                     min(min((uint32_t)100, telemetryStream.msUntilDue()),
+                                         flightRecorder.msUntilDue()));
+    if (events & EventLoop::EVENT_BUTTON) {
+        Serial.println("🛑 BUTTON STOP");
+        emergencyStop();
+    }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "movement.h"
+#include "postmortem.h"
 
 Movement::Movement(HAL& halRef, MotorConfig& configRef) 
     : hal(halRef), config(configRef) {
@@ -18,6 +19,7 @@ int Movement::getSpeed(int requested) {
 }
 
 void Movement::setMotors(int speedA, bool dirA, int speedB, bool dirB) {
+    postmortem.noteMotors(dirA ? speedA : -speedA, dirB ? speedB : -speedB);
     hal.setMotorA(speedA, dirA);
     hal.setMotorB(speedB, dirB);
     
@@ -30,6 +32,7 @@ void Movement::setMotors(int speedA, bool dirA, int speedB, bool dirB) {
 }
 
 void Movement::rampSpeed(int fromSpeed, int toSpeed, bool forward) {
+    postmortem.noteMotors(forward ? toSpeed : -toSpeed, forward ? toSpeed : -toSpeed);
     if (fromSpeed < toSpeed) {
         // Ramp up
         for (int speed = fromSpeed; speed <= toSpeed; speed += 5) {
@@ -180,6 +183,12 @@ void Movement::smoothBackward(int speed) {
     }
 }
 
+void Movement::refresh() {
+    if (state.moving) {
+        setMotors(state.speedA, state.directionA, state.speedB, state.directionB);
+    }
+}
+
 // ============================================================================
 // PROPORTIONAL TURNING
 // ============================================================================
@@ -199,6 +208,15 @@ void Movement::setVeer(int baseSpeed, int turnAmount) {
     setMotors(constrain(speedA, 0, 255), true, constrain(speedB, 0, 255), true);
 }
 
+void Movement::setTwist(int linear, int angular) {
+    // Differential drive command. Unlike setVeer(), a wheel may reverse, so a
+    // large angular term with little linear speed becomes a pivot in place.
+    // A positive angular value turns clockwise (right), negative counter-clockwise.
+    int speedA = constrain(linear + angular, -255, 255);
+    int speedB = constrain(linear - angular, -255, 255);
+    setMotors(abs(speedA), speedA >= 0, abs(speedB), speedB >= 0);
+}
+
 // ============================================================================
 // STATE QUERIES
 // ============================================================================
@@ -209,4 +227,14 @@ bool Movement::isMoving() {
 
 int Movement::getCurrentSpeed() {
     return max(state.speedA, state.speedB);
-}
\ No newline at end of file
+}
+// Effective PWM after the HAL's power-mode limit, so odometry follows the cap
+int Movement::getWheelSpeedA() {
+    int speed = state.speedA * hal.getMotorLimit() / 100;
+    return state.directionA ? speed : -speed;
+}
+
+int Movement::getWheelSpeedB() {
+    int speed = state.speedB * hal.getMotorLimit() / 100;
+    return state.directionB ? speed : -speed;
+}
@@ -0,0 +1,72 @@
+#include "odometry.h"
+
+Odometry::Odometry(Movement& movRef, MotorConfig& cfg)
+    : movement(movRef), config(cfg) {
+}
+
+void Odometry::reset() {
+    heading = 0.0f;
+    x = 0.0f;
+    y = 0.0f;
+    distance = 0.0f;
+    lastUpdate = millis();
+}
+
+void Odometry::update() {
+    unsigned long now = millis();
+    if (lastUpdate == 0) {
+        lastUpdate = now;
+        return;
+    }
+    float dt = (now - lastUpdate) / 1000.0f;
+    lastUpdate = now;
+    
+    // Wheel commands normalized to baseSpeed (1.0 = cruising)
+    float a = movement.getWheelSpeedA() / (float)config.baseSpeed;   // Left
+    float b = movement.getWheelSpeedB() / (float)config.baseSpeed;   // Right
+    
+    // A spin at baseSpeed (a = 1, b = -1) covers 90° in turnDuration ms
+    float spinRate = 90000.0f / config.turnDuration;   // deg/s
+    float yawRate = spinRate * (a - b) / 2.0f;
+    speed = config.cruiseSpeedCmS * (a + b) / 2.0f;
+    
+    // Integrate at the midpoint heading
+    float midHeading = (heading + yawRate * dt / 2.0f) * DEG_TO_RAD;
+    x += speed * dt * cosf(midHeading);
+    y += speed * dt * sinf(midHeading);
+    distance += fabsf(speed) * dt;
+    heading = wrap360(heading + yawRate * dt);
+}
+
+float Odometry::getHeading() {
+    return heading;
+}
+
+float Odometry::getX() {
+    return x;
+}
+
+float Odometry::getY() {
+    return y;
+}
+
+float Odometry::getDistance() {
+    return distance;
+}
+
+float Odometry::getSpeed() {
+    return speed;
+}
+
+float Odometry::wrap180(float deg) {
+    deg = fmodf(deg, 360.0f);
+    if (deg > 180.0f) deg -= 360.0f;
+    if (deg <= -180.0f) deg += 360.0f;
+    return deg;
+}
+
+float Odometry::wrap360(float deg) {
+    deg = fmodf(deg, 360.0f);
+    if (deg < 0.0f) deg += 360.0f;
+    return deg;
+}
@@ -0,0 +1,364 @@
+#include "params.h"
+#include "protocol.h"
+#include <Preferences.h>
+#include <strings.h>
+
+ParamRegistry params;
+
+static const char* const NVS_NAMESPACE = "ember";
+static const char* const NVS_KEY = "params";
+static const uint32_t BLOB_MAGIC = 0x50424D45;     // "EMBP"
+
+struct BlobHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint16_t crc;           // CRC-16 over the entries
+    uint16_t reserved;
+};
+
+struct BlobEntry {
+    uint32_t hash;
+    float value;
+};
+
+static const size_t BLOB_MAX = sizeof(BlobHeader) + ParamRegistry::MAX_PARAMS * sizeof(BlobEntry);
+static uint8_t blob[BLOB_MAX];
+
+// ============================================================================
+// REGISTRATION
+// ============================================================================
+
+bool ParamRegistry::append(const char* name, Type type, void* value, float min, float max,
+                           float def, const char* help) {
+    if (count >= MAX_PARAMS) {
+        Serial.printf("⚠ Parameter table full, '%s' not registered\n", name);
+        return false;
+    }
+    table[count++] = { name, help, type, value, min, max, def };
+    return true;
+}
+
+bool ParamRegistry::add(const char* name, int* value, int min, int max, const char* help) {
+    return append(name, TYPE_INT, value, min, max, *value, help);
+}
+
+bool ParamRegistry::add(const char* name, float* value, float min, float max, const char* help) {
+    return append(name, TYPE_FLOAT, value, min, max, *value, help);
+}
+
+bool ParamRegistry::add(const char* name, bool* value, const char* help) {
+    return append(name, TYPE_BOOL, value, 0, 1, *value ? 1 : 0, help);
+}
+
+bool ParamRegistry::addRule(const char* a, const char* b, float minGap) {
+    const Param* pa = find(a);
+    const Param* pb = find(b);
+    if (!pa || !pb || ruleCount >= MAX_RULES) {
+        Serial.printf("⚠ Rule %s/%s not registered\n", a, b);
+        return false;
+    }
+    rules[ruleCount++] = { pa, pb, minGap };
+    return true;
+}
+
+bool ParamRegistry::requireNotAbove(const char* lower, const char* upper) {
+    return addRule(lower, upper, -1);
+}
+
+bool ParamRegistry::requireApart(const char* a, const char* b, float minGap) {
+    return addRule(a, b, minGap);
+}
+
+// ============================================================================
+// ACCESS
+// ============================================================================
+
+const ParamRegistry::Param* ParamRegistry::find(const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcasecmp(table[i].name, name) == 0) return &table[i];
+    }
+    return nullptr;
+}
+
+float ParamRegistry::get(const Param& p) {
+    switch (p.type) {
+        case TYPE_INT:   return *(int*)p.value;
+        case TYPE_FLOAT: return *(float*)p.value;
+        case TYPE_BOOL:  return *(bool*)p.value ? 1 : 0;
+    }
+    return 0;
+}
+
+void ParamRegistry::assign(const Param& p, float v) {
+    switch (p.type) {
+        case TYPE_INT:   *(int*)p.value = lroundf(v); break;
+        case TYPE_FLOAT: *(float*)p.value = v; break;
+        case TYPE_BOOL:  *(bool*)p.value = v != 0; break;
+    }
+}
+
+ParamRegistry::Result ParamRegistry::parse(const Param& p, const char* text, float& out) {
+    char* end;
+    if (p.type == TYPE_BOOL) {
+        if (strcasecmp(text, "on") == 0 || strcasecmp(text, "true") == 0) {
+            out = 1;
+            return OK;
+        }
+        if (strcasecmp(text, "off") == 0 || strcasecmp(text, "false") == 0) {
+            out = 0;
+            return OK;
+        }
+    }
+    if (p.type == TYPE_INT) {
+        long v = strtol(text, &end, 10);
+        out = v;
+    } else {
+        out = strtof(text, &end);
+    }
+    if (end == text || *end != '\0' || isnan(out)) return BAD_VALUE;
+    if (out < p.min || out > p.max) return OUT_OF_RANGE;
+    return OK;
+}
+
+bool ParamRegistry::holds(const Rule& r, float a, float b) {
+    return r.minGap < 0 ? a <= b : fabsf(a - b) >= r.minGap;
+}
+
+// Checks the rules touching any of the n pending values against the values
+// they would have; nothing is assigned, so readers on the other core never
+// see a half-applied pair
+bool ParamRegistry::consistent(const Param* const* targets, const float* values, int n) {
+    for (int i = 0; i < ruleCount; i++) {
+        const Rule& r = rules[i];
+        float a = get(*r.a);
+        float b = get(*r.b);
+        bool touched = false;
+        for (int j = 0; j < n; j++) {
+            if (targets[j] == r.a) { a = values[j]; touched = true; }
+            if (targets[j] == r.b) { b = values[j]; touched = true; }
+        }
+        if (touched && !holds(r, a, b)) {
+            if (r.minGap < 0) {
+                snprintf(conflict, sizeof(conflict), "%s <= %s", r.a->name, r.b->name);
+            } else {
+                snprintf(conflict, sizeof(conflict), "%s and %s %g apart",
+                         r.a->name, r.b->name, r.minGap);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+ParamRegistry::Result ParamRegistry::set(const char* name, const char* text) {
+    const Param* p = find(name);
+    if (!p) return UNKNOWN_NAME;
+    float v;
+    Result r = parse(*p, text, v);
+    if (r != OK) return r;
+    if (!consistent(&p, &v, 1)) return CONFLICT;
+    assign(*p, v);
+    return OK;
+}
+
+ParamRegistry::Result ParamRegistry::batch(const char* list, const char** failedAt) {
+    const Param* targets[MAX_PARAMS];
+    float values[MAX_PARAMS];
+    int n = 0;
+    char entry[48];
+
+    // Pass 1: parse and validate everything
+    const char* p = list;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (failedAt) *failedAt = p;
+        if (len == 0) {
+            p++;
+            continue;
+        }
+        if (len >= sizeof(entry) || n >= MAX_PARAMS) return BAD_SYNTAX;
+        memcpy(entry, p, len);
+        entry[len] = '\0';
+
+        char* eq = strchr(entry, '=');
+        if (!eq) return BAD_SYNTAX;
+        *eq = '\0';
+        const Param* param = find(entry);
+        if (!param) return UNKNOWN_NAME;
+        Result r = parse(*param, eq + 1, values[n]);
+        if (r != OK) return r;
+        targets[n++] = param;
+
+        p += len;
+        if (*p == ',') p++;
+    }
+
+    // Rules are checked against the batch as a whole, so a pair can move
+    // together past each other
+    if (failedAt) *failedAt = list;
+    if (!consistent(targets, values, n)) return CONFLICT;
+
+    // Pass 2: apply
+    for (int i = 0; i < n; i++) {
+        assign(*targets[i], values[i]);
+    }
+    if (failedAt) *failedAt = nullptr;
+    return OK;
+}
+
+void ParamRegistry::resetDefaults() {
+    for (int i = 0; i < count; i++) {
+        assign(table[i], table[i].def);
+    }
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+uint32_t ParamRegistry::hashName(const char* name) {
+    uint32_t h = 2166136261u;
+    while (*name) {
+        h ^= (uint8_t)*name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool ParamRegistry::save() {
+    BlobEntry* entries = (BlobEntry*)(blob + sizeof(BlobHeader));
+    for (int i = 0; i < count; i++) {
+        entries[i].hash = hashName(table[i].name);
+        entries[i].value = get(table[i]);
+    }
+    size_t entryBytes = count * sizeof(BlobEntry);
+
+    BlobHeader header;
+    header.magic = BLOB_MAGIC;
+    header.version = SCHEMA_VERSION;
+    header.count = count;
+    header.crc = Protocol::crc16((const uint8_t*)entries, entryBytes);
+    header.reserved = 0;
+    memcpy(blob, &header, sizeof(header));
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) return false;
+    size_t written = prefs.putBytes(NVS_KEY, blob, sizeof(header) + entryBytes);
+    prefs.end();
+    return written == sizeof(header) + entryBytes;
+}
+
+ParamRegistry::LoadResult ParamRegistry::load() {
+    loadedCount = 0;
+    rejectedCount = 0;
+    conflictCount = 0;
+
+    Preferences prefs;
+    size_t len = 0;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        len = prefs.getBytesLength(NVS_KEY);
+        if (len > 0 && len <= BLOB_MAX) len = prefs.getBytes(NVS_KEY, blob, len);
+        prefs.end();
+    }
+    if (len == 0) return lastLoad = LOAD_EMPTY;
+
+    BlobHeader header;
+    if (len < sizeof(header) || len > BLOB_MAX) return lastLoad = LOAD_CORRUPT;
+    memcpy(&header, blob, sizeof(header));
+    const uint8_t* entries = blob + sizeof(header);
+    size_t entryBytes = header.count * sizeof(BlobEntry);
+    if (header.magic != BLOB_MAGIC || len != sizeof(header) + entryBytes ||
+        Protocol::crc16(entries, entryBytes) != header.crc) {
+        return lastLoad = LOAD_CORRUPT;
+    }
+    if (header.version != SCHEMA_VERSION) return lastLoad = LOAD_VERSION;
+
+    for (int e = 0; e < header.count; e++) {
+        BlobEntry entry;
+        memcpy(&entry, entries + e * sizeof(BlobEntry), sizeof(entry));
+        for (int i = 0; i < count; i++) {
+            if (hashName(table[i].name) != entry.hash) continue;
+            if (isnan(entry.value) || entry.value < table[i].min || entry.value > table[i].max) {
+                rejectedCount++;
+            } else {
+                assign(table[i], entry.value);
+                loadedCount++;
+            }
+            break;
+        }
+    }
+
+    // A pair saved from inconsistent edits: both members go back to defaults
+    for (int i = 0; i < ruleCount; i++) {
+        const Rule& r = rules[i];
+        if (holds(r, get(*r.a), get(*r.b))) continue;
+        Serial.printf("⚠ Saved %s/%s conflict, defaults kept\n", r.a->name, r.b->name);
+        assign(*r.a, r.a->def);
+        assign(*r.b, r.b->def);
+        conflictCount++;
+    }
+    return lastLoad = LOAD_OK;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+const char* ParamRegistry::resultName(Result r) {
+    switch (r) {
+        case OK:           return "ok";
+        case UNKNOWN_NAME: return "unknown parameter";
+        case BAD_VALUE:    return "bad value";
+        case OUT_OF_RANGE: return "out of range";
+        case BAD_SYNTAX:   return "expected name=value";
+        case CONFLICT:     return "conflicts with a related parameter";
+    }
+    return "?";
+}
+
+void ParamRegistry::print(const Param& p) {
+    float v = get(p);
+    bool changed = v != p.def;
+    switch (p.type) {
+        case TYPE_INT:
+            Serial.printf("  %-20s %8d   [%d..%d]", p.name, (int)v, (int)p.min, (int)p.max);
+            break;
+        case TYPE_FLOAT:
+            Serial.printf("  %-20s %8.4g   [%g..%g]", p.name, v, p.min, p.max);
+            break;
+        case TYPE_BOOL:
+            Serial.printf("  %-20s %8s   [on|off]", p.name, v ? "on" : "off");
+            break;
+    }
+    Serial.printf("%s %s\n", changed ? " *" : "  ", p.help);
+}
+
+void ParamRegistry::list(const char* prefix) {
+    size_t n = strlen(prefix);
+    int shown = 0;
+    for (int i = 0; i < count; i++) {
+        if (strncasecmp(table[i].name, prefix, n) != 0) continue;
+        print(table[i]);
+        shown++;
+    }
+    if (shown == 0) {
+        Serial.printf("  No parameters matching '%s'\n", prefix);
+    } else {
+        Serial.println("  (* = differs from default)");
+    }
+}
+
+void ParamRegistry::printStatus() {
+    static const char* const loads[] = {
+        "loaded", "nothing saved", "corrupt (CRC/size)", "schema changed"
+    };
+    Serial.printf("  %d parameters, NVS %s", count, loads[lastLoad]);
+    if (lastLoad == LOAD_OK) {
+        Serial.printf(" (%d applied, %d out of range kept default", loadedCount, rejectedCount);
+        if (conflictCount > 0) Serial.printf(", %d conflicting pairs reset", conflictCount);
+        Serial.print(")");
+    }
+    Serial.println();
+}
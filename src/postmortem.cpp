@@ -0,0 +1,250 @@
+#include "postmortem.h"
+#include "power_manager.h"
+#include <Preferences.h>
+
+Postmortem postmortem;
+
+static const uint32_t RTC_MAGIC = 0x454D5031;   // "EMP1"
+static const char* const NVS_NAMESPACE = "ember";
+static const char* const NVS_KEY = "resets";
+
+// Left alone by the boot ROM and startup code on every reset except power-on
+RTC_NOINIT_ATTR Postmortem::State Postmortem::rtc;
+
+// Events shown at boot after a crash; "postmortem" prints all of them
+static const int BOOT_EVENTS = 12;
+
+// ============================================================================
+// BOOT
+// ============================================================================
+
+void Postmortem::begin() {
+    reason = esp_reset_reason();
+
+    // Power-on leaves RTC memory random: only trust it after a reset
+    hasPrevious = reason != ESP_RST_POWERON && rtc.magic == RTC_MAGIC;
+    if (hasPrevious) {
+        previous = rtc;
+    }
+    bootNumber = hasPrevious ? rtc.boot + 1 : 1;
+
+    memset(&rtc, 0, sizeof(rtc));
+    rtc.magic = RTC_MAGIC;
+    rtc.boot = bootNumber;
+    rtc.minMillivolts = UINT16_MAX;
+
+    loadCounts();
+    if (reason != ESP_RST_DEEPSLEEP && reason < REASON_COUNT) {
+        counts[reason]++;
+        countPending = true;
+    }
+}
+
+void Postmortem::saveResetCount() {
+    if (!countPending) return;
+    saveCounts();
+    countPending = false;
+}
+
+void Postmortem::loadCounts() {
+    memset(counts, 0, sizeof(counts));
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) return;
+    // A blob of another size is from a different build: start over
+    if (prefs.getBytesLength(NVS_KEY) == sizeof(counts)) {
+        prefs.getBytes(NVS_KEY, counts, sizeof(counts));
+    }
+    prefs.end();
+}
+
+void Postmortem::saveCounts() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) return;
+    prefs.putBytes(NVS_KEY, counts, sizeof(counts));
+    prefs.end();
+}
+
+void Postmortem::clearCounts() {
+    memset(counts, 0, sizeof(counts));
+    saveCounts();
+}
+
+// ============================================================================
+// RECORDING (loop)
+// ============================================================================
+
+void Postmortem::noteTransition(const TransitionRecord& r) {
+    rtc.transitions[rtc.transitionTotal % TRANSITIONS] = r;
+    rtc.transitionTotal++;
+}
+
+void Postmortem::noteMotors(int wheelA, int wheelB) {
+    if (wheelA == lastA && wheelB == lastB) return;
+    lastA = wheelA;
+    lastB = wheelB;
+
+    MotorEntry& e = rtc.motors[rtc.motorTotal % MOTORS];
+    e.timeMs = millis();
+    e.wheelA = wheelA;
+    e.wheelB = wheelB;
+    rtc.motorTotal++;
+}
+
+void Postmortem::update(float volts, uint8_t powerMode) {
+    unsigned long now = millis();
+    rtc.lastAliveMs = now;
+    if ((long)(now - nextBatteryMs) < 0) return;
+    nextBatteryMs = now + BATTERY_PERIOD_MS;
+
+    uint16_t mv = constrain(volts * 1000, 0, 65535);
+    BatteryEntry& e = rtc.battery[rtc.batteryTotal % READINGS];
+    e.timeMs = now;
+    e.millivolts = mv;
+    e.powerMode = powerMode;
+    e.reserved = 0;
+    rtc.batteryTotal++;
+    if (mv > 0 && mv < rtc.minMillivolts) rtc.minMillivolts = mv;
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+bool Postmortem::wasAbnormal() {
+    switch (reason) {
+        case ESP_RST_BROWNOUT:
+        case ESP_RST_PANIC:
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint32_t Postmortem::getResetCount(esp_reset_reason_t r) {
+    return r < REASON_COUNT ? counts[r] : 0;
+}
+
+uint32_t Postmortem::getCrashCount() {
+    return counts[ESP_RST_PANIC] + counts[ESP_RST_INT_WDT] + counts[ESP_RST_TASK_WDT] +
+           counts[ESP_RST_WDT];
+}
+
+const char* Postmortem::reasonName(esp_reset_reason_t r) {
+    switch (r) {
+        case ESP_RST_POWERON:   return "POWERON";
+        case ESP_RST_EXT:       return "EXTERNAL";
+        case ESP_RST_SW:        return "SOFTWARE";
+        case ESP_RST_PANIC:     return "PANIC";
+        case ESP_RST_INT_WDT:   return "INT_WDT";
+        case ESP_RST_TASK_WDT:  return "TASK_WDT";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+        case ESP_RST_BROWNOUT:  return "BROWNOUT";
+        case ESP_RST_SDIO:      return "SDIO";
+        default:                return "UNKNOWN";
+    }
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+// The three rings merged by time, newest maxEvents of them, oldest first.
+// Times are relative to the last heartbeat, i.e. roughly to the reset.
+void Postmortem::printTimeline(int maxEvents) {
+    const State& s = previous;
+    uint32_t heldT = min(s.transitionTotal, (uint32_t)TRANSITIONS);
+    uint32_t heldM = min(s.motorTotal, (uint32_t)MOTORS);
+    uint32_t heldB = min(s.batteryTotal, (uint32_t)READINGS);
+
+    // Walk back from the newest entry of each ring
+    enum Kind : uint8_t { KIND_TRANSITION, KIND_MOTOR, KIND_BATTERY };
+    struct Pick { uint8_t kind; uint32_t total; };
+    Pick picks[TRANSITIONS + MOTORS + READINGS];
+    int n = 0;
+    uint32_t t = s.transitionTotal, m = s.motorTotal, b = s.batteryTotal;
+    while (n < maxEvents && n < (int)(sizeof(picks) / sizeof(picks[0]))) {
+        bool hasT = s.transitionTotal - t < heldT;
+        bool hasM = s.motorTotal - m < heldM;
+        bool hasB = s.batteryTotal - b < heldB;
+        if (!hasT && !hasM && !hasB) break;
+
+        uint32_t timeT = hasT ? s.transitions[(t - 1) % TRANSITIONS].timeMs : 0;
+        uint32_t timeM = hasM ? s.motors[(m - 1) % MOTORS].timeMs : 0;
+        uint32_t timeB = hasB ? s.battery[(b - 1) % READINGS].timeMs : 0;
+        if (hasT && (!hasM || timeT >= timeM) && (!hasB || timeT >= timeB)) {
+            picks[n++] = { KIND_TRANSITION, t-- };
+        } else if (hasM && (!hasB || timeM >= timeB)) {
+            picks[n++] = { KIND_MOTOR, m-- };
+        } else {
+            picks[n++] = { KIND_BATTERY, b-- };
+        }
+    }
+
+    if (n == 0) {
+        Serial.println("  (no events recorded)");
+        return;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        uint32_t index = picks[i].total - 1;
+        if (picks[i].kind == KIND_TRANSITION) {
+            const TransitionRecord& r = s.transitions[index % TRANSITIONS];
+            Serial.printf("  %8.2fs  %-13s %s -> %s (trigger %d)\n",
+                          ((int32_t)(r.timeMs - s.lastAliveMs)) / 1000.0f,
+                          transitionLog.behaviorName(r.behavior),
+                          transitionLog.stateName(r.behavior, r.from),
+                          transitionLog.stateName(r.behavior, r.to), r.trigger);
+        } else if (picks[i].kind == KIND_MOTOR) {
+            const MotorEntry& e = s.motors[index % MOTORS];
+            Serial.printf("  %8.2fs  motors        A %4d  B %4d\n",
+                          ((int32_t)(e.timeMs - s.lastAliveMs)) / 1000.0f, e.wheelA, e.wheelB);
+        } else {
+            const BatteryEntry& e = s.battery[index % READINGS];
+            Serial.printf("  %8.2fs  battery       %u.%02uV %s\n",
+                          ((int32_t)(e.timeMs - s.lastAliveMs)) / 1000.0f,
+                          e.millivolts / 1000, (e.millivolts % 1000) / 10,
+                          PowerManager::modeName((PowerManager::Mode)e.powerMode));
+        }
+    }
+}
+
+void Postmortem::printBootReport() {
+    Serial.printf("✓ Reset: %s (boot %lu since power-on; %lu brownouts, %lu crashes logged)\n",
+                  reasonName(reason), (unsigned long)bootNumber,
+                  (unsigned long)counts[ESP_RST_BROWNOUT], (unsigned long)getCrashCount());
+    if (!wasAbnormal()) return;
+
+    Serial.printf("⚠ Abnormal reset - last events before it (type 'postmortem' for all):\n");
+    if (!hasPrevious) {
+        Serial.println("  (RTC history lost)");
+        return;
+    }
+    printTimeline(BOOT_EVENTS);
+}
+
+void Postmortem::printReport() {
+    Serial.println("\n--- Postmortem ---");
+    Serial.printf("  This boot: %s, boot %lu since power-on\n", reasonName(reason),
+                  (unsigned long)bootNumber);
+    Serial.print("  Resets logged:");
+    for (int r = 0; r < REASON_COUNT; r++) {
+        if (counts[r] == 0) continue;
+        Serial.printf(" %s %lu", reasonName((esp_reset_reason_t)r), (unsigned long)counts[r]);
+    }
+    Serial.println();
+
+    if (!hasPrevious) {
+        Serial.println("  No history from the previous boot (power-on or first run)");
+        return;
+    }
+    Serial.printf("  Previous boot ran %.1f s", previous.lastAliveMs / 1000.0f);
+    if (previous.minMillivolts != UINT16_MAX) {
+        Serial.printf(", lowest battery %u.%02uV", previous.minMillivolts / 1000,
+                      (previous.minMillivolts % 1000) / 10);
+    }
+    Serial.println(". Times relative to its last loop pass:");
+    printTimeline(TRANSITIONS + MOTORS + READINGS);
+}
@@ -0,0 +1,191 @@
+#include "power_manager.h"
+#include "logger.h"
+#include "flight_recorder.h"
+#include "event_loop.h"
+#include <esp_sleep.h>
+
+// Lower bound of each mode (V); SHUTDOWN is anything below CRITICAL's
+static const float MODE_FLOOR[PowerManager::MODE_COUNT] = { 7.8f, 7.2f, 6.8f, 6.4f, 0.0f };
+static const float HYSTERESIS_V = 0.1f;
+static const float FULL_PACK_V = 8.4f;
+static const unsigned long PERSISTENCE_MS = 30000;
+static const unsigned long SAMPLE_MS = 1000;
+
+// Feature scaling per mode (docs table; sensing keeps 40ms as the NORMAL rate)
+static const int MOTOR_PERCENT[PowerManager::MODE_COUNT] = { 100, 75, 50, 25, 0 };
+static const int LED_PERCENT[PowerManager::MODE_COUNT]   = { 100, 75, 50, 25, 0 };
+static const uint32_t SENSOR_PERIOD_MS[PowerManager::MODE_COUNT] = { 40, 100, 200, 500, 500 };
+static const EventLoop::Level CPU_CAP[PowerManager::MODE_COUNT] = {
+    EventLoop::HIGH_POWER, EventLoop::MID_POWER, EventLoop::LOW_POWER,
+    EventLoop::LOW_POWER, EventLoop::LOW_POWER
+};
+
+PowerManager::PowerManager(HAL& halRef, Movement& moveRef, SensorTask& taskRef,
+                           BatteryEstimator& batteryRef)
+    : hal(halRef), movement(moveRef), sensorTask(taskRef), estimator(batteryRef) {
+}
+
+void PowerManager::begin() {
+    lastSample = millis() - SAMPLE_MS;      // Take the first reading right away
+    modeEntered = millis();
+}
+
+// ============================================================================
+// SAMPLING AND FILTERING
+// ============================================================================
+
+void PowerManager::update() {
+    unsigned long now = millis();
+    if (now - lastSample < SAMPLE_MS) return;
+    lastSample = now;
+    
+    battery = estimator.hasBattery();
+    if (!battery) {
+        readingCount = 0;
+        voltage = estimator.getVoltage();
+        if (mode != POWER_NORMAL) enterMode(POWER_NORMAL);
+        return;
+    }
+    if (!estimator.isReady()) return;
+    
+    // Open-circuit voltage: the sag the motors cause is already removed.
+    // A saturated ADC only says "at least full scale": count it as full.
+    readings[readingIndex] = estimator.isSaturated() ? FULL_PACK_V : estimator.getOpenCircuitVoltage();
+    readingIndex = (readingIndex + 1) % AVG_WINDOW;
+    if (readingCount < AVG_WINDOW) readingCount++;
+    
+    float sum = 0;
+    for (int i = 0; i < readingCount; i++) sum += readings[i];
+    voltage = sum / readingCount;
+    if (readingCount < AVG_WINDOW) return;
+    
+    if (!started) {
+        // First full average sets the mode directly; shutdown still has to persist
+        started = true;
+        Mode initial = classify(voltage, false);
+        enterMode(initial == POWER_SHUTDOWN ? POWER_CRITICAL : initial);
+        pendingMode = mode;
+        return;
+    }
+    
+    // ========================================================================
+    // MODE STATE MACHINE
+    // ========================================================================
+    Mode candidate = classify(voltage, false);
+    if (candidate < mode) {
+        // Recovering (charged or load removed): needs the hysteresis margin too
+        candidate = classify(voltage, true);
+        if (candidate > mode) candidate = mode;
+    }
+    
+    if (candidate == mode) {
+        pendingMode = mode;
+        return;
+    }
+    if (candidate != pendingMode) {
+        pendingMode = candidate;
+        pendingSince = now;
+        return;
+    }
+    if (now - pendingSince >= PERSISTENCE_MS) {
+        enterMode(candidate);
+    }
+}
+
+PowerManager::Mode PowerManager::classify(float v, bool improving) {
+    float margin = improving ? HYSTERESIS_V : 0.0f;
+    for (int m = POWER_NORMAL; m < POWER_SHUTDOWN; m++) {
+        if (v >= MODE_FLOOR[m] + margin) return (Mode)m;
+    }
+    return POWER_SHUTDOWN;
+}
+
+// ============================================================================
+// MODE CHANGES
+// ============================================================================
+
+void PowerManager::enterMode(Mode newMode) {
+    unsigned long now = millis();
+    residencyMs[mode] += now - modeEntered;
+    modeEntered = now;
+    
+    if (newMode != mode) {
+        LOG_INFO("🔋 Power mode %s -> %s (%.2fV open-circuit, %.0f%% SoC)",
+                 modeName(mode), modeName(newMode), voltage, estimator.getSoc());
+        transitions++;
+    }
+    mode = newMode;
+    pendingMode = newMode;
+    applyMode();
+}
+
+void PowerManager::applyMode() {
+    hal.setMotorLimit(MOTOR_PERCENT[mode]);
+    hal.setLedBrightness(LED_PERCENT[mode]);
+    movement.refresh();
+    if (sensorTask.isRunning()) sensorTask.setPeriod(SENSOR_PERIOD_MS[mode]);
+    eventLoop.setMaxLevel(CPU_CAP[mode]);
+    
+    if (mode == POWER_SHUTDOWN) {
+        // Deep-discharge protection: nothing wakes us, the pack must be charged
+        logger.flush();
+        flightRecorder.flush();
+        Serial.println("🪫 BATTERY SHUTDOWN - powering down to protect the pack");
+        Serial.flush();
+        movement.stop();
+        hal.prepareForSleep();      // Pads held low: the motor driver can't float on
+        esp_deep_sleep_start();
+    }
+}
+
+PowerManager::Mode PowerManager::getMode() {
+    return mode;
+}
+
+const char* PowerManager::modeName(Mode m) {
+    switch (m) {
+        case POWER_NORMAL:   return "NORMAL";
+        case POWER_ECONOMY:  return "ECONOMY";
+        case POWER_LOW:      return "LOW";
+        case POWER_CRITICAL: return "CRITICAL";
+        default:       return "SHUTDOWN";
+    }
+}
+
+float PowerManager::getVoltage() {
+    return voltage;
+}
+
+bool PowerManager::hasBattery() {
+    return battery;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+void PowerManager::printReport() {
+    Serial.println("\n--- Power Manager ---");
+    if (!battery) {
+        Serial.printf("  No battery sensed (%.2fV) - USB power, staying NORMAL\n", voltage);
+    } else {
+        Serial.printf("  Battery: %.2fV open-circuit avg (%.2fV measured), %.0f%% SoC, ~%d min%s\n",
+                      voltage, estimator.getVoltage(), estimator.getSoc(), estimator.getMinutesLeft(),
+                      estimator.isSaturated() ? " - ADC saturated, recalibrate divider" : "");
+    }
+    Serial.printf("  Mode: %s (motors %d%%, sensing %lums, LED %d%%)\n",
+                  modeName(mode), MOTOR_PERCENT[mode],
+                  (unsigned long)SENSOR_PERIOD_MS[mode], LED_PERCENT[mode]);
+    if (pendingMode != mode) {
+        unsigned long held = millis() - pendingSince;
+        Serial.printf("  Pending: %s for %lus of %lus\n", modeName(pendingMode),
+                      held / 1000, PERSISTENCE_MS / 1000);
+    }
+    
+    Serial.printf("  Residency (%lu changes):\n", (unsigned long)transitions);
+    unsigned long now = millis();
+    for (int m = POWER_NORMAL; m < POWER_SHUTDOWN; m++) {
+        uint32_t ms = residencyMs[m] + (m == mode ? now - modeEntered : 0);
+        Serial.printf("    %-8s %7.1f min\n", modeName((Mode)m), ms / 60000.0f);
+    }
+}
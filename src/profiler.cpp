@@ -0,0 +1,42 @@
+#include "profiler.h"
+#include "histogram.h"
+
+#if EMBER_PROFILING
+
+namespace Profiler {
+
+static LogHistogram<2> stats[SECTION_COUNT];
+
+static const char* const SECTION_NAMES[SECTION_COUNT] = {
+    "loop", "commands", "ultrasonic", "ldr", "estimators",
+    "status_led", "avoidance", "phototropism", "navigator", "capture"
+};
+
+void record(Section section, uint32_t us) {
+    stats[section].record(us);
+}
+
+void reset() {
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        stats[i].reset();
+    }
+}
+
+void printReport() {
+    Serial.println("\n--- Loop Profile (us) ---");
+    Serial.println("  section         count      min      avg      p99      max");
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        const LogHistogram<2>& h = stats[i];
+        if (h.count() == 0) continue;
+        Serial.printf("  %-12s %8lu %8lu %8.1f %8lu %8lu\n",
+                      SECTION_NAMES[i], (unsigned long)h.count(),
+                      (unsigned long)h.min(), (float)h.mean(),
+                      (unsigned long)h.percentile(990), (unsigned long)h.max());
+    }
+    Serial.println("  (counters reset)");
+    reset();
+}
+
+} // namespace Profiler
+
+#endif
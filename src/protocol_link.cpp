@@ -0,0 +1,200 @@
+#include "protocol_link.h"
+#include "serial_tx.h"
+
+ProtocolLink protocolLink;
+
+// A frame that stalls this long was a stray delimiter: back to text
+static const unsigned long FRAME_TIMEOUT_MS = 100;
+
+void ProtocolLink::begin(CommandHandler cmdHandler) {
+    handler = cmdHandler;
+}
+
+// ============================================================================
+// RECEIVE
+// ============================================================================
+
+int ProtocolLink::poll() {
+    if (injectHead < injectLen) {
+        return inject[injectHead++];
+    }
+    
+    if (inFrame && millis() - lastRxMs > FRAME_TIMEOUT_MS) {
+        inFrame = false;
+        rxLen = 0;
+    }
+    
+    while (Serial.available()) {
+        uint8_t b = Serial.read();
+        lastRxMs = millis();
+        
+        if (b == 0) {
+            if (rxLen > 0) {
+                handleFrame();
+                rxLen = 0;
+                inFrame = false;    // Trailing delimiter
+                if (injectHead < injectLen) return inject[injectHead++];
+            } else {
+                inFrame = true;     // Leading delimiter (or resync)
+            }
+            continue;
+        }
+        
+        if (inFrame) {
+            if (rxLen < sizeof(rx)) {
+                rx[rxLen++] = b;
+            } else {
+                overruns++;
+                inFrame = false;
+                rxLen = 0;
+            }
+            continue;
+        }
+        
+        return b;
+    }
+    return -1;
+}
+
+bool ProtocolLink::hasPending() {
+    return injectHead < injectLen;
+}
+
+void ProtocolLink::handleFrame() {
+    uint8_t type, seq;
+    uint8_t payload[Protocol::MAX_PAYLOAD];
+    size_t len;
+    if (!Protocol::decodeFrame(rx, rxLen, type, seq, payload, len)) {
+        crcErrors++;
+        return;
+    }
+    framesIn++;
+    
+    switch (type) {
+        case Protocol::CMD_PING:
+            sendAck(seq, type, Protocol::ACK_OK, Protocol::VERSION);
+            return;
+            
+        case Protocol::CMD_TEXT:
+            // Replayed through poll() as if typed, Enter included
+            if (len == 0 || len > Protocol::MAX_PAYLOAD) {
+                sendAck(seq, type, Protocol::ACK_BAD_LENGTH);
+                return;
+            }
+            memcpy(inject, payload, len);
+            inject[len] = '\n';
+            injectLen = len + 1;
+            injectHead = 0;
+            sendAck(seq, type, Protocol::ACK_OK);
+            return;
+            
+        case Protocol::CMD_BAUD: {
+            if (len != sizeof(Protocol::BaudPayload)) {
+                sendAck(seq, type, Protocol::ACK_BAD_LENGTH);
+                return;
+            }
+            Protocol::BaudPayload p;
+            memcpy(&p, payload, sizeof(p));
+            if (p.baud < 9600 || p.baud > 2000000) {
+                sendAck(seq, type, Protocol::ACK_REJECTED);
+                return;
+            }
+            // Acknowledge at the old rate, then switch
+            sendAck(seq, type, Protocol::ACK_OK);
+            Serial.flush();
+            Serial.updateBaudRate(p.baud);
+            return;
+        }
+        
+        case Protocol::CMD_TELEMETRY: {
+            if (len != sizeof(Protocol::TelemetryPayload)) {
+                sendAck(seq, type, Protocol::ACK_BAD_LENGTH);
+                return;
+            }
+            Protocol::TelemetryPayload p;
+            memcpy(&p, payload, sizeof(p));
+            if (p.periodMs != 0 && p.periodMs < 10) {
+                sendAck(seq, type, Protocol::ACK_REJECTED);
+                return;
+            }
+            setTelemetry(p.periodMs, p.mask);
+            sendAck(seq, type, Protocol::ACK_OK);
+            return;
+        }
+        
+        default:
+            sendAck(seq, type, handler ? handler(type, payload, len) : Protocol::ACK_UNKNOWN_TYPE);
+            return;
+    }
+}
+
+// ============================================================================
+// TRANSMIT
+// ============================================================================
+
+size_t ProtocolLink::writeFrame(uint8_t type, uint8_t seq, const void* payload, size_t len,
+                                bool mayDrop) {
+    uint8_t frame[Protocol::MAX_FRAME];
+    size_t n = Protocol::encodeFrame(type, seq, payload, len, frame);
+    if (n == 0) return 0;
+    // One write call: frames never interleave with text from other tasks
+    if (mayDrop) {
+        if (!serialTx.tryWrite(frame, n)) {
+            txDrops++;
+            return 0;
+        }
+    } else {
+        serialTx.write(frame, n);
+    }
+    framesOut++;
+    return n;
+}
+
+void ProtocolLink::sendAck(uint8_t seq, uint8_t type, uint8_t status, uint8_t info) {
+    Protocol::AckPayload ack = { seq, type, status, info };
+    writeFrame(Protocol::ACK, nextSeq(), &ack, sizeof(ack), false);
+}
+
+bool ProtocolLink::sendTelemetry(uint8_t type, const void* payload, size_t len) {
+    // The seq advances even on a drop so the host can count the gap
+    return writeFrame(type, nextSeq(), payload, len, true) > 0;
+}
+
+bool ProtocolLink::sendFrame(uint8_t type, const void* payload, size_t len) {
+    return writeFrame(type, nextSeq(), payload, len, false) > 0;
+}
+
+uint8_t ProtocolLink::nextSeq() {
+    // The log task sends from core 0 while loop() sends from core 1
+    return __atomic_fetch_add(&txSeq, 1, __ATOMIC_RELAXED);
+}
+
+void ProtocolLink::setTelemetry(uint16_t periodMs, uint8_t mask) {
+    telemetryPeriod = periodMs;
+    telemetryMask = mask;
+    lastTelemetry = millis();
+}
+
+bool ProtocolLink::telemetryDue() {
+    if (telemetryPeriod == 0 || telemetryMask == 0) return false;
+    if (millis() - lastTelemetry < telemetryPeriod) return false;
+    lastTelemetry = millis();
+    return true;
+}
+
+uint8_t ProtocolLink::getTelemetryMask() {
+    return telemetryMask;
+}
+
+void ProtocolLink::printStatus() {
+    Serial.println("\n--- Binary Link ---");
+    Serial.printf("  In: %lu frames, %lu CRC/COBS errors, %lu overruns\n",
+                  (unsigned long)framesIn, (unsigned long)crcErrors, (unsigned long)overruns);
+    Serial.printf("  Out: %lu frames, %lu telemetry drops (TX buffer full)\n",
+                  (unsigned long)framesOut, (unsigned long)txDrops);
+    if (telemetryPeriod > 0) {
+        Serial.printf("  Streaming every %u ms, mask 0x%02X\n", telemetryPeriod, telemetryMask);
+    } else {
+        Serial.println("  Telemetry stream off");
+    }
+}
@@ -0,0 +1,212 @@
+#include "resource_monitor.h"
+#include "serial_tx.h"
+#include <esp_freertos_hooks.h>
+
+ResourceMonitor resourceMonitor;
+
+volatile uint32_t ResourceMonitor::idleUs[2] = { 0, 0 };
+volatile uint32_t ResourceMonitor::lastIdleCallUs[2] = { 0, 0 };
+
+// Consecutive idle hook calls closer than this are one stretch of idling;
+// a longer gap means another task (or a long ISR) had the core
+static const uint32_t IDLE_GAP_US = 50;
+
+// Heap drift is measured from a baseline taken once boot allocations settle
+static const uint32_t HEAP_BASELINE_MS = 30000;
+static const uint32_t HEAP_DRIFT_MIN_MS = 600000;
+
+bool ResourceMonitor::begin(uint32_t period) {
+    periodMs = period;
+    
+    // begin() is called from setup(), which runs in the loop task
+    watchTask("loopTask", xTaskGetCurrentTaskHandle());
+    watchTask("IDLE0", xTaskGetIdleTaskHandleForCPU(0));
+    watchTask("IDLE1", xTaskGetIdleTaskHandleForCPU(1));
+    watchTask("esp_timer", xTaskGetHandle("esp_timer"));
+    
+    lastSampleMs = millis();
+    lastSampleUs = micros();
+    running = true;
+    bool hooked = setLoadSampling(true);
+    sample();
+    return hooked;
+}
+
+bool ResourceMonitor::setLoadSampling(bool on) {
+    if (on == loadSampling) return true;
+    
+    if (on) {
+        if (esp_register_freertos_idle_hook_for_cpu(idleHook0, 0) != ESP_OK) return false;
+        if (esp_register_freertos_idle_hook_for_cpu(idleHook1, 1) != ESP_OK) {
+            esp_deregister_freertos_idle_hook_for_cpu(idleHook0, 0);
+            return false;
+        }
+        // Start a fresh window so the first reading isn't diluted
+        lastIdleUs[0] = idleUs[0];
+        lastIdleUs[1] = idleUs[1];
+        lastSampleUs = micros();
+    } else {
+        esp_deregister_freertos_idle_hook_for_cpu(idleHook0, 0);
+        esp_deregister_freertos_idle_hook_for_cpu(idleHook1, 1);
+        idlePercent[0] = idlePercent[1] = -1;
+    }
+    loadSampling = on;
+    return true;
+}
+
+bool ResourceMonitor::isLoadSampling() {
+    return loadSampling;
+}
+
+bool ResourceMonitor::watchTask(const char* name, TaskHandle_t handle) {
+    if (handle == nullptr || taskCount >= MAX_TASKS) return false;
+    tasks[taskCount].name = name;
+    tasks[taskCount].handle = handle;
+    tasks[taskCount].stackFree = uxTaskGetStackHighWaterMark(handle);
+    taskCount++;
+    return true;
+}
+
+// ============================================================================
+// IDLE HOOKS
+// ============================================================================
+
+void ResourceMonitor::accountIdle(int core) {
+    uint32_t now = micros();
+    uint32_t gap = now - lastIdleCallUs[core];
+    if (gap < IDLE_GAP_US) {
+        idleUs[core] = idleUs[core] + gap;
+    }
+    lastIdleCallUs[core] = now;
+}
+
+bool ResourceMonitor::idleHook0() {
+    accountIdle(0);
+    return false;   // Call again straight away (no WAITI) so idle time is measured
+}
+
+bool ResourceMonitor::idleHook1() {
+    accountIdle(1);
+    return false;
+}
+
+// ============================================================================
+// SAMPLING
+// ============================================================================
+
+void ResourceMonitor::update() {
+    if (!running || millis() - lastSampleMs < periodMs) return;
+    sample();
+}
+
+void ResourceMonitor::sample() {
+    uint32_t nowMs = millis();
+    uint32_t nowUs = micros();
+    
+    // Heap
+    freeHeap = ESP.getFreeHeap();
+    minFreeHeap = ESP.getMinFreeHeap();
+    largestBlock = ESP.getMaxAllocHeap();
+    if (baselineMs == 0 && nowMs >= HEAP_BASELINE_MS) {
+        baselineHeap = freeHeap;
+        baselineMs = nowMs;
+    }
+    
+    // Stacks
+    for (int i = 0; i < taskCount; i++) {
+        tasks[i].stackFree = uxTaskGetStackHighWaterMark(tasks[i].handle);
+    }
+    
+    // CPU idle per core over the last window
+    uint32_t windowUs = nowUs - lastSampleUs;
+    if (loadSampling && windowUs > 0) {
+        for (int core = 0; core < 2; core++) {
+            uint32_t idle = idleUs[core];
+            idlePercent[core] = constrain((idle - lastIdleUs[core]) * 100.0f / windowUs, 0.0f, 100.0f);
+            lastIdleUs[core] = idle;
+        }
+    }
+    
+    lastSampleMs = nowMs;
+    lastSampleUs = nowUs;
+}
+
+// ============================================================================
+// GETTERS
+// ============================================================================
+
+uint32_t ResourceMonitor::getFreeHeap() {
+    return freeHeap;
+}
+
+uint32_t ResourceMonitor::getMinFreeHeap() {
+    return minFreeHeap;
+}
+
+uint32_t ResourceMonitor::getLargestBlock() {
+    return largestBlock;
+}
+
+int ResourceMonitor::getFragmentation() {
+    if (freeHeap == 0) return 0;
+    return 100 - (int)((uint64_t)largestBlock * 100 / freeHeap);
+}
+
+int32_t ResourceMonitor::getHeapDriftPerHour() {
+    if (baselineMs == 0) return 0;
+    uint32_t elapsed = lastSampleMs - baselineMs;
+    if (elapsed < HEAP_DRIFT_MIN_MS) return 0;     // Too short to tell from noise
+    return (int32_t)(((int64_t)freeHeap - (int64_t)baselineHeap) * 3600000 / elapsed);
+}
+
+float ResourceMonitor::getIdlePercent(int core) {
+    if (core < 0 || core > 1) return 0;
+    return idlePercent[core];
+}
+
+uint32_t ResourceMonitor::getMinStackFree(const char** taskName) {
+    uint32_t lowest = UINT32_MAX;
+    for (int i = 0; i < taskCount; i++) {
+        if (tasks[i].stackFree < lowest) {
+            lowest = tasks[i].stackFree;
+            if (taskName) *taskName = tasks[i].name;
+        }
+    }
+    return taskCount > 0 ? lowest : 0;
+}
+
+uint32_t ResourceMonitor::getTxStalls() {
+    return serialTx.getStalls();
+}
+
+// ============================================================================
+// REPORTS
+// ============================================================================
+
+void ResourceMonitor::printReport() {
+    Serial.println("\n--- Resources ---");
+    Serial.printf("  Heap: %lu free, %lu lowest, %lu largest block (%d%% fragmented)\n",
+                  (unsigned long)freeHeap, (unsigned long)minFreeHeap,
+                  (unsigned long)largestBlock, getFragmentation());
+    if (baselineMs != 0 && lastSampleMs - baselineMs >= HEAP_DRIFT_MIN_MS) {
+        Serial.printf("  Heap drift: %+ld bytes/hour since %lus\n",
+                      (long)getHeapDriftPerHour(), (unsigned long)(baselineMs / 1000));
+    } else {
+        Serial.println("  Heap drift: (measuring)");
+    }
+    
+    if (loadSampling) {
+        Serial.printf("  CPU idle: core 0 %.1f%%, core 1 %.1f%%\n", idlePercent[0], idlePercent[1]);
+    } else {
+        Serial.println("  CPU idle: n/a (load sampling off while power saving)");
+    }
+    
+    Serial.println("  Stack high-water (bytes never used):");
+    for (int i = 0; i < taskCount; i++) {
+        Serial.printf("    %-10s %5lu%s\n", tasks[i].name, (unsigned long)tasks[i].stackFree,
+                      tasks[i].stackFree < 512 ? "  ⚠ LOW" : "");
+    }
+    
+    Serial.printf("  UART TX (background writers): %lu writes found the buffer too full, min %d bytes free\n",
+                  (unsigned long)serialTx.getStalls(), serialTx.getMinFree());
+}
@@ -0,0 +1,154 @@
+#include "sensor_task.h"
+#include "profiler.h"
+#include "deadline_monitor.h"
+#include "event_loop.h"
+
+SensorTask::SensorTask(HAL& halRef, UltrasonicSensor& sensRef, LDRSensor& ldrRef)
+    : hal(halRef), sensor(sensRef), ldrSensor(ldrRef) {
+}
+
+bool SensorTask::begin(int core, uint32_t period) {
+    if (handle) return true;
+    periodMs = period;
+    // A capture (one ping at most ~30 ms plus ADC reads) must fit in its period
+    deadlineId = deadlineMonitor.registerActivity("capture", period, period - 5);
+    
+    // Priority 2: above loop() (1) so a capture is never delayed by control work
+    BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "sensors", 4096, this, 2, &handle, core);
+    if (ok != pdPASS) {
+        handle = nullptr;
+        return false;
+    }
+    
+    sensor.attachFeed(this);
+    ldrSensor.attachFeed(this);
+    return true;
+}
+
+bool SensorTask::isRunning() {
+    return handle != nullptr;
+}
+
+void SensorTask::taskEntry(void* arg) {
+    static_cast<SensorTask*>(arg)->run();
+}
+
+// ============================================================================
+// PRODUCER (core 0)
+// ============================================================================
+
+void SensorTask::run() {
+    TickType_t lastWake = xTaskGetTickCount();
+    uint32_t seq = 0;
+    
+    for (;;) {
+        deadlineMonitor.start(deadlineId);
+        PROFILE_BEGIN(CAPTURE);
+        SensorSample sample;
+        sample.seq = seq++;
+        sample.captureUs = micros();
+        
+        // One ping per cycle; UltrasonicSensor's median filter on the control
+        // side replaces the 5-ping burst readUltrasonic() used to block on
+        eventLoop.pingBegin();
+        sample.distanceCm = hal.pingUltrasonic();
+        eventLoop.pingEnd();
+        sample.ldrLeft = hal.readLDR_Left();
+        sample.ldrRight = hal.readLDR_Right();
+        sample.batteryRaw = hal.readBatteryRaw();
+        
+        captureTimeUs = micros() - sample.captureUs;
+        PROFILE_END(CAPTURE);
+        deadlineMonitor.finish(deadlineId);
+        
+        if (queue.push(sample)) {
+            produced = produced + 1;
+            eventLoop.post(EventLoop::EVENT_SENSOR);
+        } else {
+            dropped = dropped + 1;
+        }
+        
+        // Fixed-rate schedule; also leaves the echo time to die down between pings
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(periodMs));
+    }
+}
+
+// ============================================================================
+// CONSUMER (core 1)
+// ============================================================================
+
+void SensorTask::drain() {
+    uint32_t depth = queue.depth();
+    if (depth > maxDepth) maxDepth = depth;
+    
+    SensorSample sample;
+    while (queue.pop(sample)) {
+        SampleTag tag;
+        tag.seq = sample.seq;
+        tag.captureUs = sample.captureUs;
+        tag.ingestUs = micros();
+        sensor.ingest(sample.distanceCm, tag);
+        ldrSensor.ingest(sample.ldrLeft, sample.ldrRight);
+        lastBatteryRaw = sample.batteryRaw;
+        consumed++;
+    }
+}
+
+void SensorTask::setPeriod(uint32_t period) {
+    periodMs = max(period, (uint32_t)30);   // Below the 30ms echo timeout pings overlap
+    deadlineMonitor.setPeriod(deadlineId, periodMs);
+}
+
+uint32_t SensorTask::getPeriod() {
+    return periodMs;
+}
+
+uint32_t SensorTask::getProduced() {
+    return produced;
+}
+
+uint32_t SensorTask::getConsumed() {
+    return consumed;
+}
+
+uint32_t SensorTask::getDropped() {
+    return dropped;
+}
+
+uint32_t SensorTask::getDepth() {
+    return queue.depth();
+}
+
+uint32_t SensorTask::getMaxDepth() {
+    return maxDepth;
+}
+
+uint32_t SensorTask::getLastCaptureTimeUs() {
+    return captureTimeUs;
+}
+
+TaskHandle_t SensorTask::getHandle() {
+    return handle;
+}
+
+int SensorTask::getBatteryRaw() {
+    return lastBatteryRaw;
+}
+
+float SensorTask::getBatteryVoltage() {
+    return HAL::batteryRawToVoltage(lastBatteryRaw);
+}
+
+void SensorTask::printStatus() {
+    if (!isRunning()) {
+        Serial.println("  Sensor Task: not running (sensing inline in loop)");
+        return;
+    }
+    Serial.printf("  Sensor Task: core 0, %lu ms period, capture %lu us\n",
+                  (unsigned long)periodMs, (unsigned long)captureTimeUs);
+    Serial.printf("    Samples: %lu produced, %lu consumed, %lu dropped\n",
+                  (unsigned long)produced, (unsigned long)consumed, (unsigned long)dropped);
+    Serial.printf("    Queue: depth %lu / %lu (max %lu)\n",
+                  (unsigned long)queue.depth(), (unsigned long)queue.capacity(),
+                  (unsigned long)maxDepth);
+}
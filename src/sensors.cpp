@@ -1,4 +1,5 @@
 #include "sensors.h"
+#include "sensor_task.h"
 #include <algorithm> // For std::sort
 
 // ============================================================================
@@ -13,12 +14,47 @@ UltrasonicSensor::UltrasonicSensor(HAL& halRef) : hal(halRef) {
 }
 
 void UltrasonicSensor::update() {
+    // With the sensor task running, pings happen on core 0; just pick up
+    // whatever it has captured since the last call
+    if (feed) {
+        feed->drain();
+        return;
+    }
+    
     // Get new reading from HAL
-    readings[readIndex] = hal.readUltrasonic();
+    uint32_t captureUs = micros();
+    int cm = hal.readUltrasonic();
+    SampleTag tag;
+    tag.seq = inlineSeq++;
+    tag.captureUs = captureUs;
+    tag.ingestUs = micros();
+    ingest(cm, tag);
+}
+
+void UltrasonicSensor::attachFeed(SensorTask* feedRef) {
+    feed = feedRef;
+}
+
+void UltrasonicSensor::ingest(int cm) {
+    SampleTag tag;
+    tag.seq = inlineSeq++;
+    tag.captureUs = micros();
+    tag.ingestUs = tag.captureUs;
+    ingest(cm, tag);
+}
+
+void UltrasonicSensor::ingest(int cm, const SampleTag& tag) {
+    pings++;
+    readings[readIndex] = cm;
     readIndex = (readIndex + 1) % FILTER_SIZE;
     
-    // Update the filtered distance value
+    // Update the filtered distance value; the sample that moves the median
+    // becomes the cause of anything decided on the new value
+    int previous = filteredDistance;
     filteredDistance = getMedianDistance();
+    if (filteredDistance != previous) {
+        filteredTag = tag;
+    }
     
     // Update stuck detection logic
     if (filteredDistance < STUCK_DISTANCE_THRESHOLD && abs(filteredDistance - lastDistance) < STUCK_STABILITY_THRESHOLD) {
@@ -38,12 +74,20 @@ int UltrasonicSensor::getDistance() {
     return filteredDistance;
 }
 
+int UltrasonicSensor::getRawDistance() {
+    return readings[(readIndex + FILTER_SIZE - 1) % FILTER_SIZE];
+}
+
+SampleTag UltrasonicSensor::getSampleTag() {
+    return filteredTag;
+}
+
 bool UltrasonicSensor::obstacleDetected() {
-    return filteredDistance < stopDistance;
+    return filteredDistance < thresholds.stopDistance;
 }
 
 bool UltrasonicSensor::obstacleFar() {
-    return filteredDistance < warnDistance;
+    return filteredDistance < thresholds.warnDistance;
 }
 
 bool UltrasonicSensor::isStuck() {
@@ -52,11 +96,27 @@ bool UltrasonicSensor::isStuck() {
 }
 
 void UltrasonicSensor::setStopDistance(int cm) {
-    stopDistance = cm;
+    thresholds.stopDistance = cm;
 }
 
 void UltrasonicSensor::setWarnDistance(int cm) {
-    warnDistance = cm;
+    thresholds.warnDistance = cm;
+}
+
+int UltrasonicSensor::getStopDistance() {
+    return thresholds.stopDistance;
+}
+
+int UltrasonicSensor::getWarnDistance() {
+    return thresholds.warnDistance;
+}
+
+RangeThresholds& UltrasonicSensor::getThresholds() {
+    return thresholds;
+}
+
+uint32_t UltrasonicSensor::getPingCount() {
+    return pings;
 }
 
 int UltrasonicSensor::getMedianDistance() {
@@ -86,17 +146,30 @@ LDRSensor::LDRSensor(HAL& halRef) : hal(halRef), readIndex(0), leftBrightness(0.
 }
 
 void LDRSensor::update() {
-    // Read raw ADC values and normalize to 0.0-1.0
-    float rawLeft = hal.readLDR_Left() / 4095.0f;
-    float rawRight = hal.readLDR_Right() / 4095.0f;
+    if (feed) {
+        feed->drain();
+        return;
+    }
+    ingest(hal.readLDR_Left(), hal.readLDR_Right());
+}
+
+void LDRSensor::attachFeed(SensorTask* feedRef) {
+    feed = feedRef;
+}
+
+void LDRSensor::ingest(int adcLeft, int adcRight) {
+    // Normalize raw ADC values to 0.0-1.0
+    float rawLeft = adcLeft / 4095.0f;
+    float rawRight = adcRight / 4095.0f;
     
     // Map to calibrated brightness (0.0 = dark, 1.0 = bright)
-    float mappedLeft = mapBrightness(rawLeft, ADC::DARK_READING_LEFT, ADC::LIGHT_READING_LEFT);
-    float mappedRight = mapBrightness(rawRight, ADC::DARK_READING_RIGHT, ADC::LIGHT_READING_RIGHT);
+    float mappedLeft = mapBrightness(rawLeft, adcCalibration.darkLeft, adcCalibration.lightLeft);
+    float mappedRight = mapBrightness(rawRight, adcCalibration.darkRight, adcCalibration.lightRight);
     
     // Store in filter array
     leftReadings[readIndex] = mappedLeft;
     rightReadings[readIndex] = mappedRight;
+    instantBrightness = (mappedLeft + mappedRight) / 2.0f;
     
     readIndex = (readIndex + 1) % FILTER_SIZE;
     
@@ -117,6 +190,10 @@ float LDRSensor::getBrightnessDifference() {
     return leftBrightness - rightBrightness;
 }
 
+float LDRSensor::getInstantBrightness() {
+    return instantBrightness;
+}
+
 float LDRSensor::mapBrightness(float rawReading, float darkValue, float lightValue) {
     // Map from calibrated dark/light range to 0.0-1.0
     float brightness = (rawReading - darkValue) / (lightValue - darkValue);
@@ -0,0 +1,35 @@
+#include "serial_tx.h"
+
+SerialTx serialTx;
+
+void SerialTx::begin() {
+    if (!mutex) mutex = xSemaphoreCreateMutexStatic(&mutexStorage);
+}
+
+// Called with the lock held
+bool SerialTx::room(size_t len) {
+    int avail = Serial.availableForWrite();
+    if (minFree < 0 || avail < minFree) minFree = avail;
+    if (avail >= (int)len) return true;
+    stalls.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool SerialTx::tryWrite(const uint8_t* data, size_t len) {
+    if (mutex && xSemaphoreTake(mutex, 0) != pdTRUE) {
+        stalls.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    bool fits = room(len);
+    if (fits) Serial.write(data, len);
+    if (mutex) xSemaphoreGive(mutex);
+    return fits;
+}
+
+size_t SerialTx::write(const uint8_t* data, size_t len) {
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+    room(len);
+    size_t n = Serial.write(data, len);
+    if (mutex) xSemaphoreGive(mutex);
+    return n;
+}
@@ -0,0 +1,170 @@
+#include "stuck_detector.h"
+
+StuckDetector::StuckDetector(HAL& halRef, Movement& movRef, Odometry& odoRef,
+                             UltrasonicSensor& sensRef, LDRSensor& ldrRef, SensorTask& taskRef)
+    : hal(halRef), movement(movRef), odometry(odoRef), sensor(sensRef), ldrSensor(ldrRef),
+      sensorTask(taskRef) {
+    for (int i = 0; i < LDR_WINDOW; i++) {
+        ldrWindow[i] = 0.0f;
+    }
+}
+
+void StuckDetector::reset() {
+    confidence = 0.0f;
+    rangeEvidence = -1.0f;
+    expectedTravel = 0.0f;
+    lastRange = sensor.getRawDistance();
+    ldrFilled = 0;
+}
+
+void StuckDetector::update() {
+    unsigned long now = millis();
+    if (lastUpdate == 0) {
+        lastUpdate = now;
+        lastRange = sensor.getRawDistance();
+        return;
+    }
+    float dt = (now - lastUpdate) / 1000.0f;
+    lastUpdate = now;
+    
+    int a = movement.getWheelSpeedA();
+    int b = movement.getWheelSpeedB();
+    float duty = (abs(a) + abs(b)) / 2.0f / 255.0f;
+    bool driving = duty > 0.2f;     // Below this the motors may not turn anyway
+    bool straight = driving && ((a > 0) == (b > 0)) && abs(a - b) < max(abs(a), abs(b)) / 3;
+    
+    // Odometry only knows what we commanded - exactly the "expected" side
+    if (straight) {
+        expectedTravel += odometry.getSpeed() * dt;
+    }
+    
+    rangeEvidence = evaluateRange(straight);
+    sagEvidence = evaluateSag(duty);
+    stasisEvidence = evaluateStasis(driving);
+    
+    float evidence = 0.0f;
+    if (driving) {
+        float sum = 0.0f;
+        float weight = 0.0f;
+        if (rangeEvidence >= 0.0f)  { sum += RANGE_WEIGHT * rangeEvidence;   weight += RANGE_WEIGHT; }
+        if (sagEvidence >= 0.0f)    { sum += SAG_WEIGHT * sagEvidence;       weight += SAG_WEIGHT; }
+        if (stasisEvidence >= 0.0f) { sum += STASIS_WEIGHT * stasisEvidence; weight += STASIS_WEIGHT; }
+        if (weight > 0.0f) evidence = sum / weight;
+    }
+    
+    // First-order filter: sustained evidence of 1.0 crosses a 0.7 threshold after
+    // ~1.2 time constants, so tau = latency / 1.2 meets the latency target.
+    float tau = latencyTarget / 1200.0f;
+    float alpha = min(dt / tau, 1.0f);
+    confidence += (evidence - confidence) * alpha;
+}
+
+float StuckDetector::evaluateRange(bool drivingStraight) {
+    int range = sensor.getRawDistance();
+    
+    if (!drivingStraight || range >= MAX_TRUSTED_RANGE || lastRange >= MAX_TRUSTED_RANGE) {
+        // Can't predict the echo while spinning or out of range - restart the window
+        lastRange = range;
+        expectedTravel = 0.0f;
+        return -1.0f;
+    }
+    
+    // Not enough commanded travel yet to tell motion from sensor noise
+    if (fabsf(expectedTravel) < MIN_EXPECTED_TRAVEL) {
+        return rangeEvidence;
+    }
+    
+    // Forward travel should close the range by the same amount
+    float observed = (float)(lastRange - range);
+    float ratio = observed / expectedTravel;
+    lastRange = range;
+    expectedTravel = 0.0f;
+    
+    // The range moved the wrong way: the echo is off something else (a new
+    // surface, a moving object), which says nothing about the wheels
+    if (ratio < 0.0f) return -1.0f;
+    return constrain(1.0f - ratio, 0.0f, 1.0f);
+}
+
+float StuckDetector::evaluateSag(float duty) {
+    // Core 0 samples the battery with the other ADC channels; only sensing
+    // inline does core 1 touch the ADC
+    float voltage = sensorTask.isRunning() ? sensorTask.getBatteryVoltage()
+                                           : hal.readBatteryVoltage();
+    if (voltage < 1.0f) return -1.0f;   // Battery sense not wired
+    
+    if (duty < 0.05f) {
+        // Motors idle: track the resting voltage
+        restVoltage = (restVoltage == 0.0f) ? voltage : restVoltage + (voltage - restVoltage) * 0.05f;
+        return -1.0f;
+    }
+    if (restVoltage == 0.0f) return -1.0f;
+    
+    float perDuty = (restVoltage - voltage) / duty;
+    if (sagPerDuty <= 0.01f) {
+        // Still learning what free-running sag looks like
+        if (perDuty > 0.0f) sagPerDuty = perDuty;
+        return -1.0f;
+    }
+    
+    float ratio = perDuty / sagPerDuty;
+    float evidence = constrain((ratio - 1.0f) / (STALL_SAG_RATIO - 1.0f), 0.0f, 1.0f);
+    
+    // Only learn from motion we believe is free
+    if (confidence < 0.3f && perDuty > 0.0f) {
+        sagPerDuty += (perDuty - sagPerDuty) * 0.02f;
+    }
+    return evidence;
+}
+
+float StuckDetector::evaluateStasis(bool driving) {
+    ldrWindow[ldrIndex] = ldrSensor.getInstantBrightness();
+    ldrIndex = (ldrIndex + 1) % LDR_WINDOW;
+    if (ldrFilled < LDR_WINDOW) ldrFilled++;
+    
+    if (!driving || ldrFilled < LDR_WINDOW) return -1.0f;
+    
+    float lo = ldrWindow[0];
+    float hi = ldrWindow[0];
+    for (int i = 1; i < LDR_WINDOW; i++) {
+        lo = min(lo, ldrWindow[i]);
+        hi = max(hi, ldrWindow[i]);
+    }
+    if (hi < 0.02f) return -1.0f;       // Pitch dark - no flicker to lose
+    
+    // Spread at STASIS_SPREAD = 1.0, at 3x STASIS_SPREAD = 0.0
+    float spread = hi - lo;
+    return constrain((3.0f * STASIS_SPREAD - spread) / (2.0f * STASIS_SPREAD), 0.0f, 1.0f);
+}
+
+bool StuckDetector::isStuck() {
+    return confidence >= threshold;
+}
+
+float StuckDetector::getConfidence() {
+    return confidence;
+}
+
+void StuckDetector::setLatencyTarget(unsigned long ms) {
+    latencyTarget = max(ms, 50UL);
+}
+
+void StuckDetector::setThreshold(float c) {
+    threshold = constrain(c, 0.1f, 1.0f);
+}
+
+unsigned long StuckDetector::getLatencyTarget() {
+    return latencyTarget;
+}
+
+void StuckDetector::printStatus() {
+    Serial.printf("  Stuck Confidence: %.2f (%s, target %lu ms)\n",
+                  confidence, isStuck() ? "STUCK" : "ok", latencyTarget);
+    Serial.printf("    Range rate: %s", rangeEvidence < 0 ? "-" : "");
+    if (rangeEvidence >= 0) Serial.printf("%.2f", rangeEvidence);
+    Serial.printf("  Battery sag: %s", sagEvidence < 0 ? "-" : "");
+    if (sagEvidence >= 0) Serial.printf("%.2f", sagEvidence);
+    Serial.printf("  LDR stasis: %s", stasisEvidence < 0 ? "-" : "");
+    if (stasisEvidence >= 0) Serial.printf("%.2f", stasisEvidence);
+    Serial.println();
+}
@@ -0,0 +1,216 @@
+#include "telemetry_stream.h"
+#include "resource_monitor.h"
+#include "postmortem.h"
+#include "serial_tx.h"
+#include <stdarg.h>
+#include <strings.h>
+
+const char* const TELEMETRY_FIELD_NAMES[TelemetryStream::FIELD_COUNT] = {
+    "light", "energy", "alive", "status", "dist", "motors", "batt", "power", "res", "resets"
+};
+
+// Writes needed without a drop before the rate steps back up
+static const uint16_t RECOVER_AFTER = 20;
+static const uint8_t MAX_DECIMATION = 16;
+
+TelemetryStream::TelemetryStream(LDRSensor& ldrRef, UltrasonicSensor& sonarRef, Movement& moveRef,
+                                 BatteryEstimator& batteryRef, PowerManager& powerRef,
+                                 EnergyModel& energyRef)
+    : ldr(ldrRef), sonar(sonarRef), movement(moveRef), battery(batteryRef), power(powerRef),
+      energy(energyRef) {
+}
+
+// ============================================================================
+// SCHEDULING
+// ============================================================================
+
+void TelemetryStream::update() {
+    if (!enabled) return;
+    unsigned long now = millis();
+    if ((long)(now - nextDueMs) < 0) return;
+
+    // Fixed cadence; after a long stall, restart from now rather than burst
+    uint32_t period = 1000 / rateHz;
+    nextDueMs += period;
+    if ((long)(now - nextDueMs) >= 0) nextDueMs = now + period;
+
+    if (skip > 0) {
+        skip--;
+        decimated++;
+        return;
+    }
+    skip = decimation - 1;
+
+    size_t len = format();
+    if (!serialTx.tryWrite((const uint8_t*)line, len)) {
+        dropped++;
+        cleanWrites = 0;
+        if (decimation < MAX_DECIMATION) decimation *= 2;
+        return;
+    }
+    emitted++;
+    if (decimation > 1 && ++cleanWrites >= RECOVER_AFTER) {
+        decimation /= 2;
+        cleanWrites = 0;
+    }
+}
+
+uint32_t TelemetryStream::msUntilDue() {
+    if (!enabled) return UINT32_MAX;
+    long left = (long)(nextDueMs - millis());
+    return left > 0 ? left : 0;
+}
+
+// ============================================================================
+// FORMATTING
+// ============================================================================
+// Integer formatting only: no float printf on the hot path.
+
+void TelemetryStream::append(const char* fmt, ...) {
+    if (length >= LINE_SIZE) return;
+    if (length > 0) {
+        length += snprintf(line + length, LINE_SIZE - length, " | ");
+        if (length >= LINE_SIZE) return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    length += vsnprintf(line + length, LINE_SIZE - length, fmt, args);
+    va_end(args);
+}
+
+size_t TelemetryStream::format() {
+    length = 0;
+
+    if (fields & FIELD_LIGHT) {
+        int light = (ldr.getLeftBrightness() + ldr.getRightBrightness()) * 500;
+        append("Light: %d.%03d", light / 1000, light % 1000);
+    }
+    if (fields & FIELD_ENERGY) {
+        int tenths = energy.getEnergyTenths();
+        append("Energy: %d.%d", tenths / 10, tenths % 10);
+    }
+    if (fields & FIELD_ALIVE) {
+        append("Alive: %lus", (unsigned long)energy.getAliveSeconds());
+    }
+    if (fields & FIELD_STATUS) {
+        append("Status: %s", energy.isAlive() ? "ALIVE" : "DEAD");
+    }
+    if (fields & FIELD_DISTANCE) {
+        append("Dist: %dcm", sonar.getDistance());
+    }
+    if (fields & FIELD_MOTORS) {
+        append("Motors: %d/%d", movement.getWheelSpeedA(), movement.getWheelSpeedB());
+    }
+    if (fields & FIELD_BATTERY) {
+        int mv = battery.getVoltage() * 1000;
+        append("Batt: %d.%02dV %d%%", mv / 1000, (mv % 1000) / 10, (int)battery.getSoc());
+    }
+    if (fields & FIELD_POWER) {
+        append("Power: %s", PowerManager::modeName(power.getMode()));
+    }
+    if (fields & FIELD_RESOURCES) {
+        const char* tightest = "?";
+        uint32_t stackMin = resourceMonitor.getMinStackFree(&tightest);
+        append("Heap: %luK/%luK min (frag %d%%) | Idle: %d/%d%% | Stack: %lu (%s) | TX stalls: %lu",
+               (unsigned long)(resourceMonitor.getFreeHeap() / 1024),
+               (unsigned long)(resourceMonitor.getMinFreeHeap() / 1024),
+               resourceMonitor.getFragmentation(),
+               (int)resourceMonitor.getIdlePercent(0), (int)resourceMonitor.getIdlePercent(1),
+               (unsigned long)stackMin, tightest, (unsigned long)resourceMonitor.getTxStalls());
+    }
+
+    if (fields & FIELD_RESETS) {
+        append("Reset: %s | Boot: %lu | Brownouts: %lu | Crashes: %lu",
+               Postmortem::reasonName(postmortem.getResetReason()),
+               (unsigned long)postmortem.getBootNumber(),
+               (unsigned long)postmortem.getResetCount(ESP_RST_BROWNOUT),
+               (unsigned long)postmortem.getCrashCount());
+    }
+
+    // Truncated lines still end in a newline
+    if (length > LINE_SIZE - 2) length = LINE_SIZE - 2;
+    line[length++] = '\n';
+    return length;
+}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+void TelemetryStream::setEnabled(bool on) {
+    if (on && !enabled) {
+        nextDueMs = millis();
+        decimation = 1;
+        skip = 0;
+    }
+    enabled = on;
+}
+
+bool TelemetryStream::isEnabled() {
+    return enabled;
+}
+
+bool TelemetryStream::setRate(int hz) {
+    if (hz < MIN_RATE_HZ || hz > MAX_RATE_HZ) return false;
+    rateHz = hz;
+    nextDueMs = millis();
+    return true;
+}
+
+int TelemetryStream::getRate() {
+    return rateHz;
+}
+
+void TelemetryStream::setFields(uint16_t mask) {
+    fields = mask & FIELDS_ALL;
+}
+
+uint16_t TelemetryStream::getFields() {
+    return fields;
+}
+
+void TelemetryStream::enableField(Field field, bool on) {
+    fields = on ? (fields | field) : (fields & ~field);
+}
+
+bool TelemetryStream::parseFields(const char* list, uint16_t& mask) {
+    if (strcasecmp(list, "all") == 0) {
+        mask = FIELDS_ALL;
+        return true;
+    }
+    if (strcasecmp(list, "logger") == 0) {
+        mask = FIELDS_LOGGER;
+        return true;
+    }
+    mask = 0;
+    const char* p = list;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t n = end ? (size_t)(end - p) : strlen(p);
+        bool found = false;
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            if (strlen(TELEMETRY_FIELD_NAMES[i]) == n && strncasecmp(p, TELEMETRY_FIELD_NAMES[i], n) == 0) {
+                mask |= 1 << i;
+                found = true;
+            }
+        }
+        if (!found) return false;
+        p += n;
+        if (*p == ',') p++;
+    }
+    return mask != 0;
+}
+
+void TelemetryStream::printStatus() {
+    Serial.println("\n--- Telemetry Stream ---");
+    Serial.printf("  %s at %d Hz", enabled ? "ON" : "OFF", rateHz);
+    if (decimation > 1) {
+        Serial.printf(" (backing off: every %u periods)", decimation);
+    }
+    Serial.print("\n  Fields:");
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        if (fields & (1 << i)) Serial.printf(" %s", TELEMETRY_FIELD_NAMES[i]);
+    }
+    Serial.printf("\n  Records: %lu sent, %lu dropped (TX full), %lu skipped while backing off\n",
+                  (unsigned long)emitted, (unsigned long)dropped, (unsigned long)decimated);
+}
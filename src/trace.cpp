@@ -0,0 +1,68 @@
+#include "trace.h"
+
+LatencyTracer latencyTracer;
+
+void LatencyTracer::arm(const SampleTag& cause) {
+    // A newer decision supersedes one that hasn't reached the motors yet
+    pending = cause;
+    armed = true;
+    lastCauseSeq = cause.seq;
+    
+    uint32_t now = micros();
+    queueLatency.record(cause.ingestUs - cause.captureUs);
+    decideLatency.record(now - cause.captureUs);
+}
+
+uint32_t LatencyTracer::onMotorCommand(int motor, int speed, bool forward) {
+    bool changed = (speed != lastSpeed[motor]) || (speed > 0 && forward != lastForward[motor]);
+    lastSpeed[motor] = speed;
+    lastForward[motor] = forward;
+    
+    if (armed && changed) {
+        lastReactUs = micros() - pending.captureUs;
+        reactLatency.record(lastReactUs);
+        traces++;
+        armed = false;
+        // B's half of the same command carries the cause too. Movement sets
+        // A then B, so only A opens a pair: were B to, the next A command -
+        // from a later, unrelated call - would inherit the cause
+        pairedMotor = motor == 0 ? 1 : -1;
+        return pending.seq;
+    }
+    if (motor == pairedMotor) {
+        pairedMotor = -1;
+        return pending.seq;
+    }
+    pairedMotor = -1;
+    
+    // Manual, link, wander and repeated commands: not caused by a traced sample
+    return NO_CAUSE;
+}
+
+void LatencyTracer::reset() {
+    armed = false;
+    pairedMotor = -1;
+    traces = 0;
+    queueLatency.reset();
+    decideLatency.reset();
+    reactLatency.reset();
+}
+
+void LatencyTracer::printReport() {
+    Serial.println("\n--- Reaction Latency (ms from capture) ---");
+    Serial.printf("  Traces: %lu, last sample seq %lu, last react %.1f ms\n",
+                  (unsigned long)traces,
+                  (unsigned long)(lastCauseSeq == NO_CAUSE ? 0 : lastCauseSeq),
+                  lastReactUs / 1000.0f);
+    Serial.println("  stage      count      min      p50      p99      max");
+    
+    const LogHistogram<2>* stages[] = { &queueLatency, &decideLatency, &reactLatency };
+    const char* const names[] = { "queue", "decide", "react" };
+    for (int i = 0; i < 3; i++) {
+        const LogHistogram<2>& h = *stages[i];
+        Serial.printf("  %-8s %7lu %8.1f %8.1f %8.1f %8.1f\n", names[i],
+                      (unsigned long)h.count(), h.min() / 1000.0f,
+                      h.percentile(500) / 1000.0f, h.percentile(990) / 1000.0f,
+                      h.max() / 1000.0f);
+    }
+}
@@ -0,0 +1,124 @@
+#include "transition_log.h"
+#include "postmortem.h"
+
+TransitionLog transitionLog;
+
+void TransitionLog::describe(uint8_t behavior, const char* name, const char* const* stateNames, int stateCount) {
+    if (behavior >= BehaviorId::COUNT) return;
+    behaviors[behavior].name = name;
+    behaviors[behavior].stateNames = stateNames;
+    behaviors[behavior].stateCount = min(stateCount, MAX_STATES);
+}
+
+void TransitionLog::record(uint8_t behavior, uint8_t from, uint8_t to, int16_t trigger) {
+    if (behavior >= BehaviorId::COUNT || from >= MAX_STATES || to >= MAX_STATES) return;
+    uint32_t now = millis();
+    
+    TransitionRecord& r = ring[total % CAPACITY];
+    r.timeMs = now;
+    r.behavior = behavior;
+    r.from = from;
+    r.to = to;
+    r.reserved = 0;
+    r.trigger = trigger;
+    total++;
+    postmortem.noteTransition(r);
+    
+    // Close the dwell in the state we're leaving (re-entering the same state
+    // still counts: the handlers use it to restart their timers)
+    BehaviorInfo& b = behaviors[behavior];
+    uint32_t dwell = now - b.enteredMs;
+    StateStats& leaving = b.states[b.current];
+    leaving.dwellMs += dwell;
+    leaving.dwell.record(dwell);
+    
+    b.states[to].entries++;
+    b.current = to;
+    b.enteredMs = now;
+}
+
+uint32_t TransitionLog::getTotal() {
+    return total;
+}
+
+bool TransitionLog::getRecord(uint32_t index, TransitionRecord& out) {
+    uint32_t held = min(total, (uint32_t)CAPACITY);
+    if (index >= held) return false;
+    out = ring[(total - held + index) % CAPACITY];
+    return true;
+}
+
+uint32_t TransitionLog::getDwellMs(uint8_t behavior, uint8_t state) {
+    if (behavior >= BehaviorId::COUNT || state >= MAX_STATES) return 0;
+    const BehaviorInfo& b = behaviors[behavior];
+    uint32_t dwell = b.states[state].dwellMs;
+    if (b.current == state) dwell += millis() - b.enteredMs;
+    return dwell;
+}
+
+uint32_t TransitionLog::getEntries(uint8_t behavior, uint8_t state) {
+    if (behavior >= BehaviorId::COUNT || state >= MAX_STATES) return 0;
+    return behaviors[behavior].states[state].entries;
+}
+
+const char* TransitionLog::behaviorName(uint8_t behavior) {
+    if (behavior >= BehaviorId::COUNT || !behaviors[behavior].name) return "?";
+    return behaviors[behavior].name;
+}
+
+const char* TransitionLog::stateName(uint8_t behavior, uint8_t state) {
+    if (behavior >= BehaviorId::COUNT) return "?";
+    const BehaviorInfo& b = behaviors[behavior];
+    if (b.stateNames && state < b.stateCount) return b.stateNames[state];
+    return "?";
+}
+
+void TransitionLog::printRecent(int count) {
+    uint32_t held = min(total, (uint32_t)CAPACITY);
+    uint32_t first = (held > (uint32_t)count) ? held - count : 0;
+    
+    Serial.printf("\n--- Last %lu of %lu transitions ---\n",
+                  (unsigned long)(held - first), (unsigned long)total);
+    TransitionRecord r;
+    for (uint32_t i = first; i < held; i++) {
+        getRecord(i, r);
+        const char* name = behaviors[r.behavior].name;
+        Serial.printf("  %8.3fs %-13s %s -> %s (trigger %d)\n",
+                      r.timeMs / 1000.0f, name ? name : "?",
+                      stateName(r.behavior, r.from), stateName(r.behavior, r.to), r.trigger);
+    }
+}
+
+void TransitionLog::printDwell() {
+    uint32_t elapsed = max(millis() - statsSinceMs, 1UL);
+    
+    Serial.printf("\n--- State dwell over %.0f s ---\n", elapsed / 1000.0f);
+    Serial.println("  behavior      state            entries   total s   s/hour    p50 ms    max ms");
+    for (int bi = 0; bi < BehaviorId::COUNT; bi++) {
+        BehaviorInfo& b = behaviors[bi];
+        for (int si = 0; si < b.stateCount; si++) {
+            uint32_t dwell = getDwellMs(bi, si);
+            if (dwell == 0 && b.states[si].entries == 0) continue;
+            const LogHistogram<0>& h = b.states[si].dwell;
+            Serial.printf("  %-13s %-16s %7lu %9.1f %8.0f %9lu %9lu\n",
+                          b.name ? b.name : "?", stateName(bi, si),
+                          (unsigned long)b.states[si].entries, dwell / 1000.0f,
+                          dwell * 3600.0f / elapsed,
+                          (unsigned long)h.percentile(500), (unsigned long)h.max());
+        }
+    }
+}
+
+void TransitionLog::reset() {
+    uint32_t now = millis();
+    total = 0;
+    statsSinceMs = now;
+    for (int bi = 0; bi < BehaviorId::COUNT; bi++) {
+        for (int si = 0; si < MAX_STATES; si++) {
+            behaviors[bi].states[si].entries = 0;
+            behaviors[bi].states[si].dwellMs = 0;
+            behaviors[bi].states[si].dwell.reset();
+        }
+        behaviors[bi].enteredMs = now;
+    }
+}
@@ -0,0 +1,163 @@
+#include "wander.h"
+
+// ============================================================================
+// WANDER
+// ============================================================================
+
+Wander::Wander(Movement& movRef, Odometry& odoRef)
+    : movement(movRef), odometry(odoRef) {
+    seed(params.seed);
+}
+
+void Wander::setParams(const WanderParams& p) {
+    params = p;
+    params.persistence = constrain(params.persistence, 0.0f, 1.0f);
+    params.levyMu = constrain(params.levyMu, 1.1f, 3.0f);
+    seed(params.seed);
+    interrupt();
+}
+
+WanderParams& Wander::getParams() {
+    return params;
+}
+
+void Wander::seed(uint32_t s) {
+    params.seed = s;
+    rngState = (s == 0) ? 1 : s;   // xorshift must never be zero
+    stepCount = 0;
+}
+
+void Wander::interrupt() {
+    phase = PLAN;
+}
+
+int Wander::getStepCount() {
+    return stepCount;
+}
+
+uint32_t Wander::nextRandom() {
+    // xorshift32 - tiny, fast and reproducible across boots
+    uint32_t x = rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rngState = x;
+    return x;
+}
+
+float Wander::uniform() {
+    return (nextRandom() >> 8) / 16777216.0f;
+}
+
+float Wander::gaussian() {
+    // Box-Muller
+    float u1 = max(uniform(), 1e-6f);
+    float u2 = uniform();
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * PI * u2);
+}
+
+void Wander::planStep() {
+    float turn;
+    if (params.strategy == WanderParams::LEVY_FLIGHT) {
+        // Inverse-CDF sample of a Pareto tail: L = Lmin * U^(-1/(mu-1))
+        float u = max(uniform(), 1e-6f);
+        stepLength = params.minStepCm * powf(u, -1.0f / (params.levyMu - 1.0f));
+        turn = (uniform() * 360.0f) - 180.0f;
+    } else {
+        stepLength = params.minStepCm;
+        turn = gaussian() * params.turnSigma;
+    }
+    stepLength = min(stepLength, params.maxStepCm);
+    turn *= (1.0f - params.persistence);
+    
+    targetHeading = Odometry::wrap360(odometry.getHeading() + turn);
+    stepStartDistance = odometry.getDistance();
+    phaseStartTime = millis();
+    phase = TURN;
+    stepCount++;
+}
+
+void Wander::update(int speedLimit) {
+    int speed = min(params.speed, speedLimit);
+    
+    if (phase == PLAN) {
+        planStep();
+    }
+    
+    float error = Odometry::wrap180(targetHeading - odometry.getHeading());
+    
+    if (phase == TURN) {
+        // Timeout guards against a turn that never converges (stalled wheel)
+        if (fabsf(error) < HEADING_TOLERANCE || millis() - phaseStartTime > 3000) {
+            phase = RUN;
+            stepStartDistance = odometry.getDistance();
+            phaseStartTime = millis();
+        } else {
+            if (error > 0) {
+                movement.spinCW(speed);
+            } else {
+                movement.spinCCW(speed);
+            }
+            return;
+        }
+    }
+    
+    // RUN: hold the heading until the step length is covered
+    if (odometry.getDistance() - stepStartDistance >= stepLength) {
+        planStep();
+        return;
+    }
+    int angular = constrain((int)(error * HOLD_GAIN), -speed / 2, speed / 2);
+    movement.setTwist(speed, angular);
+}
+
+// ============================================================================
+// COVERAGE MAP
+// ============================================================================
+
+CoverageMap::CoverageMap(Odometry& odoRef) : odometry(odoRef) {
+    start();
+}
+
+void CoverageMap::start() {
+    for (unsigned i = 0; i < sizeof(visited) / sizeof(visited[0]); i++) {
+        visited[i] = 0;
+    }
+    cellsVisited = 0;
+    originX = odometry.getX();
+    originY = odometry.getY();
+    startTime = millis();
+}
+
+void CoverageMap::update() {
+    int cx = (int)floorf((odometry.getX() - originX) / CELL_CM) + GRID / 2;
+    int cy = (int)floorf((odometry.getY() - originY) / CELL_CM) + GRID / 2;
+    if (cx < 0 || cx >= GRID || cy < 0 || cy >= GRID) return;   // Off the benchmark arena
+    
+    int cell = cy * GRID + cx;
+    uint32_t bit = 1UL << (cell % 32);
+    if (!(visited[cell / 32] & bit)) {
+        visited[cell / 32] |= bit;
+        cellsVisited++;
+    }
+}
+
+int CoverageMap::getCellsVisited() {
+    return cellsVisited;
+}
+
+float CoverageMap::getAreaM2() {
+    return cellsVisited * (CELL_CM * CELL_CM) / 10000.0f;
+}
+
+float CoverageMap::getAreaPerMinute() {
+    float minutes = (millis() - startTime) / 60000.0f;
+    return (minutes > 0.0f) ? getAreaM2() / minutes : 0.0f;
+}
+
+void CoverageMap::printReport() {
+    Serial.println("--- Coverage (odometry, 15cm cells) ---");
+    Serial.printf("  Cells: %d / %d\n", cellsVisited, GRID * GRID);
+    Serial.printf("  Area: %.2f m² in %.1f min\n", getAreaM2(), (millis() - startTime) / 60000.0f);
+    Serial.printf("  Rate: %.3f m²/min\n", getAreaPerMinute());
+}
@@ -0,0 +1,126 @@
+// ember_dump.cpp - print EMBER telemetry frames and console text from a port
+//
+//   ember_dump <port|file> [--baud N] [--stream PERIOD_MS] [--mask 0xNN]
+//              [--text "command"]
+//
+// A tty is switched to raw mode at --baud (default 115200). --stream asks the
+// robot for telemetry (CMD_TELEMETRY) and --text sends one console command
+// (CMD_TEXT). A plain file (a capture) is decoded and summarised.
+
+#include "ember_link.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+static speed_t toSpeed(long baud) {
+    switch (baud) {
+        case 9600:    return B9600;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        default:      return 0;
+    }
+}
+
+static bool configure(int fd, long baud) {
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0) return false;     // Not a tty: read as a capture
+    speed_t speed = toSpeed(baud);
+    if (speed == 0) {
+        std::fprintf(stderr, "Unsupported baud %ld\n", baud);
+        std::exit(2);
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &tio);
+    return true;
+}
+
+static void send(int fd, const std::vector<uint8_t>& frame) {
+    if (write(fd, frame.data(), frame.size()) != (ssize_t)frame.size()) {
+        std::perror("write");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr,
+                     "usage: %s <port|file> [--baud N] [--stream PERIOD_MS] [--mask 0xNN] "
+                     "[--text \"command\"]\n", argv[0]);
+        return 2;
+    }
+
+    long baud = 115200;
+    long period = -1;
+    unsigned mask = Protocol::REC_ALL;
+    std::string text;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--baud") baud = std::strtol(argv[i + 1], nullptr, 0);
+        else if (opt == "--stream") period = std::strtol(argv[i + 1], nullptr, 0);
+        else if (opt == "--mask") mask = std::strtoul(argv[i + 1], nullptr, 0);
+        else if (opt == "--text") text = argv[i + 1];
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", opt.c_str());
+            return 2;
+        }
+    }
+
+    int fd = open(argv[1], O_RDWR | O_NOCTTY);
+    if (fd < 0) fd = open(argv[1], O_RDONLY);
+    if (fd < 0) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], std::strerror(errno));
+        return 1;
+    }
+    bool live = configure(fd, baud);
+
+    ember::FrameDecoder decoder;
+    ember::LogDecoder logs;
+    decoder.onFrame = [&logs](const ember::Frame& f) {
+        std::string line;
+        if (f.type == Protocol::LOG_FORMAT || f.type == Protocol::LOG_RECORD) {
+            if (logs.feed(f, line)) std::printf("%s\n", line.c_str());
+            return;
+        }
+        std::printf("%s\n", ember::describe(f).c_str());
+        std::fflush(stdout);
+    };
+    decoder.onText = [](const std::string& line) {
+        std::printf("> %s\n", line.c_str());
+        std::fflush(stdout);
+    };
+
+    uint8_t seq = 0;
+    if (live && period >= 0) {
+        Protocol::TelemetryPayload t = { (uint16_t)period, (uint8_t)mask };
+        send(fd, ember::encode(Protocol::CMD_TELEMETRY, seq++, &t, sizeof(t)));
+    }
+    if (live && !text.empty()) {
+        size_t len = text.size() < Protocol::MAX_PAYLOAD ? text.size() : Protocol::MAX_PAYLOAD;
+        send(fd, ember::encode(Protocol::CMD_TEXT, seq++, text.data(), len));
+    }
+
+    uint8_t buf[256];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        decoder.push(buf, (size_t)n);
+    }
+
+    std::fprintf(stderr, "frames=%llu errors=%llu lost=%llu\n",
+                 (unsigned long long)decoder.frames(), (unsigned long long)decoder.errors(),
+                 (unsigned long long)decoder.lost());
+    close(fd);
+    return 0;
+}
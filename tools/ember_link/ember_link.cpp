@@ -0,0 +1,170 @@
+// ember_link.cpp - see ember_link.h
+
+#include "ember_link.h"
+#include "log_format.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace ember {
+
+void FrameDecoder::push(const uint8_t* data, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint8_t b = data[i];
+        if (b == 0) {
+            if (inFrame && !frameBuf.empty()) {
+                endFrame();
+            } else {
+                inFrame = true;     // Leading delimiter
+                frameBuf.clear();
+            }
+            continue;
+        }
+        if (inFrame) {
+            if (frameBuf.size() < Protocol::MAX_ENCODED) {
+                frameBuf.push_back(b);
+            } else {
+                // Too long for a frame: it was text after a lost delimiter
+                for (uint8_t c : frameBuf) text(c);
+                text(b);
+                frameBuf.clear();
+                inFrame = false;
+                errorCount++;
+            }
+        } else {
+            text(b);
+        }
+    }
+}
+
+void FrameDecoder::endFrame() {
+    Frame f;
+    if (Protocol::decodeFrame(frameBuf.data(), frameBuf.size(), f.type, f.seq, f.payload, f.len)) {
+        if (haveSeq) lostCount += (uint8_t)(f.seq - lastSeq - 1);
+        lastSeq = f.seq;
+        haveSeq = true;
+        frameCount++;
+        inFrame = false;
+        if (onFrame) onFrame(f);
+    } else {
+        // Out of step: what we took for a frame was text, and this
+        // delimiter opens the next frame
+        errorCount++;
+        for (uint8_t c : frameBuf) text(c);
+        inFrame = true;
+    }
+    frameBuf.clear();
+}
+
+void FrameDecoder::text(uint8_t b) {
+    if (b == '\n') {
+        if (!textBuf.empty() && textBuf.back() == '\r') textBuf.pop_back();
+        if (onText) onText(textBuf);
+        textBuf.clear();
+    } else {
+        textBuf.push_back((char)b);
+    }
+}
+
+std::vector<uint8_t> encode(uint8_t type, uint8_t seq, const void* payload, size_t len) {
+    std::vector<uint8_t> frame(Protocol::MAX_FRAME);
+    frame.resize(Protocol::encodeFrame(type, seq, payload, len, frame.data()));
+    return frame;
+}
+
+template <typename T>
+static bool as(const Frame& f, T& out) {
+    if (f.len != sizeof(T)) return false;
+    std::memcpy(&out, f.payload, sizeof(T));
+    return true;
+}
+
+std::string describe(const Frame& f) {
+    char line[256];
+    switch (f.type) {
+        case Protocol::ACK: {
+            Protocol::AckPayload a;
+            if (!as(f, a)) break;
+            static const char* status[] = { "OK", "UNKNOWN_TYPE", "BAD_LENGTH", "REJECTED", "DEAD" };
+            std::snprintf(line, sizeof(line), "ACK seq=%u type=0x%02X %s info=%u", a.seq, a.type,
+                          a.status < 5 ? status[a.status] : "?", a.info);
+            return line;
+        }
+        case Protocol::TLM_SENSORS: {
+            Protocol::SensorRecord r;
+            if (!as(f, r)) break;
+            std::snprintf(line, sizeof(line),
+                          "SENSORS t=%u sample=%u dist=%dcm raw=%dcm light=%.3f/%.3f",
+                          r.timeMs, r.sampleSeq, r.distanceCm, r.rawDistanceCm,
+                          r.lightLeft / 1000.0, r.lightRight / 1000.0);
+            return line;
+        }
+        case Protocol::TLM_MOTORS: {
+            Protocol::MotorRecord r;
+            if (!as(f, r)) break;
+            std::snprintf(line, sizeof(line),
+                          "MOTORS t=%u A=%d B=%d limit=%u%% heading=%.1f pos=(%.1f,%.1f)cm",
+                          r.timeMs, r.wheelA, r.wheelB, r.limitPercent, r.headingDeciDeg / 10.0,
+                          r.xMm / 10.0, r.yMm / 10.0);
+            return line;
+        }
+        case Protocol::TLM_BEHAVIOR: {
+            Protocol::BehaviorRecord r;
+            if (!as(f, r)) break;
+            std::snprintf(line, sizeof(line),
+                          "BEHAVIOR t=%u enabled=0x%02X avoid=%u photo=%u nav=%u power=%u clock=%u",
+                          r.timeMs, r.enabledMask, r.avoidanceState, r.phototropismState,
+                          r.navigatorState, r.powerMode, r.clockLevel);
+            return line;
+        }
+        case Protocol::TLM_BATTERY: {
+            Protocol::BatteryRecord r;
+            if (!as(f, r)) break;
+            std::snprintf(line, sizeof(line),
+                          "BATTERY t=%u %.3fV ocv=%.3fV soc=%.1f%% left=%dmin I=%umA R=%umOhm",
+                          r.timeMs, r.measuredMv / 1000.0, r.openCircuitMv / 1000.0,
+                          r.socPermille / 10.0, r.minutesLeft, r.currentMa, r.resistanceMilliOhm);
+            return line;
+        }
+        default:
+            break;
+    }
+    std::snprintf(line, sizeof(line), "FRAME type=0x%02X seq=%u len=%zu", f.type, f.seq, f.len);
+    return line;
+}
+
+static const char* resolveId(uint32_t value, void* ctx) {
+    const std::string* strings = static_cast<const std::string*>(ctx);
+    return value < 256 ? strings[value].c_str() : nullptr;
+}
+
+bool LogDecoder::feed(const Frame& f, std::string& line) {
+    if (f.type == Protocol::LOG_FORMAT && f.len > 2) {
+        uint8_t id = f.payload[0];
+        uint8_t offset = f.payload[1];
+        const char* text = reinterpret_cast<const char*>(f.payload + 2);
+        size_t n = f.len - 2;
+        std::string& s = strings[id];
+        if (offset == 0) s.clear();
+        if (s.size() != offset) return false;   // Lost a chunk: wait for the redefinition
+        s.append(text, strnlen(text, n));
+        return false;
+    }
+    Protocol::LogRecordPayload r;
+    if (f.type != Protocol::LOG_RECORD || !as(f, r)) return false;
+
+    static const char* const levels[] = { "", "E", "W", "I", "D" };
+    char out[512];
+    int n = std::snprintf(out, sizeof(out), "[%u.%03u] %s ", r.timeMs / 1000, r.timeMs % 1000,
+                          r.level < 5 ? levels[r.level] : "?");
+    uint8_t count = r.count < LogFormat::MAX_ARGS ? r.count : LogFormat::MAX_ARGS;
+    uint32_t args[LogFormat::MAX_ARGS];
+    std::memcpy(args, r.args, sizeof(args));
+    LogFormat::format(out + n, sizeof(out) - n, strings[r.formatId].c_str(), args, r.types,
+                      count, resolveId, strings);
+    line = out;
+    while (!line.empty() && line.back() == '\n') line.pop_back();
+    return true;
+}
+
+}  // namespace ember
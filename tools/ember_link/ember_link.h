@@ -0,0 +1,68 @@
+// ember_link.h - host-side decoder/encoder for the EMBER binary protocol
+//
+// Wire format and record layouts live in the firmware's include/protocol.h;
+// this library only adds byte-stream handling for the host: splitting the
+// serial stream into frames and console text, counting lost frames, and
+// pretty-printing records.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "protocol.h"
+
+namespace ember {
+
+struct Frame {
+    uint8_t type = 0;
+    uint8_t seq = 0;
+    uint8_t payload[Protocol::MAX_PAYLOAD];
+    size_t len = 0;
+};
+
+class FrameDecoder {
+public:
+    std::function<void(const Frame&)> onFrame;
+    std::function<void(const std::string&)> onText;     // One console line, no newline
+
+    void push(const uint8_t* data, size_t n);
+
+    uint64_t frames() const { return frameCount; }
+    uint64_t errors() const { return errorCount; }
+    uint64_t lost() const { return lostCount; }        // Gaps in the robot's seq
+
+private:
+    std::vector<uint8_t> frameBuf;
+    std::string textBuf;
+    bool inFrame = false;
+    bool haveSeq = false;
+    uint8_t lastSeq = 0;
+    uint64_t frameCount = 0;
+    uint64_t errorCount = 0;
+    uint64_t lostCount = 0;
+
+    void text(uint8_t b);
+    void endFrame();
+};
+
+// Complete frame (both delimiters) ready to write to the port
+std::vector<uint8_t> encode(uint8_t type, uint8_t seq, const void* payload = nullptr, size_t len = 0);
+
+// Human-readable one-line rendering of any frame
+std::string describe(const Frame& frame);
+
+// Rebuilds deferred log lines from LOG_FORMAT / LOG_RECORD frames. Returns
+// true and fills `line` for a complete record; format definitions are kept.
+class LogDecoder {
+public:
+    bool feed(const Frame& frame, std::string& line);
+
+private:
+    std::string strings[256];
+};
+
+}  // namespace ember
@@ -0,0 +1,70 @@
+"""
+Checks tools/flight_decode.py against the firmware's page encoder.
+
+Reads the output of flight_page_test (see flight_page_test.cpp) on stdin,
+decodes its recdump with flight_decode.py and compares every record with
+the EXPECT lines. Prints each mismatch and exits non-zero if there was one.
+
+  ./flight_page_test | python3 flight_decode_test.py
+"""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from flight_decode import collect_pages, decode_page  # noqa: E402
+
+
+def main():
+    lines = sys.stdin.read().splitlines()
+
+    expected = {}
+    encoder_failures = None
+    for line in lines:
+        parts = line.split()
+        if parts and parts[0] == 'EXPECT':
+            seq, t, *values = (int(p) for p in parts[1:])
+            expected.setdefault(seq, []).append((t, [0] + values))
+        elif parts and parts[0] == 'CHECKS':
+            encoder_failures = int(parts[2])
+
+    checks = 0
+    failures = 0
+    if encoder_failures is None:
+        print("FAIL: flight_page_test output incomplete (no CHECKS line)")
+        failures += 1
+    elif encoder_failures:
+        print(f"FAIL: {encoder_failures} encoder checks failed in flight_page_test")
+        failures += 1
+
+    pages = collect_pages(lines)
+    checks += 1
+    if sorted(pages) != sorted(expected):
+        print(f"FAIL: pages {sorted(pages)} in the dump, expected {sorted(expected)}")
+        failures += 1
+
+    for seq in sorted(expected):
+        want = expected[seq]
+        try:
+            got = list(decode_page(bytes(pages.get(seq, b''))))
+        except Exception as e:
+            print(f"FAIL page {seq}: {e}")
+            failures += 1
+            continue
+        checks += 1
+        if len(got) != len(want):
+            print(f"FAIL page {seq}: {len(got)} records decoded, expected {len(want)}")
+            failures += 1
+        for k, (g, w) in enumerate(zip(got, want)):
+            checks += 1
+            # Field 0 (time) travels as the timestamp, not a value
+            if g[0] != w[0] or g[1][1:] != w[1][1:]:
+                print(f"FAIL page {seq} record {k}: got {g[0]} {g[1][1:]}, expected {w[0]} {w[1][1:]}")
+                failures += 1
+
+    print(f"{checks} checks, {failures} failed")
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
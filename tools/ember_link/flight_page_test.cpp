@@ -0,0 +1,185 @@
+// flight_page_test.cpp - host check of the flight recorder page encoder in
+// include/flight_format.h against the decoder in tools/flight_decode.py
+//
+//   g++ -std=c++17 -O2 -I../../include flight_page_test.cpp -o flight_page_test
+//   ./flight_page_test | python3 flight_decode_test.py
+//
+// Builds pages the way FlightRecorder does and prints them as a "recdump"
+// ("FR <seq> <hex>" lines), preceded by one "EXPECT <seq> <time> <values>"
+// line per record. flight_decode_test.py decodes the dump with
+// flight_decode.py and compares. Encoder-side checks run here: each failure
+// goes to stderr and the closing "CHECKS <run> <failed>" line makes the
+// Python side fail too.
+
+#include "flight_format.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        checks++; \
+        if (!(cond)) { \
+            failures++; \
+            std::fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+// Same layout as FlightRecorder::Field
+static const int FIELD_COUNT = 10;
+typedef FlightFormat::PageEncoder<FIELD_COUNT> Encoder;
+
+// Dump: page bytes per line, as FlightRecorder::dump()
+static const size_t DUMP_CHUNK = 64;
+
+struct Page {
+    uint32_t seq;
+    std::vector<uint8_t> bytes;
+};
+
+static std::vector<Page> pages;
+static uint8_t buffer[FlightFormat::PAGE_SIZE];
+
+// Records one sample and prints what the decoder must give back for it
+static size_t add(Encoder& enc, uint32_t seq, uint32_t timeMs, const int32_t (&in)[FIELD_COUNT]) {
+    int32_t values[FIELD_COUNT];
+    std::memcpy(values, in, sizeof(values));
+    size_t n = enc.add(values, timeMs);
+
+    std::printf("EXPECT %u %u", seq, timeMs);
+    for (int i = 1; i < FIELD_COUNT; i++) std::printf(" %d", in[i]);
+    std::printf("\n");
+    return n;
+}
+
+static void seal(Encoder& enc, uint32_t seq) {
+    enc.seal(seq);
+    FlightFormat::PageHeader h;
+    std::memcpy(&h, buffer, sizeof(h));
+    CHECK(FlightFormat::headerValid(h));
+    CHECK(h.seq == seq);
+    CHECK(h.crc == Protocol::crc16(buffer + FlightFormat::HEADER_SIZE, h.used));
+    pages.push_back(Page{ seq, std::vector<uint8_t>(buffer, buffer + FlightFormat::HEADER_SIZE + h.used) });
+}
+
+// ============================================================================
+// PAGES
+// ============================================================================
+
+// Keyframe, steady records, irregular and zero gaps, negative, large and
+// wrapping deltas
+static void pageEdges() {
+    const uint32_t seq = 7;
+    Encoder enc;
+    enc.start(buffer, 5000, 100);
+    CHECK(enc.empty());
+
+    int32_t v[FIELD_COUNT] = { 0, 42, 512, 488, -180, 175, 1000, 0x1213, 740, 0 };
+
+    // Keyframe: every bit set, deltas from zero
+    size_t n = add(enc, seq, 5000, v);
+    CHECK(n > FIELD_COUNT);
+    CHECK(buffer[FlightFormat::HEADER_SIZE] == 0xFF && buffer[FlightFormat::HEADER_SIZE + 1] == 0x07);
+
+    // Nothing changed, on schedule: the one-byte empty mask
+    CHECK(add(enc, seq, 5100, v) == 1);
+
+    // Late by 150 ms: time bit 0 carries the 250 ms gap (2-byte varint)
+    CHECK(add(enc, seq, 5350, v) == 3);
+
+    // Same timestamp again: a zero gap still sets bit 0
+    v[1] = 41;
+    CHECK(add(enc, seq, 5350, v) == 3);
+
+    // Small negative and positive deltas: one zigzag byte each
+    v[4] = -181;
+    v[5] = 176;
+    CHECK(add(enc, seq, 5450, v) == 3);
+
+    // Multi-byte varints: +300 (2 bytes), -100000 (3 bytes)
+    v[2] += 300;
+    v[3] -= 100000;
+    CHECK(add(enc, seq, 5550, v) == 1 + 2 + 3);
+
+    // Extremes: a 5-byte varint, and a delta that wraps modulo 2^32
+    v[6] = INT32_MAX;
+    v[7] = INT32_MIN;
+    add(enc, seq, 5650, v);
+    v[6] = INT32_MIN;
+    v[7] = INT32_MAX;
+    add(enc, seq, 5750, v);
+
+    // Back to ordinary values after a minute's gap (3-byte varint)
+    v[6] = 990;
+    v[7] = 0;
+    v[9] = 2;
+    add(enc, seq, 65000, v);
+
+    CHECK(enc.getCount() == 9);
+    seal(enc, seq);
+    CHECK(enc.empty());
+}
+
+// Filled until the encoder calls it full, as FlightRecorder::record() does
+static void pageFull() {
+    const uint32_t seq = 8;
+    Encoder enc;
+    enc.start(buffer, 70000, 100);
+
+    int32_t v[FIELD_COUNT] = { 0, 120, 300, 310, 160, 160, 995, 0x1201, 752, 0 };
+    uint32_t rng = 12345;
+    uint32_t t = 70000;
+    while (!enc.full()) {
+        rng = rng * 1103515245 + 12345;
+        // A random walk in a few fields, the odd late sample
+        v[1] += (int32_t)((rng >> 16) % 7) - 3;
+        if (rng & 0x100) v[2] += (int32_t)((rng >> 20) % 41) - 20;
+        if (rng & 0x200) v[4] = -v[4];
+        if ((rng & 0x1F00) == 0) v[8]--;
+        t += (rng & 0x3000) == 0x3000 ? 137 : 100;
+        add(enc, seq, t, v);
+        CHECK(enc.getUsed() <= FlightFormat::PAGE_SIZE);
+    }
+    CHECK(enc.getUsed() + Encoder::MAX_RECORD > FlightFormat::PAGE_SIZE);
+    CHECK(enc.getCount() > 400);
+    seal(enc, seq);
+}
+
+// A new period on a new page (FlightRecorder seals when rec.rate_hz changes),
+// and a later boot whose millis() starts over
+static void pageRestart() {
+    const uint32_t seq = 9;
+    Encoder enc;
+    enc.start(buffer, 1200, 40);
+
+    int32_t v[FIELD_COUNT] = { 0, 9, 0, 0, 0, 0, 1000, 0, 810, 0 };
+    for (uint32_t k = 0; k < 20; k++) {
+        v[1] = 9 + (int32_t)(k % 3);
+        add(enc, seq, 1200 + k * 40, v);
+    }
+    seal(enc, seq);
+}
+
+int main() {
+    pageEdges();
+    pageFull();
+    pageRestart();
+
+    std::printf("FR-BEGIN %u\n", (unsigned)pages.size());
+    for (const Page& p : pages) {
+        for (size_t offset = 0; offset < p.bytes.size(); offset += DUMP_CHUNK) {
+            std::printf("FR %u ", p.seq);
+            for (size_t i = offset; i < p.bytes.size() && i < offset + DUMP_CHUNK; i++) {
+                std::printf("%02x", p.bytes[i]);
+            }
+            std::printf("\n");
+        }
+    }
+    std::printf("FR-END %u\n", (unsigned)pages.size());
+
+    std::printf("CHECKS %d %d\n", checks, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,243 @@
+// protocol_test.cpp - host checks for the codec in include/protocol.h and
+// the stream splitter in ember_link.cpp
+//
+//   g++ -std=c++17 -O2 -I../../include ember_link.cpp protocol_test.cpp -o protocol_test
+//   ./protocol_test
+//
+// Prints each failed check and exits non-zero if there was one.
+
+#include "ember_link.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        checks++; \
+        if (!(cond)) { \
+            failures++; \
+            std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+typedef std::vector<uint8_t> Bytes;
+
+static Bytes cobsEncode(const Bytes& in) {
+    Bytes out(in.size() + in.size() / 254 + 1);
+    out.resize(Protocol::cobsEncode(in.data(), in.size(), out.data()));
+    return out;
+}
+
+// Decoded bytes, or {0xEE} when cobsDecode() rejects the input
+static Bytes cobsDecode(const Bytes& in, size_t outSize = 1024) {
+    Bytes out(outSize);
+    size_t n = Protocol::cobsDecode(in.data(), in.size(), out.data(), out.size());
+    if (n == 0 && !(in.size() == 1 && in[0] == 1)) return Bytes{ 0xEE };
+    out.resize(n);
+    return out;
+}
+
+static bool hasZero(const Bytes& b) {
+    for (uint8_t c : b) {
+        if (c == 0) return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// CRC
+// ============================================================================
+
+static void testCrc() {
+    const char* check = "123456789";
+    CHECK(Protocol::crc16((const uint8_t*)check, 9) == 0x29B1);     // CCITT-FALSE check value
+    CHECK(Protocol::crc16(nullptr, 0) == 0xFFFF);
+
+    // Running CRC over two halves equals one pass over the whole
+    uint16_t half = Protocol::crc16((const uint8_t*)check, 4);
+    CHECK(Protocol::crc16((const uint8_t*)check + 4, 5, half) == 0x29B1);
+}
+
+// ============================================================================
+// COBS
+// ============================================================================
+
+static void testCobsVectors() {
+    CHECK(cobsEncode(Bytes{}) == (Bytes{ 0x01 }));
+    CHECK(cobsEncode(Bytes{ 0x00 }) == (Bytes{ 0x01, 0x01 }));
+    CHECK(cobsEncode(Bytes{ 0x00, 0x00 }) == (Bytes{ 0x01, 0x01, 0x01 }));
+    CHECK(cobsEncode(Bytes{ 0x11, 0x22, 0x00, 0x33 }) == (Bytes{ 0x03, 0x11, 0x22, 0x02, 0x33 }));
+    CHECK(cobsEncode(Bytes{ 0x11, 0x00 }) == (Bytes{ 0x02, 0x11, 0x01 }));
+
+    CHECK(cobsDecode(Bytes{ 0x03, 0x11, 0x22, 0x02, 0x33 }) == (Bytes{ 0x11, 0x22, 0x00, 0x33 }));
+    CHECK(cobsDecode(Bytes{ 0x01, 0x01 }) == (Bytes{ 0x00 }));
+}
+
+// Runs of non-zero bytes around the 254-byte block limit, with and without
+// zeros mixed in: every length must round-trip, stay zero-free and fit the
+// len + len / 254 + 1 bound the encoder promises
+static void testCobsBlockEdges() {
+    const size_t lengths[] = { 1, 253, 254, 255, 256, 507, 508, 509, 600 };
+    for (size_t len : lengths) {
+        for (int pattern = 0; pattern < 3; pattern++) {
+            Bytes in(len);
+            for (size_t i = 0; i < len; i++) {
+                switch (pattern) {
+                    case 0: in[i] = (uint8_t)(i % 255 + 1); break;         // No zeros
+                    case 1: in[i] = (i % 100 == 99) ? 0 : 0x5A; break;      // Sparse zeros
+                    case 2: in[i] = (i == len - 1) ? 0 : 0xA5; break;       // Trailing zero
+                }
+            }
+            Bytes enc = cobsEncode(in);
+            CHECK(!hasZero(enc));
+            CHECK(enc.size() <= len + len / 254 + 1);
+            CHECK(cobsDecode(enc) == in);
+        }
+    }
+
+    // A full 254-byte block is a single 0xFF code with no implied zero
+    Bytes run(254, 0x42);
+    Bytes enc = cobsEncode(run);
+    CHECK(enc.size() == 256);
+    CHECK(enc[0] == 0xFF && enc[255] == 0x01);
+
+    // 255 bytes: a full block, then a one-byte block
+    run.push_back(0x43);
+    enc = cobsEncode(run);
+    CHECK(enc.size() == 257);
+    CHECK(enc[0] == 0xFF && enc[255] == 0x02 && enc[256] == 0x43);
+}
+
+static void testCobsMalformed() {
+    CHECK(cobsDecode(Bytes{ 0x00 }) == Bytes{ 0xEE });                  // Zero code
+    CHECK(cobsDecode(Bytes{ 0x03, 0x11, 0x00, 0x22 }) == Bytes{ 0xEE }); // Zero inside the stream
+    CHECK(cobsDecode(Bytes{ 0x05, 0x11, 0x22 }) == Bytes{ 0xEE });       // Code runs past the end
+    CHECK(cobsDecode(Bytes{ 0xFF, 0x11 }) == Bytes{ 0xEE });
+    CHECK(cobsDecode(Bytes{}) == Bytes{ 0xEE });
+
+    // Output buffer too small, including for the implied zero
+    CHECK(cobsDecode(Bytes{ 0x03, 0x11, 0x22 }, 1) == Bytes{ 0xEE });
+    CHECK(cobsDecode(Bytes{ 0x02, 0x11, 0x02, 0x22 }, 1) == Bytes{ 0xEE });
+    CHECK(cobsDecode(Bytes{ 0x03, 0x11, 0x22 }, 2) == (Bytes{ 0x11, 0x22 }));
+}
+
+// ============================================================================
+// FRAMES
+// ============================================================================
+
+static void testFrameRoundTrip() {
+    uint8_t payload[Protocol::MAX_PAYLOAD];
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)(i * 37);     // Zeros included
+
+    for (size_t len = 0; len <= Protocol::MAX_PAYLOAD; len++) {
+        uint8_t frame[Protocol::MAX_FRAME];
+        size_t n = Protocol::encodeFrame(Protocol::TLM_SENSORS, (uint8_t)len, payload, len, frame);
+        CHECK(n >= 2 && n <= Protocol::MAX_FRAME);
+        CHECK(frame[0] == 0 && frame[n - 1] == 0);
+        CHECK(!hasZero(Bytes(frame + 1, frame + n - 1)));
+
+        uint8_t type = 0, seq = 0;
+        uint8_t out[Protocol::MAX_PAYLOAD];
+        size_t outLen = 0;
+        CHECK(Protocol::decodeFrame(frame + 1, n - 2, type, seq, out, outLen));
+        CHECK(type == Protocol::TLM_SENSORS && seq == (uint8_t)len && outLen == len);
+        CHECK(std::memcmp(out, payload, len) == 0);
+    }
+
+    uint8_t big[Protocol::MAX_PAYLOAD + 1] = {};
+    uint8_t frame[Protocol::MAX_FRAME + 8];
+    CHECK(Protocol::encodeFrame(Protocol::CMD_TEXT, 0, big, sizeof(big), frame) == 0);
+}
+
+static void testFrameMalformed() {
+    const uint8_t payload[] = { 1, 2, 3, 4 };
+    uint8_t frame[Protocol::MAX_FRAME];
+    size_t n = Protocol::encodeFrame(Protocol::CMD_DRIVE, 7, payload, sizeof(payload), frame);
+    const uint8_t* body = frame + 1;
+    size_t bodyLen = n - 2;
+
+    uint8_t type, seq, out[Protocol::MAX_PAYLOAD];
+    size_t outLen;
+
+    // Every single-bit flip is caught (by COBS or by the CRC)
+    int undetected = 0;
+    for (size_t i = 0; i < bodyLen; i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            Bytes bad(body, body + bodyLen);
+            bad[i] ^= (uint8_t)(1 << bit);
+            if (Protocol::decodeFrame(bad.data(), bad.size(), type, seq, out, outLen)) undetected++;
+        }
+    }
+    CHECK(undetected == 0);
+
+    // Truncated, empty and too-short bodies
+    CHECK(!Protocol::decodeFrame(body, bodyLen - 1, type, seq, out, outLen));
+    CHECK(!Protocol::decodeFrame(body, 0, type, seq, out, outLen));
+    Bytes shortBody = cobsEncode(Bytes{ 0x01, 0x02, 0x03 });
+    CHECK(!Protocol::decodeFrame(shortBody.data(), shortBody.size(), type, seq, out, outLen));
+
+    // A body longer than MAX_BODY is rejected, not copied past the buffer
+    Bytes longBody = cobsEncode(Bytes(Protocol::MAX_BODY + 1, 0x33));
+    CHECK(!Protocol::decodeFrame(longBody.data(), longBody.size(), type, seq, out, outLen));
+}
+
+// ============================================================================
+// STREAM SPLITTING (ember_link)
+// ============================================================================
+
+static void append(Bytes& stream, const Bytes& more) {
+    stream.insert(stream.end(), more.begin(), more.end());
+}
+
+static void append(Bytes& stream, const char* text) {
+    stream.insert(stream.end(), text, text + std::strlen(text));
+}
+
+static void testFrameDecoder() {
+    const uint8_t ping[] = { 0x00, 0x2A };
+    Bytes stream;
+    append(stream, "boot line\r\n");
+    append(stream, ember::encode(Protocol::ACK, 1, ping, sizeof(ping)));
+    append(stream, "> ");
+    append(stream, ember::encode(Protocol::ACK, 2, ping, sizeof(ping)));
+    append(stream, ember::encode(Protocol::ACK, 5, ping, sizeof(ping)));     // 3 and 4 lost
+    append(stream, "prompt\n");
+
+    // A corrupted frame: the error is counted and the stream resyncs
+    Bytes bad = ember::encode(Protocol::ACK, 6, ping, sizeof(ping));
+    bad[3] ^= 0x10;
+    append(stream, bad);
+    append(stream, ember::encode(Protocol::ACK, 7, ping, sizeof(ping)));
+
+    ember::FrameDecoder decoder;
+    std::vector<uint8_t> seqs;
+    std::vector<std::string> lines;
+    decoder.onFrame = [&](const ember::Frame& f) { seqs.push_back(f.seq); };
+    decoder.onText = [&](const std::string& line) { lines.push_back(line); };
+
+    // Byte at a time: frames split across reads are the normal case on a tty
+    for (uint8_t b : stream) decoder.push(&b, 1);
+
+    CHECK(seqs == (std::vector<uint8_t>{ 1, 2, 5, 7 }));
+    CHECK(decoder.frames() == 4);
+    CHECK(decoder.errors() >= 1);
+    CHECK(decoder.lost() == 3);      // 3, 4 and the corrupted 6
+    CHECK(lines.size() >= 2 && lines[0] == "boot line" && lines[1] == "> prompt");
+}
+
+int main() {
+    testCrc();
+    testCobsVectors();
+    testCobsBlockEdges();
+    testCobsMalformed();
+    testFrameRoundTrip();
+    testFrameMalformed();
+    testFrameDecoder();
+
+    std::printf("%d checks, %d failed\n", checks, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+import argparse
+import csv
+import os
+import struct
+import sys
+import time
+
+"""
+Decodes the EMBER flight recorder (include/flight_recorder.h) into CSV.
+
+The input is the output of the bot's 'recdump' command: either read live
+from a serial port (the script sends 'recdump' itself) or from a saved
+console capture. Pages that fail their CRC are reported and skipped.
+"""
+
+PAGE_MAGIC = 0x31464D45     # "EMF1"
+HEADER = struct.Struct('<IIIHHHH')
+
+FIELDS = ['time', 'dist_cm', 'light_l', 'light_r', 'wheel_a', 'wheel_b',
+          'energy', 'behavior', 'batt', 'power']
+
+AVOID_STATES = ['IDLE', 'EXPLORING', 'OBSTACLE_DETECTED', 'BACKING_UP', 'TURNING', 'STUCK_ESCAPE']
+PHOTO_STATES = ['IDLE', 'SCANNING', 'ALIGNING', 'SEEKING', 'APPROACHING']
+NAV_STATES = ['IDLE', 'ACQUIRING', 'SEARCHING', 'MOTION_TO_GOAL', 'BOUNDARY_TURN', 'BOUNDARY_ARC', 'ARRIVED']
+POWER_MODES = ['NORMAL', 'ECONOMY', 'LOW', 'CRITICAL', 'SHUTDOWN']
+
+CSV_HEADER = ['boot', 'page', 'time_ms', 'dist_cm', 'light_l', 'light_r', 'wheel_a', 'wheel_b',
+              'energy', 'modes', 'avoid_state', 'photo_state', 'nav_state', 'batt_v', 'power']
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, as Protocol::crc16()."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+        shift += 7
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def wrap32(v):
+    """The firmware's deltas wrap modulo 2^32: keep values in int32 range."""
+    return ((v + 2**31) % 2**32) - 2**31
+
+
+def name(names, index):
+    return names[index] if index < len(names) else str(index)
+
+
+def decode_page(page):
+    """Yields (time_ms, values) for every record in one page."""
+    magic, seq, start_ms, period_ms, count, used, crc = HEADER.unpack_from(page)
+    body = page[HEADER.size:HEADER.size + used]
+    if magic != PAGE_MAGIC or len(body) != used:
+        raise ValueError('bad header or truncated page')
+    if crc16(body) != crc:
+        raise ValueError('CRC mismatch')
+
+    values = [0] * len(FIELDS)
+    t = start_ms
+    pos = 0
+    for _ in range(count):
+        mask, pos = read_varint(body, pos)
+        gap = period_ms
+        if mask & 1:
+            gap, pos = read_varint(body, pos)
+        t += gap
+        for i in range(1, len(FIELDS)):
+            if mask & (1 << i):
+                delta, pos = read_varint(body, pos)
+                values[i] = wrap32(values[i] + unzigzag(delta))
+        yield t, list(values)
+
+
+def collect_pages(lines):
+    """Reassembles 'FR <seq> <hex>' lines into {seq: bytes}, in dump order."""
+    pages = {}
+    for line in lines:
+        line = line.strip()
+        if line.startswith('FR-END'):
+            break
+        parts = line.split()
+        if len(parts) != 3 or parts[0] != 'FR':
+            continue
+        try:
+            seq = int(parts[1])
+            chunk = bytes.fromhex(parts[2])
+        except ValueError:
+            continue
+        pages.setdefault(seq, bytearray()).extend(chunk)
+    return pages
+
+
+def serial_lines(port, baud, timeout):
+    import serial
+    ser = serial.Serial(port, baud, timeout=1)
+    # Opening the port resets most ESP32 boards; let it boot first
+    time.sleep(2)
+    ser.reset_input_buffer()
+    ser.write(b'recdump\n')
+    print(f"Dumping flight recorder from {port}...", file=sys.stderr)
+    last = time.time()
+    try:
+        while time.time() - last < timeout:
+            line = ser.readline().decode('utf-8', errors='ignore')
+            if not line:
+                continue
+            last = time.time()
+            yield line
+            if line.startswith('FR-END'):
+                return
+    finally:
+        ser.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode an EMBER flight recorder dump to CSV.",
+        formatter_class=argparse.RawTextHelpFormatter,
+        epilog="""
+Example usage:
+  - From the bot:      python flight_decode.py /dev/ttyUSB0
+  - From a capture:    python flight_decode.py console_capture.txt -o run.csv
+"""
+    )
+    parser.add_argument('source', help='Serial port to dump from, or a file holding a captured recdump.')
+    parser.add_argument('-o', '--output', help="CSV file (default: 'flight_YYYYMMDD_HHMMSS.csv').")
+    parser.add_argument('--baud', type=int, default=115200, help='Baud rate (default: 115200).')
+    parser.add_argument('--timeout', type=float, default=10, help='Seconds of silence that end a serial dump (default: 10).')
+    args = parser.parse_args()
+
+    if os.path.isfile(args.source):
+        with open(args.source, encoding='utf-8', errors='ignore') as f:
+            pages = collect_pages(f)
+    else:
+        pages = collect_pages(serial_lines(args.source, args.baud, args.timeout))
+
+    if not pages:
+        print("ERROR: no flight recorder pages found.", file=sys.stderr)
+        sys.exit(1)
+
+    filename = args.output or time.strftime("flight_%Y%m%d_%H%M%S.csv")
+    boot = 0
+    last_start = None
+    rows = 0
+    bad = 0
+    with open(filename, 'w', newline='') as csvfile:
+        writer = csv.writer(csvfile)
+        writer.writerow(CSV_HEADER)
+        for seq in sorted(pages):
+            page = bytes(pages[seq])
+            try:
+                records = list(decode_page(page))
+            except (ValueError, IndexError, struct.error) as e:
+                print(f"WARNING: page {seq} skipped: {e}", file=sys.stderr)
+                bad += 1
+                continue
+            # millis() restarts at every boot
+            start_ms = HEADER.unpack_from(page)[2]
+            if last_start is not None and start_ms < last_start:
+                boot += 1
+            last_start = start_ms
+
+            for t, v in records:
+                behavior = v[7]
+                writer.writerow([
+                    boot, seq, t, v[1], v[2] / 1000.0, v[3] / 1000.0, v[4], v[5], v[6] / 10.0,
+                    behavior & 0x7,
+                    name(AVOID_STATES, (behavior >> 4) & 0xF),
+                    name(PHOTO_STATES, (behavior >> 8) & 0xF),
+                    name(NAV_STATES, (behavior >> 12) & 0xF),
+                    v[8] / 100.0, name(POWER_MODES, v[9]),
+                ])
+                rows += 1
+
+    print(f"Decoded {rows} records from {len(pages) - bad} pages ({bad} skipped) into {filename}")
+
+
+if __name__ == "__main__":
+    main()
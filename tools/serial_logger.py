@@ -50,6 +50,7 @@ Press Ctrl+C to stop logging.
     )
     parser.add_argument('port', help='The serial port the EMBER bot is connected to (e.g., COM3 or /dev/ttyUSB0).')
     parser.add_argument('--baud', type=int, default=115200, help='Baud rate for the serial connection (default: 115200).')
+    parser.add_argument('--rate', type=int, default=1, help='Stats lines per second requested from the bot, 1-100 (default: 1).')
     
     args = parser.parse_args()
 
@@ -63,6 +64,11 @@ Press Ctrl+C to stop logging.
         print(f"Attempting to connect to {args.port} at {args.baud} baud...")
         ser = serial.Serial(args.port, args.baud, timeout=1)
         print(f"Successfully connected to {args.port}. Listening for data...")
+
+        # Opening the port resets most ESP32 boards; let it boot, then turn on
+        # the stats stream (off by default) with the fields this script parses
+        time.sleep(2)
+        ser.write(f"fields logger\nrate {args.rate}\nstream on\n".encode())
         print(f"Logging data to: {filename}")
         print("Press Ctrl+C to stop.")
         